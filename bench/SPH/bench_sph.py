@@ -0,0 +1,253 @@
+#!/usr/bin/env python
+"""
+  function: run the USER-SPH benchmarks, record timings as JSON,
+            and check the final thermo output against a reference
+  usage: bench_sph.py [options], see bench_sph.py -h
+"""
+
+from __future__ import print_function
+import sys
+import os
+import re
+import json
+import time
+import argparse
+import subprocess
+
+PROBLEMS = ["water_collapse","poiseuille","droplet_grid","bubble_growth"]
+
+# log file patterns
+
+loop_pattern = re.compile(r"^Loop time of (\S+) on (\d+) procs.* for (\d+) steps with (\d+) atoms")
+stage_pattern = re.compile(r"^\s*(\w+)\s+time \(%\) = (\S+) \((\S+)\)")
+section_pattern = re.compile(r"^\s*(\w+)\s*\|\s*(\S+)\s*\|\s*(\S+)\s*\|\s*(\S+)\s*\|\s*(\S+)\s*\|\s*(\S+)")
+
+#====================================================
+### timer names in the log file to stage names in the JSON file
+#====================================================
+def stage_name(name):
+  name = name.lower()
+  return {"outpt": "output", "neighbor": "neigh"}.get(name,name)
+
+#====================================================
+### split nprocs into per-dimension replication factors
+#====================================================
+def factors(nprocs,ndim):
+  f = [1,1,1]
+  n = nprocs
+  p = 2
+  i = 0
+  while n > 1:
+    while n % p == 0:
+      f[i % ndim] *= p
+      n //= p
+      i += 1
+    p += 1
+  return f
+
+#====================================================
+### parse a LAMMPS log file of one run
+#====================================================
+def parse_log(logfile):
+  result = {"stages": {}, "thermo": {}}
+  header = None
+  last = None
+  with open(logfile) as fp:
+    for line in fp:
+      words = line.split()
+      if words and words[0] == "Step":
+        header = words
+        continue
+      if header:
+        if len(words) == len(header):
+          try:
+            last = [float(w) for w in words]
+            continue
+          except ValueError:
+            pass
+        if last: result["thermo"] = dict(zip(header,last))
+        header = None
+      m = loop_pattern.match(line)
+      if m:
+        result["loop_time"] = float(m.group(1))
+        result["nprocs"] = int(m.group(2))
+        result["nsteps"] = int(m.group(3))
+        result["natoms"] = int(m.group(4))
+        continue
+
+      # old style "Pair  time (%) = ..." and table style "Pair | min | avg ..."
+
+      m = stage_pattern.match(line)
+      if m:
+        result["stages"][stage_name(m.group(1))] = float(m.group(2))
+        continue
+      m = section_pattern.match(line)
+      if m and m.group(1) != "Section":
+        try: result["stages"][stage_name(m.group(1))] = float(m.group(3))
+        except ValueError: pass
+  if "loop_time" not in result: return None
+  return result
+
+#====================================================
+### run one benchmark
+#====================================================
+def launch(args,problem,ndim,nprocs,f,tag,vars=""):
+  logfile = os.path.join(args.outdir,"log." + tag)
+  screen = os.path.join(args.outdir,"screen." + tag)
+  cmd = args.lmp.replace("{np}",str(nprocs))
+  cmd += " -in in.%s -log %s -var ndim %d -var x %d -var y %d -var z %d" % \
+      (problem,logfile,ndim,f[0],f[1],f[2])
+  if vars: cmd += " " + vars
+  if args.extra: cmd += " " + args.extra
+  start = time.time()
+  with open(screen,"w") as out:
+    status = subprocess.call(cmd,shell=True,stdout=out,stderr=subprocess.STDOUT)
+  wall = time.time() - start
+  result = None
+  if status == 0 and os.path.isfile(logfile): result = parse_log(logfile)
+  if result is None:
+    print("!!! %s FAILED, see %s" % (tag,screen))
+    return None
+  result["wall_time"] = wall
+  result["command"] = cmd
+  return result
+
+def run_one(args,problem,ndim,mode,nprocs):
+  f = [1,1,1]
+  if mode == "scaled": f = factors(nprocs,ndim)
+  tag = "%s.%dd.%s.%d" % (problem,ndim,mode,nprocs)
+  result = launch(args,problem,ndim,nprocs,f,tag)
+  if result is None: return None
+
+  # the phase change fix is timed under "other", so rerun
+  # without evaporation and charge the difference in loop time to it
+
+  if problem == "bubble_growth" and not args.nophase:
+    ref = launch(args,problem,ndim,nprocs,f,tag + ".nopc","-var pc 0")
+    if ref is None: return None
+    result["stages"]["phase_change"] = \
+        max(result["loop_time"]-ref["loop_time"],0.0)
+
+  result.update({"problem": problem, "dim": ndim, "mode": mode,
+                 "replicate": f[:ndim]})
+  result["atom_steps_per_s"] = \
+      result["natoms"]*result["nsteps"]/max(result["loop_time"],1.0e-30)
+  print("%-32s %8d atoms %10.4g s %12.4g atom-steps/s" %
+        (tag,result["natoms"],result["loop_time"],result["atom_steps_per_s"]))
+  return result
+
+#====================================================
+### parallel efficiency relative to smallest proc count
+###   fixed:  T(P0)*P0 / (T(P)*P)
+###   scaled: T(P0) / T(P), per-proc work is constant
+#====================================================
+def efficiency(runs):
+  base = {}
+  for r in runs:
+    key = (r["problem"],r["dim"],r["mode"])
+    if key not in base or r["nprocs"] < base[key]["nprocs"]: base[key] = r
+  for r in runs:
+    b = base[(r["problem"],r["dim"],r["mode"])]
+    if r["mode"] == "fixed":
+      r["efficiency"] = b["loop_time"]*b["nprocs"]/(r["loop_time"]*r["nprocs"])
+    else:
+      r["efficiency"] = b["loop_time"]/r["loop_time"]
+
+#====================================================
+### compare final thermo output of fixed-size runs to reference
+### a value passes if |value-ref| <= max(rtol*|ref|,atol)
+#====================================================
+def check(runs,ref):
+  nfail = 0
+  for r in runs:
+    if r["mode"] != "fixed": continue
+    key = "%s.%dd" % (r["problem"],r["dim"])
+    if key not in ref: continue
+    entry = ref[key]
+    rtol = entry.get("rtol",{})
+    atol = entry.get("atol",{})
+    r["check"] = "pass"
+    for name,value in entry["thermo"].items():
+      if name not in r["thermo"]:
+        print("!!! %s %d procs: no %s in thermo output" % (key,r["nprocs"],name))
+        r["check"] = "fail"
+        continue
+      tol = max(rtol.get(name,ref.get("rtol",1.0e-6))*abs(value),
+                atol.get(name,0.0))
+      diff = abs(r["thermo"][name]-value)
+      if diff > tol:
+        print("!!! %s %d procs: %s = %g, reference %g, tolerance %g" %
+              (key,r["nprocs"],name,r["thermo"][name],value,tol))
+        r["check"] = "fail"
+    if r["check"] == "fail": nfail += 1
+  return nfail
+
+#====================================================
+### main
+#====================================================
+def main():
+  parser = argparse.ArgumentParser(description="USER-SPH benchmarks")
+  parser.add_argument("-lmp",default="mpirun -np {np} ../../src/lmp_mpi",
+                      help="command to run LAMMPS, {np} is replaced by "
+                      "the # of procs")
+  parser.add_argument("-np",default="1",
+                      help="list of proc counts, e.g. \"1 2 4 8\"")
+  parser.add_argument("-mode",default="fixed",
+                      choices=["fixed","scaled","both"])
+  parser.add_argument("-dim",default="2",choices=["2","3","both"])
+  parser.add_argument("-problems",default=" ".join(PROBLEMS),
+                      help="list of problems to run")
+  parser.add_argument("-extra",default="",
+                      help="extra command-line switches for LAMMPS")
+  parser.add_argument("-nophase",action="store_true",
+                      help="skip the extra bubble_growth run without "
+                      "evaporation that times the phase change")
+  parser.add_argument("-outdir",default=".",help="directory for log files")
+  parser.add_argument("-json",default="bench_sph.json",
+                      help="file to write results to")
+  parser.add_argument("-ref",default=None,
+                      help="reference JSON file for the physics check")
+  parser.add_argument("-write-ref",dest="writeref",default=None,
+                      help="write final thermo output of fixed-size runs "
+                      "on the smallest proc count as a new reference file")
+  args = parser.parse_args()
+
+  nprocs = [int(n) for n in args.np.split()]
+  modes = ["fixed","scaled"] if args.mode == "both" else [args.mode]
+  dims = [2,3] if args.dim == "both" else [int(args.dim)]
+  if not os.path.isdir(args.outdir): os.makedirs(args.outdir)
+
+  runs = []
+  for problem in args.problems.split():
+    for ndim in dims:
+      for mode in modes:
+        for n in nprocs:
+          r = run_one(args,problem,ndim,mode,n)
+          if r: runs.append(r)
+  efficiency(runs)
+
+  nfail = 0
+  if args.ref:
+    with open(args.ref) as fp: ref = json.load(fp)
+    nfail = check(runs,ref)
+    print("physics check: %d runs failed" % nfail)
+
+  if args.writeref:
+    ref = {"rtol": 1.0e-6}
+    for r in runs:
+      if r["mode"] != "fixed" or r["nprocs"] != min(nprocs): continue
+      key = "%s.%dd" % (r["problem"],r["dim"])
+      ref[key] = {"thermo": r["thermo"], "rtol": {}, "atol": {}}
+    with open(args.writeref,"w") as fp:
+      json.dump(ref,fp,indent=2,sort_keys=True)
+
+  with open(args.json,"w") as fp:
+    json.dump({"date": time.asctime(), "runs": runs},fp,indent=2,
+              sort_keys=True)
+
+  nbad = len(nprocs)*len(modes)*len(dims)*len(args.problems.split()) - \
+      len(runs) + nfail
+  return 1 if nbad else 0
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -165,3 +165,102 @@ class lammps:
 
   def scatter_atoms(self,name,type,count,data):
     self.lib.lammps_scatter_atoms(self.lmp,name,type,count,data)
+
+  # return vector of atom properties gathered onto proc 0, ordered by atom ID
+  # returned vector is only filled in on proc 0
+
+  def gather_atoms_root(self,name,type,count):
+    natoms = self.lib.lammps_get_natoms(self.lmp)
+    if type == 0:
+      data = ((count*natoms)*c_int)()
+      self.lib.lammps_gather_atoms_root(self.lmp,name,type,count,data)
+    elif type == 1:
+      data = ((count*natoms)*c_double)()
+      self.lib.lammps_gather_atoms_root(self.lmp,name,type,count,data)
+    else: return None
+    return data
+
+  # return vector of atom properties for a list of atom IDs on all procs
+  # ordered by position of each atom ID in ids
+
+  def gather_atoms_subset(self,name,type,count,ids):
+    ndata = len(ids)
+    cids = (ndata*c_int)(*ids)
+    if type == 0:
+      data = ((count*ndata)*c_int)()
+      self.lib.lammps_gather_atoms_subset(self.lmp,name,type,count,
+                                          ndata,cids,data)
+    elif type == 1:
+      data = ((count*ndata)*c_double)()
+      self.lib.lammps_gather_atoms_subset(self.lmp,name,type,count,
+                                          ndata,cids,data)
+    else: return None
+    return data
+
+  # scatter vector of atom properties for a list of atom IDs
+  # assume vector is of correct type and length, as from gather_atoms_subset()
+
+  def scatter_atoms_subset(self,name,type,count,ids,data):
+    ndata = len(ids)
+    cids = (ndata*c_int)(*ids)
+    self.lib.lammps_scatter_atoms_subset(self.lmp,name,type,count,
+                                         ndata,cids,data)
+
+  # return (pointer,count,nlocal) for a per-atom property of owned atoms
+  # pointer addresses LAMMPS memory directly, no copy is made
+  # values of atom i are pointer[count*i] to pointer[count*i+count-1]
+  # pointer is None if name is not recognized
+
+  def extract_atom_owned(self,name):
+    type = c_int()
+    count = c_int()
+    ptr = c_void_p()
+    nlocal = self.lib.lammps_extract_atom_owned(self.lmp,name,byref(type),
+                                                byref(count),byref(ptr))
+    if not ptr.value: return None,count.value,nlocal
+    if type.value == 0: ctype = c_int
+    elif type.value == 1: ctype = c_double
+    else: ctype = c_longlong
+    return cast(ptr,POINTER(ctype)),count.value,nlocal
+
+  # return (nlocal,nmax) for this proc
+  # all per-atom arrays, and per-atom arrays of computes, are reallocated
+  #   only when nmax changes, so numpy views from extract_atom_numpy() and
+  #   extract_compute_numpy() remain valid as long as this tuple is unchanged
+
+  def atom_layout(self):
+    self.lib.lammps_extract_global.restype = POINTER(c_int)
+    nlocal = self.lib.lammps_extract_global(self.lmp,"nlocal")[0]
+    nmax = self.lib.lammps_extract_global(self.lmp,"nmax")[0]
+    return (nlocal,nmax)
+
+  # return numpy array that views a per-atom quantity of owned atoms
+  # shape is (nlocal,) for 1 value per atom, else (nlocal,count)
+  # no copy is made, changing the array changes the values inside LAMMPS
+
+  def extract_atom_numpy(self,name):
+    ptr,count,nlocal = self.extract_atom_owned(name)
+    if ptr is None: return None
+    return self.numpy_view(ptr,count,nlocal)
+
+  # return numpy array that views per-atom values of a compute for owned atoms
+  # shape is (nlocal,) for vector_atom, else (nlocal,ncols)
+  # compute is invoked if it is not current
+
+  def extract_compute_numpy(self,id):
+    count = c_int()
+    ptr = c_void_p()
+    nlocal = self.lib.lammps_extract_compute_owned(self.lmp,id,byref(count),
+                                                   byref(ptr))
+    if not ptr.value: return None
+    return self.numpy_view(cast(ptr,POINTER(c_double)),count.value,nlocal)
+
+  # numpy is only needed by the numpy methods, so import it here
+
+  def numpy_view(self,ptr,count,nlocal):
+    import numpy
+    if nlocal == 0:
+      if count == 1: return numpy.zeros(0,dtype=ptr._type_)
+      return numpy.zeros((0,count),dtype=ptr._type_)
+    if count == 1: return numpy.ctypeslib.as_array(ptr,shape=(nlocal,))
+    return numpy.ctypeslib.as_array(ptr,shape=(nlocal,count))
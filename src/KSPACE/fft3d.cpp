@@ -66,26 +66,53 @@
 
 void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
 {
-  int i,total,length,offset,num;
-  FFT_SCALAR norm, *out_ptr;
+  fft_3d_many(in,out,flag,plan,1);
+}
+
+/* ----------------------------------------------------------------------
+   Perform 3d FFT of several fields at once
+
+   same as fft_3d(), except
+   in,out       hold nfield fields one after the other, each the size of
+                  this proc's input or output section
+   nfield       # of fields, fft_3d_fields() must have been called
+                  for at least this many
+   each remap moves all fields in one exchange, so the # of messages
+     is that of a single FFT, while the 1d FFTs are done field by field
+------------------------------------------------------------------------- */
+
+void fft_3d_many(FFT_DATA *in, FFT_DATA *out, int flag,
+                 struct fft_plan_3d *plan, int nfield)
+{
+  int i,total,length,num;
+  FFT_SCALAR norm;
   FFT_DATA *data,*copy;
 
-  // system specific constants
+  // system specific constants and loop indices
 
-#if defined(FFT_SCSL)
+#if defined(FFT_SGI) || defined(FFT_INTEL)
+  int offset;
+#elif defined(FFT_SCSL)
+  int offset;
   int isys = 0;
   FFT_PREC scalef = 1.0;
 #elif defined(FFT_DEC)
+  int offset;
   char c = 'C';
   char f = 'F';
   char b = 'B';
   int one = 1;
 #elif defined(FFT_T3E)
+  int offset;
   int isys = 0;
   double scalef = 1.0;
 #elif defined(FFT_ACML)
   int info;
+#elif defined(FFT_MKL)
+  int ifield;
 #elif defined(FFT_FFTW3)
+  int ifield;
+  FFT_SCALAR *out_ptr;
   FFTW_API(plan) theplan;
 #else
   // nothing to do for other FFTs.
@@ -97,8 +124,8 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
   if (plan->pre_plan) {
     if (plan->pre_target == 0) copy = out;
     else copy = plan->copy;
-    remap_3d((FFT_SCALAR *) in, (FFT_SCALAR *) copy, (FFT_SCALAR *) plan->scratch,
-             plan->pre_plan);
+    remap_3d_many((FFT_SCALAR *) in, (FFT_SCALAR *) copy,
+                  (FFT_SCALAR *) plan->scratch,plan->pre_plan,nfield);
     data = copy;
   }
   else
@@ -106,7 +133,7 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
 
   // 1d FFTs along fast axis
 
-  total = plan->total1;
+  total = nfield*plan->total1;
   length = plan->length1;
 
 #if defined(FFT_SGI)
@@ -123,10 +150,12 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
   for (offset = 0; offset < total; offset += length)
     FFT_1D(&data[offset],&length,&flag,plan->coeff1);
 #elif defined(FFT_MKL)
-  if (flag == -1)
-    DftiComputeForward(plan->handle_fast,data);
-  else
-    DftiComputeBackward(plan->handle_fast,data);
+  for (ifield = 0; ifield < nfield; ifield++) {
+    if (flag == -1)
+      DftiComputeForward(plan->handle_fast,&data[ifield*plan->total1]);
+    else
+      DftiComputeBackward(plan->handle_fast,&data[ifield*plan->total1]);
+  }
 #elif defined(FFT_DEC)
   if (flag == -1)
     for (offset = 0; offset < total; offset += length)
@@ -148,14 +177,14 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
     theplan=plan->plan_fast_forward;
   else
     theplan=plan->plan_fast_backward;
-  FFTW_API(execute_dft)(theplan,data,data);
+  for (ifield = 0; ifield < nfield; ifield++)
+    FFTW_API(execute_dft)(theplan,&data[ifield*plan->total1],
+                          &data[ifield*plan->total1]);
 #else
   if (flag == -1)
-    for (offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_fast_forward,&data[offset],&data[offset]);
+    kiss_fft_many(plan->cfg_fast_forward,data,total/length);
   else
-    for (offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_fast_backward,&data[offset],&data[offset]);
+    kiss_fft_many(plan->cfg_fast_backward,data,total/length);
 #endif
 
   // 1st mid-remap to prepare for 2nd FFTs
@@ -163,13 +192,13 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
 
   if (plan->mid1_target == 0) copy = out;
   else copy = plan->copy;
-  remap_3d((FFT_SCALAR *) data, (FFT_SCALAR *) copy, (FFT_SCALAR *) plan->scratch,
-           plan->mid1_plan);
+  remap_3d_many((FFT_SCALAR *) data, (FFT_SCALAR *) copy,
+                (FFT_SCALAR *) plan->scratch,plan->mid1_plan,nfield);
   data = copy;
 
   // 1d FFTs along mid axis
 
-  total = plan->total2;
+  total = nfield*plan->total2;
   length = plan->length2;
 
 #if defined(FFT_SGI)
@@ -186,10 +215,12 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
   for (offset = 0; offset < total; offset += length)
     FFT_1D(&data[offset],&length,&flag,plan->coeff2);
 #elif defined(FFT_MKL)
-  if (flag == -1)
-    DftiComputeForward(plan->handle_mid,data);
-  else
-    DftiComputeBackward(plan->handle_mid,data);
+  for (ifield = 0; ifield < nfield; ifield++) {
+    if (flag == -1)
+      DftiComputeForward(plan->handle_mid,&data[ifield*plan->total2]);
+    else
+      DftiComputeBackward(plan->handle_mid,&data[ifield*plan->total2]);
+  }
 #elif defined(FFT_DEC)
   if (flag == -1)
     for (offset = 0; offset < total; offset += length)
@@ -211,14 +242,14 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
     theplan=plan->plan_mid_forward;
   else
     theplan=plan->plan_mid_backward;
-  FFTW_API(execute_dft)(theplan,data,data);
+  for (ifield = 0; ifield < nfield; ifield++)
+    FFTW_API(execute_dft)(theplan,&data[ifield*plan->total2],
+                          &data[ifield*plan->total2]);
 #else
   if (flag == -1)
-    for (offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_mid_forward,&data[offset],&data[offset]);
+    kiss_fft_many(plan->cfg_mid_forward,data,total/length);
   else
-    for (offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_mid_backward,&data[offset],&data[offset]);
+    kiss_fft_many(plan->cfg_mid_backward,data,total/length);
 #endif
 
   // 2nd mid-remap to prepare for 3rd FFTs
@@ -226,13 +257,13 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
 
   if (plan->mid2_target == 0) copy = out;
   else copy = plan->copy;
-  remap_3d((FFT_SCALAR *) data, (FFT_SCALAR *) copy, (FFT_SCALAR *) plan->scratch,
-           plan->mid2_plan);
+  remap_3d_many((FFT_SCALAR *) data, (FFT_SCALAR *) copy,
+                (FFT_SCALAR *) plan->scratch,plan->mid2_plan,nfield);
   data = copy;
 
   // 1d FFTs along slow axis
 
-  total = plan->total3;
+  total = nfield*plan->total3;
   length = plan->length3;
 
 #if defined(FFT_SGI)
@@ -249,10 +280,12 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
   for (offset = 0; offset < total; offset += length)
     FFT_1D(&data[offset],&length,&flag,plan->coeff3);
 #elif defined(FFT_MKL)
-  if (flag == -1)
-    DftiComputeForward(plan->handle_slow,data);
-  else
-    DftiComputeBackward(plan->handle_slow,data);
+  for (ifield = 0; ifield < nfield; ifield++) {
+    if (flag == -1)
+      DftiComputeForward(plan->handle_slow,&data[ifield*plan->total3]);
+    else
+      DftiComputeBackward(plan->handle_slow,&data[ifield*plan->total3]);
+  }
 #elif defined(FFT_DEC)
   if (flag == -1)
     for (offset = 0; offset < total; offset += length)
@@ -274,29 +307,31 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
     theplan=plan->plan_slow_forward;
   else
     theplan=plan->plan_slow_backward;
-  FFTW_API(execute_dft)(theplan,data,data);
+  for (ifield = 0; ifield < nfield; ifield++)
+    FFTW_API(execute_dft)(theplan,&data[ifield*plan->total3],
+                          &data[ifield*plan->total3]);
 #else
   if (flag == -1)
-    for (offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_slow_forward,&data[offset],&data[offset]);
+    kiss_fft_many(plan->cfg_slow_forward,data,total/length);
   else
-    for (offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_slow_backward,&data[offset],&data[offset]);
+    kiss_fft_many(plan->cfg_slow_backward,data,total/length);
 #endif
 
   // post-remap to put data in output format if needed
   // destination is always out
 
   if (plan->post_plan)
-    remap_3d((FFT_SCALAR *) data, (FFT_SCALAR *) out, (FFT_SCALAR *) plan->scratch,
-             plan->post_plan);
+    remap_3d_many((FFT_SCALAR *) data, (FFT_SCALAR *) out,
+                  (FFT_SCALAR *) plan->scratch,plan->post_plan,nfield);
 
   // scaling if required
 #if !defined(FFT_T3E) && !defined(FFT_ACML)
   if (flag == 1 && plan->scaled) {
     norm = plan->norm;
-    num = plan->normnum;
+    num = nfield*plan->normnum;
+#if defined(FFT_FFTW3)
     out_ptr = (FFT_SCALAR *)out;
+#endif
     for (i = 0; i < num; i++) {
 #if defined(FFT_FFTW3)
       *(out_ptr++) *= norm;
@@ -314,14 +349,14 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
 #ifdef FFT_T3E
   if (flag == 1 && plan->scaled) {
     norm = plan->norm;
-    num = plan->normnum;
+    num = nfield*plan->normnum;
     for (i = 0; i < num; i++) out[i] *= (norm,norm);
   }
 #endif
 
 #ifdef FFT_ACML
   norm = plan->norm;
-  num = plan->normnum;
+  num = nfield*plan->normnum;
   for (i = 0; i < num; i++) {
     out[i].re *= norm;
     out[i].im *= norm;
@@ -585,6 +620,9 @@ struct fft_plan_3d *fft_3d_create_plan(
     scratch_size = MAX(scratch_size,out_size);
 
   *nbuf = copy_size + scratch_size;
+  plan->copy_size = copy_size;
+  plan->scratch_size = scratch_size;
+  plan->nfield = 1;
 
   if (copy_size) {
     plan->copy = (FFT_DATA *) malloc(copy_size*sizeof(FFT_DATA));
@@ -927,6 +965,37 @@ struct fft_plan_3d *fft_3d_create_plan(
   return plan;
 }
 
+/* ----------------------------------------------------------------------
+   Size internal buffers of a plan for nfield fields at once
+   return 0 if successful, 1 if memory could not be allocated
+------------------------------------------------------------------------- */
+
+int fft_3d_fields(struct fft_plan_3d *plan, int nfield)
+{
+  if (nfield <= plan->nfield) return 0;
+
+  if (plan->copy) {
+    free(plan->copy);
+    plan->copy = (FFT_DATA *) malloc(nfield*plan->copy_size*sizeof(FFT_DATA));
+    if (plan->copy == NULL) return 1;
+  }
+
+  if (plan->scratch) {
+    free(plan->scratch);
+    plan->scratch =
+      (FFT_DATA *) malloc(nfield*plan->scratch_size*sizeof(FFT_DATA));
+    if (plan->scratch == NULL) return 1;
+  }
+
+  if (plan->pre_plan && remap_3d_fields(plan->pre_plan,nfield)) return 1;
+  if (plan->mid1_plan && remap_3d_fields(plan->mid1_plan,nfield)) return 1;
+  if (plan->mid2_plan && remap_3d_fields(plan->mid2_plan,nfield)) return 1;
+  if (plan->post_plan && remap_3d_fields(plan->post_plan,nfield)) return 1;
+
+  plan->nfield = nfield;
+  return 0;
+}
+
 /* ----------------------------------------------------------------------
    Destroy a 3d fft plan
 ------------------------------------------------------------------------- */
@@ -1086,11 +1155,15 @@ void bifactor(int n, int *factor1, int *factor2)
 
 void fft_1d_only(FFT_DATA *data, int nsize, int flag, struct fft_plan_3d *plan)
 {
-  int i,total,length,offset,num;
+  int i,total,length,num;
   FFT_SCALAR norm, *data_ptr;
 
-  // system specific constants
+  // system specific constants and loop index
 
+#if defined(FFT_SGI) || defined(FFT_SCSL) || defined(FFT_INTEL) || \
+  defined(FFT_DEC) || defined(FFT_T3E)
+  int offset;
+#endif
 #ifdef FFT_SCSL
   int isys = 0;
   FFT_PREC scalef = 1.0;
@@ -1228,19 +1301,13 @@ void fft_1d_only(FFT_DATA *data, int nsize, int flag, struct fft_plan_3d *plan)
   FFTW_API(execute_dft)(theplan,data,data);
 #else
   if (flag == -1) {
-    for (offset = 0; offset < total1; offset += length1)
-      kiss_fft(plan->cfg_fast_forward,&data[offset],&data[offset]);
-    for (offset = 0; offset < total2; offset += length2)
-      kiss_fft(plan->cfg_mid_forward,&data[offset],&data[offset]);
-    for (offset = 0; offset < total3; offset += length3)
-      kiss_fft(plan->cfg_slow_forward,&data[offset],&data[offset]);
+    kiss_fft_many(plan->cfg_fast_forward,data,total1/length1);
+    kiss_fft_many(plan->cfg_mid_forward,data,total2/length2);
+    kiss_fft_many(plan->cfg_slow_forward,data,total3/length3);
   } else {
-    for (offset = 0; offset < total1; offset += length1)
-      kiss_fft(plan->cfg_fast_backward,&data[offset],&data[offset]);
-    for (offset = 0; offset < total2; offset += length2)
-      kiss_fft(plan->cfg_mid_backward,&data[offset],&data[offset]);
-    for (offset = 0; offset < total3; offset += length3)
-      kiss_fft(plan->cfg_slow_backward,&data[offset],&data[offset]);
+    kiss_fft_many(plan->cfg_fast_backward,data,total1/length1);
+    kiss_fft_many(plan->cfg_mid_backward,data,total2/length2);
+    kiss_fft_many(plan->cfg_slow_backward,data,total3/length3);
   }
 #endif
 
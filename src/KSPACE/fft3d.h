@@ -256,6 +256,8 @@ struct fft_plan_3d {
   int scaled;                       // whether to scale FFT results
   int normnum;                      // # of values to rescale
   double norm;                      // normalization factor for rescaling
+  int copy_size,scratch_size;       // copy and scratch size per field
+  int nfield;                       // # of fields copy/scratch can hold
 
                                     // system specific 1d FFT info
 #if defined(FFT_SGI)
@@ -316,6 +318,8 @@ struct fft_plan_3d {
 
 extern "C" { 
   void fft_3d(FFT_DATA *, FFT_DATA *, int, struct fft_plan_3d *);
+  void fft_3d_many(FFT_DATA *, FFT_DATA *, int, struct fft_plan_3d *, int);
+  int fft_3d_fields(struct fft_plan_3d *, int);
   struct fft_plan_3d *fft_3d_create_plan(MPI_Comm, int, int, int,
                                          int, int, int, int, int, 
                                          int, int, int, int, int, int, int,
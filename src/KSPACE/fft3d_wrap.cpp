@@ -47,6 +47,18 @@ void FFT3d::compute(FFT_SCALAR *in, FFT_SCALAR *out, int flag)
   fft_3d((FFT_DATA *) in,(FFT_DATA *) out,flag,plan);
 }
 
+/* ----------------------------------------------------------------------
+   FFT nfield fields stored one after the other in in and out
+   remaps exchange all fields together, fewer and larger messages
+------------------------------------------------------------------------- */
+
+void FFT3d::compute_many(FFT_SCALAR *in, FFT_SCALAR *out, int flag, int nfield)
+{
+  if (fft_3d_fields(plan,nfield))
+    error->one(FLERR,"Could not allocate 3d FFT buffers");
+  fft_3d_many((FFT_DATA *) in,(FFT_DATA *) out,flag,plan,nfield);
+}
+
 /* ---------------------------------------------------------------------- */
 
 void FFT3d::timing1d(FFT_SCALAR *in, int nsize, int flag)
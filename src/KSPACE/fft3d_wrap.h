@@ -25,6 +25,7 @@ class FFT3d : protected Pointers {
         int,int,int,int,int,int,int,int,int *,int);
   ~FFT3d();
   void compute(FFT_SCALAR *, FFT_SCALAR *, int);
+  void compute_many(FFT_SCALAR *, FFT_SCALAR *, int, int);
   void timing1d(FFT_SCALAR *, int, int);
 
  private:
@@ -43,4 +44,10 @@ The FFT setup for the PPPM solver failed, typically due
 to lack of memory.  This is an unusual error.  Check the
 size of the FFT grid you are requesting.
 
+E: Could not allocate 3d FFT buffers
+
+The buffers needed to FFT several fields at once could not be
+allocated.  This is an unusual error.  Check the size of the FFT grid
+you are requesting.
+
 */
@@ -89,6 +89,7 @@ struct kiss_fft_state {
 
 static kiss_fft_cfg kiss_fft_alloc(int,int,void *,size_t *);
 static void kiss_fft(kiss_fft_cfg,const FFT_DATA *,FFT_DATA *);
+static void kiss_fft_many(kiss_fft_cfg,FFT_DATA *,int);
 
 /*
   Explanation of macros dealing with complex math:
@@ -465,4 +466,295 @@ static void kiss_fft(kiss_fft_cfg cfg, const FFT_DATA *fin, FFT_DATA *fout)
     kiss_fft_stride(cfg,fin,fout,1);
 }
 
+/*
+ * Batched transforms of KISS_FFT_BATCH lines at once.
+ * The lines of a batch are stored transposed with real and imaginary
+ * parts split, i.e. element k of line b is at re[k*B+b] and im[k*B+b],
+ * so every butterfly operation becomes a unit stride loop over the
+ * lines of the batch that the compiler can vectorize.
+ * Each line goes through the same arithmetic as in kf_work().
+ */
+#ifndef KISS_FFT_BATCH
+#define KISS_FFT_BATCH 8
+#endif
+
+static void kf_bfly2_batch(kiss_fft_scalar *re, kiss_fft_scalar *im,
+                           const size_t fstride, const kiss_fft_cfg st, int m)
+{
+    const int B = KISS_FFT_BATCH;
+    int u,b;
+    for (u=0; u<m; ++u) {
+        const FFT_DATA w = st->twiddles[u*fstride];
+        kiss_fft_scalar *r0 = re + u*B, *i0 = im + u*B;
+        kiss_fft_scalar *r1 = r0 + m*B, *i1 = i0 + m*B;
+        for (b=0; b<B; ++b) {
+            const kiss_fft_scalar tr = r1[b]*w.re - i1[b]*w.im;
+            const kiss_fft_scalar ti = r1[b]*w.im + i1[b]*w.re;
+            r1[b] = r0[b] - tr;
+            i1[b] = i0[b] - ti;
+            r0[b] += tr;
+            i0[b] += ti;
+        }
+    }
+}
+
+static void kf_bfly3_batch(kiss_fft_scalar *re, kiss_fft_scalar *im,
+                           const size_t fstride, const kiss_fft_cfg st, int m)
+{
+    const int B = KISS_FFT_BATCH;
+    int u,b;
+    const kiss_fft_scalar epi3 = st->twiddles[fstride*m].im;
+    for (u=0; u<m; ++u) {
+        const FFT_DATA w1 = st->twiddles[u*fstride];
+        const FFT_DATA w2 = st->twiddles[2*u*fstride];
+        kiss_fft_scalar *r0 = re + u*B, *i0 = im + u*B;
+        kiss_fft_scalar *r1 = r0 + m*B, *i1 = i0 + m*B;
+        kiss_fft_scalar *r2 = r1 + m*B, *i2 = i1 + m*B;
+        for (b=0; b<B; ++b) {
+            const kiss_fft_scalar s1r = r1[b]*w1.re - i1[b]*w1.im;
+            const kiss_fft_scalar s1i = r1[b]*w1.im + i1[b]*w1.re;
+            const kiss_fft_scalar s2r = r2[b]*w2.re - i2[b]*w2.im;
+            const kiss_fft_scalar s2i = r2[b]*w2.im + i2[b]*w2.re;
+            const kiss_fft_scalar s3r = s1r + s2r, s3i = s1i + s2i;
+            const kiss_fft_scalar s0r = (s1r - s2r)*epi3;
+            const kiss_fft_scalar s0i = (s1i - s2i)*epi3;
+            const kiss_fft_scalar f1r = r0[b] - HALF_OF(s3r);
+            const kiss_fft_scalar f1i = i0[b] - HALF_OF(s3i);
+            r0[b] += s3r;
+            i0[b] += s3i;
+            r2[b] = f1r + s0i;
+            i2[b] = f1i - s0r;
+            r1[b] = f1r - s0i;
+            i1[b] = f1i + s0r;
+        }
+    }
+}
+
+static void kf_bfly4_batch(kiss_fft_scalar *re, kiss_fft_scalar *im,
+                           const size_t fstride, const kiss_fft_cfg st, int m)
+{
+    const int B = KISS_FFT_BATCH;
+    int u,b;
+    const kiss_fft_scalar sign = st->inverse ? -1.0 : 1.0;
+    for (u=0; u<m; ++u) {
+        const FFT_DATA w1 = st->twiddles[u*fstride];
+        const FFT_DATA w2 = st->twiddles[2*u*fstride];
+        const FFT_DATA w3 = st->twiddles[3*u*fstride];
+        kiss_fft_scalar *r0 = re + u*B, *i0 = im + u*B;
+        kiss_fft_scalar *r1 = r0 + m*B, *i1 = i0 + m*B;
+        kiss_fft_scalar *r2 = r1 + m*B, *i2 = i1 + m*B;
+        kiss_fft_scalar *r3 = r2 + m*B, *i3 = i2 + m*B;
+        for (b=0; b<B; ++b) {
+            const kiss_fft_scalar s0r = r1[b]*w1.re - i1[b]*w1.im;
+            const kiss_fft_scalar s0i = r1[b]*w1.im + i1[b]*w1.re;
+            const kiss_fft_scalar s1r = r2[b]*w2.re - i2[b]*w2.im;
+            const kiss_fft_scalar s1i = r2[b]*w2.im + i2[b]*w2.re;
+            const kiss_fft_scalar s2r = r3[b]*w3.re - i3[b]*w3.im;
+            const kiss_fft_scalar s2i = r3[b]*w3.im + i3[b]*w3.re;
+            const kiss_fft_scalar s5r = r0[b] - s1r, s5i = i0[b] - s1i;
+            const kiss_fft_scalar f0r = r0[b] + s1r, f0i = i0[b] + s1i;
+            const kiss_fft_scalar s3r = s0r + s2r, s3i = s0i + s2i;
+            const kiss_fft_scalar s4r = s0r - s2r, s4i = s0i - s2i;
+            r2[b] = f0r - s3r;
+            i2[b] = f0i - s3i;
+            r0[b] = f0r + s3r;
+            i0[b] = f0i + s3i;
+            r1[b] = s5r + sign*s4i;
+            i1[b] = s5i - sign*s4r;
+            r3[b] = s5r - sign*s4i;
+            i3[b] = s5i + sign*s4r;
+        }
+    }
+}
+
+static void kf_bfly5_batch(kiss_fft_scalar *re, kiss_fft_scalar *im,
+                           const size_t fstride, const kiss_fft_cfg st, int m)
+{
+    const int B = KISS_FFT_BATCH;
+    int u,b;
+    const FFT_DATA ya = st->twiddles[fstride*m];
+    const FFT_DATA yb = st->twiddles[fstride*2*m];
+    for (u=0; u<m; ++u) {
+        const FFT_DATA w1 = st->twiddles[u*fstride];
+        const FFT_DATA w2 = st->twiddles[2*u*fstride];
+        const FFT_DATA w3 = st->twiddles[3*u*fstride];
+        const FFT_DATA w4 = st->twiddles[4*u*fstride];
+        kiss_fft_scalar *r0 = re + u*B, *i0 = im + u*B;
+        kiss_fft_scalar *r1 = r0 + m*B, *i1 = i0 + m*B;
+        kiss_fft_scalar *r2 = r1 + m*B, *i2 = i1 + m*B;
+        kiss_fft_scalar *r3 = r2 + m*B, *i3 = i2 + m*B;
+        kiss_fft_scalar *r4 = r3 + m*B, *i4 = i3 + m*B;
+        for (b=0; b<B; ++b) {
+            const kiss_fft_scalar s0r = r0[b], s0i = i0[b];
+            const kiss_fft_scalar s1r = r1[b]*w1.re - i1[b]*w1.im;
+            const kiss_fft_scalar s1i = r1[b]*w1.im + i1[b]*w1.re;
+            const kiss_fft_scalar s2r = r2[b]*w2.re - i2[b]*w2.im;
+            const kiss_fft_scalar s2i = r2[b]*w2.im + i2[b]*w2.re;
+            const kiss_fft_scalar s3r = r3[b]*w3.re - i3[b]*w3.im;
+            const kiss_fft_scalar s3i = r3[b]*w3.im + i3[b]*w3.re;
+            const kiss_fft_scalar s4r = r4[b]*w4.re - i4[b]*w4.im;
+            const kiss_fft_scalar s4i = r4[b]*w4.im + i4[b]*w4.re;
+
+            const kiss_fft_scalar s7r = s1r + s4r, s7i = s1i + s4i;
+            const kiss_fft_scalar s10r = s1r - s4r, s10i = s1i - s4i;
+            const kiss_fft_scalar s8r = s2r + s3r, s8i = s2i + s3i;
+            const kiss_fft_scalar s9r = s2r - s3r, s9i = s2i - s3i;
+
+            r0[b] += s7r + s8r;
+            i0[b] += s7i + s8i;
+
+            const kiss_fft_scalar s5r = s0r + s7r*ya.re + s8r*yb.re;
+            const kiss_fft_scalar s5i = s0i + s7i*ya.re + s8i*yb.re;
+            const kiss_fft_scalar s6r =  s10i*ya.im + s9i*yb.im;
+            const kiss_fft_scalar s6i = -s10r*ya.im - s9r*yb.im;
+
+            r1[b] = s5r - s6r;
+            i1[b] = s5i - s6i;
+            r4[b] = s5r + s6r;
+            i4[b] = s5i + s6i;
+
+            const kiss_fft_scalar s11r = s0r + s7r*yb.re + s8r*ya.re;
+            const kiss_fft_scalar s11i = s0i + s7i*yb.re + s8i*ya.re;
+            const kiss_fft_scalar s12r = -s10i*yb.im + s9i*ya.im;
+            const kiss_fft_scalar s12i =  s10r*yb.im - s9r*ya.im;
+
+            r2[b] = s11r + s12r;
+            i2[b] = s11i + s12i;
+            r3[b] = s11r - s12r;
+            i3[b] = s11i - s12i;
+        }
+    }
+}
+
+static void kf_bfly_generic_batch(kiss_fft_scalar *re, kiss_fft_scalar *im,
+                                  const size_t fstride, const kiss_fft_cfg st,
+                                  int m, int p)
+{
+    const int B = KISS_FFT_BATCH;
+    int u,k,q1,q,b;
+    const int Norig = st->nfft;
+    kiss_fft_scalar *sr = (kiss_fft_scalar*)
+        KISS_FFT_TMP_ALLOC(sizeof(kiss_fft_scalar)*2*p*B);
+    kiss_fft_scalar *si = sr + p*B;
+
+    for ( u=0; u<m; ++u ) {
+        for ( q1=0 ; q1<p ; ++q1 ) {
+            memcpy(sr+q1*B,re+(u+q1*m)*B,sizeof(kiss_fft_scalar)*B);
+            memcpy(si+q1*B,im+(u+q1*m)*B,sizeof(kiss_fft_scalar)*B);
+        }
+
+        k=u;
+        for ( q1=0 ; q1<p ; ++q1 ) {
+            int twidx=0;
+            kiss_fft_scalar *rk = re + k*B, *ik = im + k*B;
+            memcpy(rk,sr,sizeof(kiss_fft_scalar)*B);
+            memcpy(ik,si,sizeof(kiss_fft_scalar)*B);
+            for (q=1;q<p;++q ) {
+                twidx += fstride * k;
+                if (twidx>=Norig) twidx-=Norig;
+                const FFT_DATA w = st->twiddles[twidx];
+                const kiss_fft_scalar *rq = sr + q*B, *iq = si + q*B;
+                for (b=0; b<B; ++b) {
+                    rk[b] += rq[b]*w.re - iq[b]*w.im;
+                    ik[b] += rq[b]*w.im + iq[b]*w.re;
+                }
+            }
+            k += m;
+        }
+    }
+    KISS_FFT_TMP_FREE(sr);
+}
+
+static void kf_work_batch(kiss_fft_scalar *re, kiss_fft_scalar *im,
+                          const kiss_fft_scalar *fre,
+                          const kiss_fft_scalar *fim,
+                          const size_t fstride, int *factors,
+                          const kiss_fft_cfg st)
+{
+    const int B = KISS_FFT_BATCH;
+    const int p=*factors++; /* the radix  */
+    const int m=*factors++; /* stage's fft length/p */
+    int q;
+
+    if (m==1) {
+        for (q=0; q<p; ++q) {
+            memcpy(re+q*B,fre+q*fstride*B,sizeof(kiss_fft_scalar)*B);
+            memcpy(im+q*B,fim+q*fstride*B,sizeof(kiss_fft_scalar)*B);
+        }
+    } else {
+        for (q=0; q<p; ++q)
+            kf_work_batch(re+q*m*B,im+q*m*B,fre+q*fstride*B,fim+q*fstride*B,
+                          fstride*p,factors,st);
+    }
+
+    switch (p) {
+      case 2: kf_bfly2_batch(re,im,fstride,st,m); break;
+      case 3: kf_bfly3_batch(re,im,fstride,st,m); break;
+      case 4: kf_bfly4_batch(re,im,fstride,st,m); break;
+      case 5: kf_bfly5_batch(re,im,fstride,st,m); break;
+      default: kf_bfly_generic_batch(re,im,fstride,st,m,p); break;
+    }
+}
+
+/*
+ * In-place FFTs of nlines consecutive lines of length nfft each.
+ * Same result as calling kiss_fft() on each line.  Lines are done
+ * KISS_FFT_BATCH at a time, the last batch is padded with zeros, and
+ * with OpenMP the batches are split across threads unless the caller
+ * is already running threaded.
+ */
+static void kiss_fft_many(kiss_fft_cfg st, FFT_DATA *data, int nlines)
+{
+    const int B = KISS_FFT_BATCH;
+    const int nfft = st->nfft;
+    const int nbatch = (nlines + B - 1) / B;
+    if (nlines <= 0) return;
+
+    // a single line gains nothing from a zero padded batch
+
+    if (nlines == 1) {
+        kiss_fft(st,data,data);
+        return;
+    }
+
+    // do not spawn threads when called from a threaded region
+
+#if defined(_OPENMP)
+#pragma omp parallel if (nbatch > 1 && !omp_in_parallel())
+#endif
+    {
+        kiss_fft_scalar *buf = (kiss_fft_scalar*)
+            KISS_FFT_MALLOC(sizeof(kiss_fft_scalar)*4*nfft*B);
+        kiss_fft_scalar *inre = buf, *inim = buf + nfft*B;
+        kiss_fft_scalar *outre = inim + nfft*B, *outim = outre + nfft*B;
+        int ibatch,nb,b,k;
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+        for (ibatch = 0; ibatch < nbatch; ++ibatch) {
+            FFT_DATA *lines = data + (size_t) ibatch*B*nfft;
+            nb = nlines - ibatch*B;
+            if (nb > B) nb = B;
+
+            for (k=0; k<nfft; ++k) {
+                for (b=0; b<nb; ++b) {
+                    inre[k*B+b] = lines[b*nfft+k].re;
+                    inim[k*B+b] = lines[b*nfft+k].im;
+                }
+                for (; b<B; ++b) inre[k*B+b] = inim[k*B+b] = 0.0;
+            }
+
+            kf_work_batch(outre,outim,inre,inim,1,st->factors,st);
+
+            for (b=0; b<nb; ++b)
+                for (k=0; k<nfft; ++k) {
+                    lines[b*nfft+k].re = outre[k*B+b];
+                    lines[b*nfft+k].im = outim[k*B+b];
+                }
+        }
+        KISS_FFT_FREE(buf);
+    }
+}
+
 #endif
@@ -108,6 +108,8 @@ PPPM::PPPM(LAMMPS *lmp, int narg, char **arg) : KSpace(lmp, narg, arg)
 
   nmax = 0;
   part2grid = NULL;
+  nmax_rho1d = 0;
+  rho1d_atom = NULL;
 
   peratom_allocate_flag = 0;
   group_allocate_flag = 0;
@@ -746,9 +748,14 @@ void PPPM::allocate()
   memory->create(density_fft,nfft_both,"pppm:density_fft");
   memory->create(greensfn,nfft_both,"pppm:greensfn");
   memory->create(work1,2*nfft_both,"pppm:work1");
-  memory->create(work2,2*nfft_both,"pppm:work2");
   memory->create(vg,nfft_both,6,"pppm:vg");
 
+  // ik differentiation transforms 3 gradients at once, all held in work2
+
+  if (differentiation_flag == 1)
+    memory->create(work2,2*nfft_both,"pppm:work2");
+  else memory->create(work2,6*nfft_both,"pppm:work2");
+
   if (triclinic == 0) {
     memory->create1d_offset(fkx,nxlo_fft,nxhi_fft,"pppm:fkx");
     memory->create1d_offset(fky,nylo_fft,nyhi_fft,"pppm:fky");
@@ -874,6 +881,12 @@ void PPPM::deallocate()
   memory->destroy2d_offset(rho_coeff,(1-order_allocated)/2);
   memory->destroy2d_offset(drho_coeff,(1-order_allocated)/2);
 
+  // per-atom stencil weights depend on order, make_rho() reallocates them
+
+  memory->destroy(rho1d_atom);
+  rho1d_atom = NULL;
+  nmax_rho1d = 0;
+
   delete fft1;
   delete fft2;
   delete remap;
@@ -1916,23 +1929,33 @@ void PPPM::particle_map()
 
 void PPPM::make_rho()
 {
-  int l,m,n,nx,ny,nz,mx,my,mz;
+  int k,l,m,n,nx,ny,nz,mz;
   FFT_SCALAR dx,dy,dz,x0,y0,z0;
+  FFT_SCALAR *wx,*wy,*wz,*row;
 
   // clear 3d density array
 
   memset(&(density_brick[nzlo_out][nylo_out][nxlo_out]),0,
          ngrid*sizeof(FFT_SCALAR));
 
-  // loop over my charges, add their contribution to nearby grid points
-  // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
-  // (dx,dy,dz) = distance to "lower left" grid pt
-  // (mx,my,mz) = global coords of moving stencil pt
+  // stencil weights of each charge are kept for fieldforce() of this step
 
   double *q = atom->q;
   double **x = atom->x;
   int nlocal = atom->nlocal;
 
+  if (nlocal > nmax_rho1d) {
+    memory->destroy(rho1d_atom);
+    nmax_rho1d = atom->nmax;
+    memory->create(rho1d_atom,nmax_rho1d,3*order,"pppm:rho1d_atom");
+  }
+
+  // loop over my charges, add their contribution to nearby grid points
+  // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
+  // (dx,dy,dz) = distance to "lower left" grid pt
+  // (wx,wy,wz) = weights of stencil pts, indexed from nlower to nupper
+  // row = x-row of density brick the stencil pts are added to
+
   for (int i = 0; i < nlocal; i++) {
 
     nx = part2grid[i][0];
@@ -1944,17 +1967,24 @@ void PPPM::make_rho()
 
     compute_rho1d(dx,dy,dz);
 
+    wx = rho1d_atom[i] - nlower;
+    wy = wx + order;
+    wz = wy + order;
+    for (k = nlower; k <= nupper; k++) {
+      wx[k] = rho1d[0][k];
+      wy[k] = rho1d[1][k];
+      wz[k] = rho1d[2][k];
+    }
+
     z0 = delvolinv * q[i];
     for (n = nlower; n <= nupper; n++) {
       mz = n+nz;
-      y0 = z0*rho1d[2][n];
+      y0 = z0*wz[n];
       for (m = nlower; m <= nupper; m++) {
-        my = m+ny;
-        x0 = y0*rho1d[1][m];
-        for (l = nlower; l <= nupper; l++) {
-          mx = l+nx;
-          density_brick[mz][my][mx] += x0*rho1d[0][l];
-        }
+        row = &density_brick[mz][m+ny][nx];
+        x0 = y0*wy[m];
+        for (l = nlower; l <= nupper; l++)
+          row[l] += x0*wx[l];
       }
     }
   }
@@ -2055,69 +2085,54 @@ void PPPM::poisson_ik()
   }
 
   // compute gradients of V(r) in each of 3 dims by transformimg -ik*V(k)
+  // the 3 gradients are stored one after the other in work2
+  //   and transformed together, so each remap is a single exchange
   // FFT leaves data in 3d brick decomposition
   // copy it into inner portion of vdx,vdy,vdz arrays
 
-  // x direction gradient
-
-  n = 0;
-  for (k = nzlo_fft; k <= nzhi_fft; k++)
-    for (j = nylo_fft; j <= nyhi_fft; j++)
-      for (i = nxlo_fft; i <= nxhi_fft; i++) {
-        work2[n] = fkx[i]*work1[n+1];
-        work2[n+1] = -fkx[i]*work1[n];
-        n += 2;
-      }
-
-  fft2->compute(work2,work2,-1);
-
-  n = 0;
-  for (k = nzlo_in; k <= nzhi_in; k++)
-    for (j = nylo_in; j <= nyhi_in; j++)
-      for (i = nxlo_in; i <= nxhi_in; i++) {
-        vdx_brick[k][j][i] = work2[n];
-        n += 2;
-      }
-
-  // y direction gradient
+  FFT_SCALAR *workx = work2;
+  FFT_SCALAR *worky = &work2[2*nfft];
+  FFT_SCALAR *workz = &work2[4*nfft];
 
   n = 0;
   for (k = nzlo_fft; k <= nzhi_fft; k++)
     for (j = nylo_fft; j <= nyhi_fft; j++)
       for (i = nxlo_fft; i <= nxhi_fft; i++) {
-        work2[n] = fky[j]*work1[n+1];
-        work2[n+1] = -fky[j]*work1[n];
+        workx[n] = fkx[i]*work1[n+1];
+        workx[n+1] = -fkx[i]*work1[n];
+        worky[n] = fky[j]*work1[n+1];
+        worky[n+1] = -fky[j]*work1[n];
+        workz[n] = fkz[k]*work1[n+1];
+        workz[n+1] = -fkz[k]*work1[n];
         n += 2;
       }
 
-  fft2->compute(work2,work2,-1);
-
-  n = 0;
-  for (k = nzlo_in; k <= nzhi_in; k++)
-    for (j = nylo_in; j <= nyhi_in; j++)
-      for (i = nxlo_in; i <= nxhi_in; i++) {
-        vdy_brick[k][j][i] = work2[n];
-        n += 2;
-      }
+  fft2->compute_many(work2,work2,-1,3);
+  unpack_ik_gradients();
+}
 
-  // z direction gradient
+/* ----------------------------------------------------------------------
+   copy 3 gradients from work2, in brick decomposition after compute_many(),
+   into inner portion of vdx,vdy,vdz arrays
+------------------------------------------------------------------------- */
 
-  n = 0;
-  for (k = nzlo_fft; k <= nzhi_fft; k++)
-    for (j = nylo_fft; j <= nyhi_fft; j++)
-      for (i = nxlo_fft; i <= nxhi_fft; i++) {
-        work2[n] = fkz[k]*work1[n+1];
-        work2[n+1] = -fkz[k]*work1[n];
-        n += 2;
-      }
+void PPPM::unpack_ik_gradients()
+{
+  int i,j,k,n;
 
-  fft2->compute(work2,work2,-1);
+  int nbrick = (nxhi_in-nxlo_in+1) * (nyhi_in-nylo_in+1) *
+    (nzhi_in-nzlo_in+1);
+  FFT_SCALAR *workx = work2;
+  FFT_SCALAR *worky = &work2[2*nbrick];
+  FFT_SCALAR *workz = &work2[4*nbrick];
 
   n = 0;
   for (k = nzlo_in; k <= nzhi_in; k++)
     for (j = nylo_in; j <= nyhi_in; j++)
       for (i = nxlo_in; i <= nxhi_in; i++) {
-        vdz_brick[k][j][i] = work2[n];
+        vdx_brick[k][j][i] = workx[n];
+        vdy_brick[k][j][i] = worky[n];
+        vdz_brick[k][j][i] = workz[n];
         n += 2;
       }
 }
@@ -2128,68 +2143,28 @@ void PPPM::poisson_ik()
 
 void PPPM::poisson_ik_triclinic()
 {
-  int i,j,k,n;
+  int i,n;
 
   // compute gradients of V(r) in each of 3 dims by transformimg -ik*V(k)
-  // FFT leaves data in 3d brick decomposition
-  // copy it into inner portion of vdx,vdy,vdz arrays
-
-  // x direction gradient
-
-  n = 0;
-  for (i = 0; i < nfft; i++) {
-    work2[n] = fkx[i]*work1[n+1];
-    work2[n+1] = -fkx[i]*work1[n];
-    n += 2;
-  }
-
-  fft2->compute(work2,work2,-1);
-
-  n = 0;
-  for (k = nzlo_in; k <= nzhi_in; k++)
-    for (j = nylo_in; j <= nyhi_in; j++)
-      for (i = nxlo_in; i <= nxhi_in; i++) {
-        vdx_brick[k][j][i] = work2[n];
-        n += 2;
-      }
-
-  // y direction gradient
-
-  n = 0;
-  for (i = 0; i < nfft; i++) {
-    work2[n] = fky[i]*work1[n+1];
-    work2[n+1] = -fky[i]*work1[n];
-    n += 2;
-  }
-
-  fft2->compute(work2,work2,-1);
-
-  n = 0;
-  for (k = nzlo_in; k <= nzhi_in; k++)
-    for (j = nylo_in; j <= nyhi_in; j++)
-      for (i = nxlo_in; i <= nxhi_in; i++) {
-        vdy_brick[k][j][i] = work2[n];
-        n += 2;
-      }
+  // the 3 gradients are transformed together as in poisson_ik()
 
-  // z direction gradient
+  FFT_SCALAR *workx = work2;
+  FFT_SCALAR *worky = &work2[2*nfft];
+  FFT_SCALAR *workz = &work2[4*nfft];
 
   n = 0;
   for (i = 0; i < nfft; i++) {
-    work2[n] = fkz[i]*work1[n+1];
-    work2[n+1] = -fkz[i]*work1[n];
+    workx[n] = fkx[i]*work1[n+1];
+    workx[n+1] = -fkx[i]*work1[n];
+    worky[n] = fky[i]*work1[n+1];
+    worky[n+1] = -fky[i]*work1[n];
+    workz[n] = fkz[i]*work1[n+1];
+    workz[n+1] = -fkz[i]*work1[n];
     n += 2;
   }
 
-  fft2->compute(work2,work2,-1);
-
-  n = 0;
-  for (k = nzlo_in; k <= nzhi_in; k++)
-    for (j = nylo_in; j <= nyhi_in; j++)
-      for (i = nxlo_in; i <= nxhi_in; i++) {
-        vdz_brick[k][j][i] = work2[n];
-        n += 2;
-      }
+  fft2->compute_many(work2,work2,-1,3);
+  unpack_ik_gradients();
 }
 
 /* ----------------------------------------------------------------------
@@ -2418,18 +2393,18 @@ void PPPM::fieldforce()
 
 void PPPM::fieldforce_ik()
 {
-  int i,l,m,n,nx,ny,nz,mx,my,mz;
-  FFT_SCALAR dx,dy,dz,x0,y0,z0;
+  int i,l,m,n,nx,ny,nz,mz,my;
+  FFT_SCALAR x0,y0,z0;
   FFT_SCALAR ekx,eky,ekz;
+  const FFT_SCALAR *wx,*wy,*wz,*rowx,*rowy,*rowz;
 
   // loop over my charges, interpolate electric field from nearby grid points
   // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
-  // (dx,dy,dz) = distance to "lower left" grid pt
-  // (mx,my,mz) = global coords of moving stencil pt
+  // (wx,wy,wz) = stencil weights stored by make_rho() in this step
+  // rowx,rowy,rowz = x-rows of the 3 field bricks in the stencil
   // ek = 3 components of E-field on particle
 
   double *q = atom->q;
-  double **x = atom->x;
   double **f = atom->f;
 
   int nlocal = atom->nlocal;
@@ -2438,25 +2413,25 @@ void PPPM::fieldforce_ik()
     nx = part2grid[i][0];
     ny = part2grid[i][1];
     nz = part2grid[i][2];
-    dx = nx+shiftone - (x[i][0]-boxlo[0])*delxinv;
-    dy = ny+shiftone - (x[i][1]-boxlo[1])*delyinv;
-    dz = nz+shiftone - (x[i][2]-boxlo[2])*delzinv;
-
-    compute_rho1d(dx,dy,dz);
+    wx = rho1d_atom[i] - nlower;
+    wy = wx + order;
+    wz = wy + order;
 
     ekx = eky = ekz = ZEROF;
     for (n = nlower; n <= nupper; n++) {
       mz = n+nz;
-      z0 = rho1d[2][n];
+      z0 = wz[n];
       for (m = nlower; m <= nupper; m++) {
         my = m+ny;
-        y0 = z0*rho1d[1][m];
+        y0 = z0*wy[m];
+        rowx = &vdx_brick[mz][my][nx];
+        rowy = &vdy_brick[mz][my][nx];
+        rowz = &vdz_brick[mz][my][nx];
         for (l = nlower; l <= nupper; l++) {
-          mx = l+nx;
-          x0 = y0*rho1d[0][l];
-          ekx -= x0*vdx_brick[mz][my][mx];
-          eky -= x0*vdy_brick[mz][my][mx];
-          ekz -= x0*vdz_brick[mz][my][mx];
+          x0 = y0*wx[l];
+          ekx -= x0*rowx[l];
+          eky -= x0*rowy[l];
+          ekz -= x0*rowz[l];
         }
       }
     }
@@ -2476,8 +2451,9 @@ void PPPM::fieldforce_ik()
 
 void PPPM::fieldforce_ad()
 {
-  int i,l,m,n,nx,ny,nz,mx,my,mz;
+  int i,l,m,n,nx,ny,nz,my,mz;
   FFT_SCALAR dx,dy,dz;
+  const FFT_SCALAR *wx,*wy,*wz,*row;
   FFT_SCALAR ekx,eky,ekz;
   double s1,s2,s3;
   double sf = 0.0;
@@ -2495,7 +2471,8 @@ void PPPM::fieldforce_ad()
   // loop over my charges, interpolate electric field from nearby grid points
   // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
   // (dx,dy,dz) = distance to "lower left" grid pt
-  // (mx,my,mz) = global coords of moving stencil pt
+  // (wx,wy,wz) = stencil weights stored by make_rho() in this step
+  // row = x-row of potential brick in the stencil
   // ek = 3 components of E-field on particle
 
   double *q = atom->q;
@@ -2512,19 +2489,21 @@ void PPPM::fieldforce_ad()
     dy = ny+shiftone - (x[i][1]-boxlo[1])*delyinv;
     dz = nz+shiftone - (x[i][2]-boxlo[2])*delzinv;
 
-    compute_rho1d(dx,dy,dz);
     compute_drho1d(dx,dy,dz);
+    wx = rho1d_atom[i] - nlower;
+    wy = wx + order;
+    wz = wy + order;
 
     ekx = eky = ekz = ZEROF;
     for (n = nlower; n <= nupper; n++) {
       mz = n+nz;
       for (m = nlower; m <= nupper; m++) {
         my = m+ny;
+        row = &u_brick[mz][my][nx];
         for (l = nlower; l <= nupper; l++) {
-          mx = l+nx;
-          ekx += drho1d[0][l]*rho1d[1][m]*rho1d[2][n]*u_brick[mz][my][mx];
-          eky += rho1d[0][l]*drho1d[1][m]*rho1d[2][n]*u_brick[mz][my][mx];
-          ekz += rho1d[0][l]*rho1d[1][m]*drho1d[2][n]*u_brick[mz][my][mx];
+          ekx += drho1d[0][l]*wy[m]*wz[n]*row[l];
+          eky += wx[l]*drho1d[1][m]*wz[n]*row[l];
+          ekz += wx[l]*wy[m]*drho1d[2][n]*row[l];
         }
       }
     }
@@ -3045,6 +3024,7 @@ int PPPM::timing_3d(int n, double &time3d)
 double PPPM::memory_usage()
 {
   double bytes = nmax*3 * sizeof(double);
+  bytes += nmax_rho1d*3*order * sizeof(FFT_SCALAR);
   int nbrick = (nxhi_out-nxlo_out+1) * (nyhi_out-nylo_out+1) *
     (nzhi_out-nzlo_out+1);
   if (differentiation_flag == 1) {
@@ -3056,6 +3036,7 @@ double PPPM::memory_usage()
   bytes += 6 * nfft_both * sizeof(double);
   bytes += nfft_both * sizeof(double);
   bytes += nfft_both*5 * sizeof(FFT_SCALAR);
+  if (differentiation_flag != 1) bytes += nfft_both*4 * sizeof(FFT_SCALAR);
 
   if (peratom_allocate_flag)
     bytes += 6 * nbrick * sizeof(FFT_SCALAR);
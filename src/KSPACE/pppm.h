@@ -98,6 +98,8 @@ class PPPM : public KSpace {
 
   int **part2grid;             // storage for particle -> grid mapping
   int nmax;
+  FFT_SCALAR **rho1d_atom;     // stencil weights of each particle in x,y,z
+  int nmax_rho1d;              // set by make_rho(), reused by fieldforce()
 
   double *boxlo;
                                // TIP4P settings
@@ -160,6 +162,7 @@ class PPPM : public KSpace {
   void setup_triclinic();
   void compute_gf_ik_triclinic();
   void poisson_ik_triclinic();
+  void unpack_ik_gradients();
   void poisson_groups_triclinic();
 
   // group-group interactions
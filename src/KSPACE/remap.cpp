@@ -62,11 +62,34 @@
 void remap_3d(FFT_SCALAR *in, FFT_SCALAR *out, FFT_SCALAR *buf,
               struct remap_plan_3d *plan)
 {
+  remap_3d_many(in,out,buf,plan,1);
+}
+
+/* ----------------------------------------------------------------------
+   Perform 3d remap of several fields at once
+
+   same as remap_3d(), except
+   in,out       hold nfield fields one after the other, each the size of
+                  this proc's input or output section
+   buf          if memory=0, must hold nfield output sections
+   nfield       # of fields, remap_3d_fields() must have been called
+                  for at least this many
+   each message to another proc carries its part of all fields,
+     so the # of messages is the same as for a single field
+   all fields are packed before any is unpacked, so in can equal out
+------------------------------------------------------------------------- */
+
+void remap_3d_many(FFT_SCALAR *in, FFT_SCALAR *out, FFT_SCALAR *buf,
+                   struct remap_plan_3d *plan, int nfield)
+{
+  int i,m,isend,irecv,ifield;
+  int in_total = plan->in_total;
+  int out_total = plan->out_total;
+
   // use point-to-point communication
 
   if (!plan->usecollective) { 
     MPI_Status status;
-    int i,isend,irecv;
     FFT_SCALAR *scratch;
 
     if (plan->memory == 0)
@@ -77,16 +100,19 @@ void remap_3d(FFT_SCALAR *in, FFT_SCALAR *out, FFT_SCALAR *buf,
     // post all recvs into scratch space
 
     for (irecv = 0; irecv < plan->nrecv; irecv++)
-      MPI_Irecv(&scratch[plan->recv_bufloc[irecv]],plan->recv_size[irecv],
+      MPI_Irecv(&scratch[nfield*plan->recv_bufloc[irecv]],
+                nfield*plan->recv_size[irecv],
                 MPI_FFT_SCALAR,plan->recv_proc[irecv],0,
                 plan->comm,&plan->request[irecv]);
 
     // send all messages to other procs
 
     for (isend = 0; isend < plan->nsend; isend++) {
-      plan->pack(&in[plan->send_offset[isend]],
-                 plan->sendbuf,&plan->packplan[isend]);
-      MPI_Send(plan->sendbuf,plan->send_size[isend],MPI_FFT_SCALAR,
+      for (ifield = 0; ifield < nfield; ifield++)
+        plan->pack(&in[ifield*in_total + plan->send_offset[isend]],
+                   &plan->sendbuf[ifield*plan->send_size[isend]],
+                   &plan->packplan[isend]);
+      MPI_Send(plan->sendbuf,nfield*plan->send_size[isend],MPI_FFT_SCALAR,
                plan->send_proc[isend],0,plan->comm);
     }
 
@@ -95,115 +121,112 @@ void remap_3d(FFT_SCALAR *in, FFT_SCALAR *out, FFT_SCALAR *buf,
     if (plan->self) {
       isend = plan->nsend;
       irecv = plan->nrecv;
-      plan->pack(&in[plan->send_offset[isend]],
-                 &scratch[plan->recv_bufloc[irecv]],
-                 &plan->packplan[isend]);
-      plan->unpack(&scratch[plan->recv_bufloc[irecv]],
-                   &out[plan->recv_offset[irecv]],&plan->unpackplan[irecv]);
+      FFT_SCALAR *selfbuf = &scratch[nfield*plan->recv_bufloc[irecv]];
+      for (ifield = 0; ifield < nfield; ifield++)
+        plan->pack(&in[ifield*in_total + plan->send_offset[isend]],
+                   &selfbuf[ifield*plan->recv_size[irecv]],
+                   &plan->packplan[isend]);
+      for (ifield = 0; ifield < nfield; ifield++)
+        plan->unpack(&selfbuf[ifield*plan->recv_size[irecv]],
+                     &out[ifield*out_total + plan->recv_offset[irecv]],
+                     &plan->unpackplan[irecv]);
     }
 
     // unpack all messages from scratch -> out
 
     for (i = 0; i < plan->nrecv; i++) {
       MPI_Waitany(plan->nrecv,plan->request,&irecv,&status);
-      plan->unpack(&scratch[plan->recv_bufloc[irecv]],
-                   &out[plan->recv_offset[irecv]],&plan->unpackplan[irecv]);
+      for (ifield = 0; ifield < nfield; ifield++)
+        plan->unpack(&scratch[nfield*plan->recv_bufloc[irecv] +
+                              ifield*plan->recv_size[irecv]],
+                     &out[ifield*out_total + plan->recv_offset[irecv]],
+                     &plan->unpackplan[irecv]);
     }
 
   // use All2Allv collective for remap communication
+  // counts and which send/recv goes with each ring rank are set in plan
 
   } else { 
     if (plan->commringlen > 0) {
-      int isend,irecv;
-
-      // create send and recv buffers for alltoallv collective
-
       int sendBufferSize = 0;
       int recvBufferSize = 0;
-      for (int i=0;i<plan->nsend;i++)
-        sendBufferSize += plan->send_size[i];
-      for (int i=0;i<plan->nrecv;i++)
-        recvBufferSize += plan->recv_size[i];
+      for (i = 0; i < plan->commringlen; i++) {
+        m = plan->sendmap[i];
+        plan->sendcnts[i] = (m < 0) ? 0 : nfield*plan->send_size[m];
+        plan->sdispls[i] = sendBufferSize;
+        sendBufferSize += plan->sendcnts[i];
+        m = plan->recvmap[i];
+        plan->recvcnts[i] = (m < 0) ? 0 : nfield*plan->recv_size[m];
+        plan->rdispls[i] = recvBufferSize;
+        recvBufferSize += plan->recvcnts[i];
+      }
 
       FFT_SCALAR *packedSendBuffer 
         = (FFT_SCALAR *) malloc(sizeof(FFT_SCALAR) * sendBufferSize);
       FFT_SCALAR *packedRecvBuffer 
         = (FFT_SCALAR *) malloc(sizeof(FFT_SCALAR) * recvBufferSize);
 
-      int *sendcnts = (int *) malloc(sizeof(int) * plan->commringlen);
-      int *rcvcnts = (int *) malloc(sizeof(int) * plan->commringlen);
-      int *sdispls = (int *) malloc(sizeof(int) * plan->commringlen);
-      int *rdispls = (int *) malloc(sizeof(int) * plan->commringlen);
-      int *nrecvmap = (int *) malloc(sizeof(int) * plan->commringlen);
-
-      // create and populate send data, count and displacement buffers
-
-      int currentSendBufferOffset = 0;
-      for (isend = 0; isend < plan->commringlen; isend++) {
-        sendcnts[isend] = 0;
-        sdispls[isend] = 0;
-        int foundentry = 0;
-        for (int i=0;(i<plan->nsend && !foundentry); i++) {
-          if (plan->send_proc[i] == plan->commringlist[isend]) {
-            foundentry = 1;
-            sendcnts[isend] = plan->send_size[i];
-            sdispls[isend] = currentSendBufferOffset;
-            plan->pack(&in[plan->send_offset[i]],
-                       &packedSendBuffer[currentSendBufferOffset],
-                       &plan->packplan[i]);
-            currentSendBufferOffset += plan->send_size[i];
-          }
-        }
-      }
+      // pack all fields of each send contiguously
 
-      // create and populate recv count and displacement buffers
-
-      int currentRecvBufferOffset = 0;
-      for (irecv = 0; irecv < plan->commringlen; irecv++) {
-        rcvcnts[irecv] = 0;
-        rdispls[irecv] = 0;
-        nrecvmap[irecv] = -1;
-        int foundentry = 0;
-        for (int i=0;(i<plan->nrecv && !foundentry); i++) {
-          if (plan->recv_proc[i] == plan->commringlist[irecv]) {
-            foundentry = 1;
-            rcvcnts[irecv] = plan->recv_size[i];
-            rdispls[irecv] = currentRecvBufferOffset;
-            currentRecvBufferOffset += plan->recv_size[i];
-            nrecvmap[irecv] = i;
-          }
-        }
+      for (i = 0; i < plan->commringlen; i++) {
+        m = plan->sendmap[i];
+        if (m < 0) continue;
+        for (ifield = 0; ifield < nfield; ifield++)
+          plan->pack(&in[ifield*in_total + plan->send_offset[m]],
+                     &packedSendBuffer[plan->sdispls[i] +
+                                       ifield*plan->send_size[m]],
+                     &plan->packplan[m]);
       }
 
-      MPI_Alltoallv(packedSendBuffer, sendcnts, sdispls,
-                    MPI_FFT_SCALAR, packedRecvBuffer, rcvcnts,
-                    rdispls, MPI_FFT_SCALAR, plan->comm);
+      MPI_Alltoallv(packedSendBuffer, plan->sendcnts, plan->sdispls,
+                    MPI_FFT_SCALAR, packedRecvBuffer, plan->recvcnts,
+                    plan->rdispls, MPI_FFT_SCALAR, plan->comm);
 
       // unpack the data from the recv buffer into out
 
-      currentRecvBufferOffset = 0;
-      for (irecv = 0; irecv < plan->commringlen; irecv++) {
-        if (nrecvmap[irecv] > -1) {
-          plan->unpack(&packedRecvBuffer[currentRecvBufferOffset],
-                       &out[plan->recv_offset[nrecvmap[irecv]]],
-                       &plan->unpackplan[nrecvmap[irecv]]);
-          currentRecvBufferOffset += plan->recv_size[nrecvmap[irecv]];
-        }
+      for (i = 0; i < plan->commringlen; i++) {
+        m = plan->recvmap[i];
+        if (m < 0) continue;
+        for (ifield = 0; ifield < nfield; ifield++)
+          plan->unpack(&packedRecvBuffer[plan->rdispls[i] +
+                                         ifield*plan->recv_size[m]],
+                       &out[ifield*out_total + plan->recv_offset[m]],
+                       &plan->unpackplan[m]);
       }
 
-      // free temporary data structures
-
-      free(sendcnts);
-      free(rcvcnts);
-      free(sdispls);
-      free(rdispls);
-      free(nrecvmap);
       free(packedSendBuffer);
       free(packedRecvBuffer);
     }
   }
 }
 
+/* ----------------------------------------------------------------------
+   Size internal buffers of a plan for remapping nfield fields at once
+   return 0 if successful, 1 if memory could not be allocated
+------------------------------------------------------------------------- */
+
+int remap_3d_fields(struct remap_plan_3d *plan, int nfield)
+{
+  if (nfield <= plan->nfield) return 0;
+
+  if (plan->sendbuf) {
+    free(plan->sendbuf);
+    plan->sendbuf =
+      (FFT_SCALAR *) malloc(nfield*plan->send_max*sizeof(FFT_SCALAR));
+    if (plan->sendbuf == NULL) return 1;
+  }
+
+  if (plan->scratch) {
+    free(plan->scratch);
+    plan->scratch =
+      (FFT_SCALAR *) malloc(nfield*plan->out_total*sizeof(FFT_SCALAR));
+    if (plan->scratch == NULL) return 1;
+  }
+
+  plan->nfield = nfield;
+  return 0;
+}
+
 /* ----------------------------------------------------------------------
    Create plan for performing a 3d remap
 
@@ -564,9 +587,44 @@ struct remap_plan_3d *remap_3d_create_plan(
     else plan->nrecv = nrecv - 1;
   } else plan->nrecv = nrecv;
 
+  // for collectives, map each ring rank to its send and recv, if any
+
+  plan->sendmap = plan->recvmap = NULL;
+  plan->sendcnts = plan->sdispls = plan->recvcnts = plan->rdispls = NULL;
+
+  if (plan->usecollective && plan->commringlen > 0) {
+    int n = plan->commringlen;
+    plan->sendmap = (int *) malloc(n*sizeof(int));
+    plan->recvmap = (int *) malloc(n*sizeof(int));
+    plan->sendcnts = (int *) malloc(n*sizeof(int));
+    plan->sdispls = (int *) malloc(n*sizeof(int));
+    plan->recvcnts = (int *) malloc(n*sizeof(int));
+    plan->rdispls = (int *) malloc(n*sizeof(int));
+    if (plan->sendmap == NULL || plan->recvmap == NULL ||
+        plan->sendcnts == NULL || plan->sdispls == NULL ||
+        plan->recvcnts == NULL || plan->rdispls == NULL) return NULL;
+
+    for (i = 0; i < n; i++) {
+      plan->sendmap[i] = plan->recvmap[i] = -1;
+      for (int j = 0; j < plan->nsend; j++)
+        if (plan->send_proc[j] == plan->commringlist[i]) {
+          plan->sendmap[i] = j;
+          break;
+        }
+      for (int j = 0; j < plan->nrecv; j++)
+        if (plan->recv_proc[j] == plan->commringlist[i]) {
+          plan->recvmap[i] = j;
+          break;
+        }
+    }
+  }
+
   // init remaining fields in remap plan
 
   plan->memory = memory;
+  plan->in_total = nqty*in.isize*in.jsize*in.ksize;
+  plan->out_total = nqty*out.isize*out.jsize*out.ksize;
+  plan->nfield = 1;
 
   if (nrecv == plan->nrecv) plan->self = 0;
   else plan->self = 1;
@@ -584,6 +642,8 @@ struct remap_plan_3d *remap_3d_create_plan(
   for (nsend = 0; nsend < plan->nsend; nsend++)
     size = MAX(size,plan->send_size[nsend]);
 
+  plan->send_max = size;
+
   if (size) {
     plan->sendbuf = (FFT_SCALAR *) malloc(size*sizeof(FFT_SCALAR));
     if (plan->sendbuf == NULL) return NULL;
@@ -645,6 +705,14 @@ void remap_3d_destroy_plan(struct remap_plan_3d *plan)
   if (plan->usecollective) {
     if (plan->commringlist != NULL)
       free(plan->commringlist);
+    if (plan->sendmap) {
+      free(plan->sendmap);
+      free(plan->recvmap);
+      free(plan->sendcnts);
+      free(plan->sdispls);
+      free(plan->recvcnts);
+      free(plan->rdispls);
+    }
   }
 
   // free internal arrays
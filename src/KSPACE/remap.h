@@ -48,6 +48,12 @@ struct remap_plan_3d {
   int usecollective;                // use collective or point-to-point MPI
   int commringlen;                  // length of commringlist
   int *commringlist;                // ranks on communication ring of this plan
+  int *sendmap,*recvmap;            // send/recv index of each ring rank, or -1
+  int *sendcnts,*sdispls;           // collective counts and displacements
+  int *recvcnts,*rdispls;           //   per ring rank, set on each remap
+  int in_total,out_total;           // # of datums per field in input/output
+  int send_max;                     // # of datums in biggest send message
+  int nfield;                       // # of fields sendbuf/scratch can hold
 };
 
 // collision between 2 regions
@@ -61,6 +67,9 @@ struct extent_3d {
 // function prototypes
 
 void remap_3d(FFT_SCALAR *, FFT_SCALAR *, FFT_SCALAR *, struct remap_plan_3d *);
+void remap_3d_many(FFT_SCALAR *, FFT_SCALAR *, FFT_SCALAR *,
+                   struct remap_plan_3d *, int);
+int remap_3d_fields(struct remap_plan_3d *, int);
 struct remap_plan_3d *remap_3d_create_plan(MPI_Comm,
                                            int, int, int, int, int, int,
                                            int, int, int, int, int, int,
@@ -58,4 +58,5 @@ ComputePECuda::ComputePECuda(LAMMPS *lmp, int narg, char **arg) :
   ComputePE(lmp, narg, arg)
 {
   cudable = 1;
+  reduceflag = 0;
 }
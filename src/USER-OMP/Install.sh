@@ -27,12 +27,14 @@ action () {
 
 for file in *_omp.cpp; do
   test $file = thr_omp.cpp && continue
+  case $file in pair_eam*_opt_omp.cpp) continue ;; esac
   dep=${file%_omp.cpp}.cpp
   action $file $dep
 done
 
 for file in *_omp.h; do
   test $file = thr_omp.h && continue
+  case $file in pair_eam*_opt_omp.h) continue ;; esac
   dep=${file%_omp.h}.h
   action $file $dep
 done
@@ -44,6 +46,16 @@ action thr_data.cpp
 
 # step 2: handle cases and tasks not handled in step 1
 
+# eam/opt/omp styles derive from the eam/omp styles, not from OPT,
+# so they only need the MANYBODY parent files
+
+action pair_eam_opt_omp.cpp pair_eam.cpp
+action pair_eam_opt_omp.h pair_eam.h
+action pair_eam_alloy_opt_omp.cpp pair_eam_alloy.cpp
+action pair_eam_alloy_opt_omp.h pair_eam_alloy.h
+action pair_eam_fs_opt_omp.cpp pair_eam_fs.cpp
+action pair_eam_fs_opt_omp.h pair_eam_fs.h
+
 if (test $mode = 1) then
 
   if (test -e ../Makefile.package) then
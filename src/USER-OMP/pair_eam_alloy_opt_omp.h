@@ -0,0 +1,36 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef PAIR_CLASS
+
+PairStyle(eam/alloy/opt/omp,PairEAMAlloyOptOMP)
+
+#else
+
+#ifndef LMP_PAIR_EAM_ALLOY_OPT_OMP_H
+#define LMP_PAIR_EAM_ALLOY_OPT_OMP_H
+
+#include "pair_eam_alloy_omp.h"
+#include "pair_eam_opt_omp.h"
+
+namespace LAMMPS_NS {
+
+class PairEAMAlloyOptOMP : public PairEAMAlloyOMP, public PairEAMOptOMP {
+ public:
+  PairEAMAlloyOptOMP(class LAMMPS *);
+};
+
+}
+
+#endif
+#endif
@@ -0,0 +1,422 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "math.h"
+#include "string.h"
+
+#include "pair_eam_opt_omp.h"
+#include "atom.h"
+#include "comm.h"
+#include "force.h"
+#include "memory.h"
+#include "neighbor.h"
+#include "neigh_list.h"
+#include "neigh_request.h"
+
+#include "suffix.h"
+using namespace LAMMPS_NS;
+
+/* ---------------------------------------------------------------------- */
+
+PairEAMOptOMP::PairEAMOptOMP(LAMMPS *lmp) : PairEAMOMP(lmp)
+{
+  suffix_flag |= Suffix::OPT;
+
+  // full neighbor list, so virial is tallied per pair
+
+  no_virial_fdotr_compute = 1;
+
+  nknot = 0;
+  rhor_pack = NULL;
+  force_pack = NULL;
+
+  maxthreads = 0;
+  maxcache = NULL;
+  jcache = NULL;
+  rcache = NULL;
+  ncache = NULL;
+  maxncache = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+PairEAMOptOMP::~PairEAMOptOMP()
+{
+  memory->destroy(rhor_pack);
+  memory->destroy(force_pack);
+
+  for (int t = 0; t < maxthreads; t++) {
+    memory->destroy(jcache[t]);
+    memory->destroy(rcache[t]);
+  }
+  delete [] maxcache;
+  delete [] jcache;
+  delete [] rcache;
+  memory->destroy(ncache);
+}
+
+/* ----------------------------------------------------------------------
+   same as PairEAM, but request a full neighbor list
+------------------------------------------------------------------------- */
+
+void PairEAMOptOMP::init_style()
+{
+  // convert read-in file(s) to arrays and spline them
+
+  file2array();
+  array2spline();
+  pack_splines();
+
+  // request with the Pair pointer, since Pair is a virtual base and
+  // the requestor is cast back to Pair * and compared to force->pair
+
+  int irequest = neighbor->request((Pair *) this);
+  neighbor->requests[irequest]->half = 0;
+  neighbor->requests[irequest]->full = 1;
+}
+
+/* ----------------------------------------------------------------------
+   copy the splines a type pair I,J needs into one table per pass,
+   so each knot is one contiguous block as in pair_style eam/opt
+   rhor_pack = value coeffs of density at I due to J
+   force_pack = derivative coeffs of density at J due to I,
+     of density at I due to J, of z2 = phi*r, then value coeffs of z2
+------------------------------------------------------------------------- */
+
+void PairEAMOptOMP::pack_splines()
+{
+  int i,j,m,k;
+  int ntypes = atom->ntypes;
+  double *coeff;
+
+  nknot = nr+1;
+  memory->destroy(rhor_pack);
+  memory->destroy(force_pack);
+  memory->create(rhor_pack,ntypes*ntypes*nknot*4,"pair:rhor_pack");
+  memory->create(force_pack,ntypes*ntypes*nknot*16,"pair:force_pack");
+  memset(rhor_pack,0,ntypes*ntypes*nknot*4*sizeof(double));
+  memset(force_pack,0,ntypes*ntypes*nknot*16*sizeof(double));
+
+  for (i = 1; i <= ntypes; i++)
+    for (j = 1; j <= ntypes; j++) {
+      double *rtab = &rhor_pack[((i-1)*ntypes + j-1)*nknot*4];
+      double *ftab = &force_pack[((i-1)*ntypes + j-1)*nknot*16];
+      for (m = 0; m < nknot; m++) {
+        if (type2rhor[j][i] >= 0) {
+          coeff = rhor_spline[type2rhor[j][i]][m];
+          for (k = 0; k < 4; k++) rtab[4*m+k] = coeff[3+k];
+          for (k = 0; k < 3; k++) ftab[16*m+3+k] = coeff[k];
+        }
+        if (type2rhor[i][j] >= 0) {
+          coeff = rhor_spline[type2rhor[i][j]][m];
+          for (k = 0; k < 3; k++) ftab[16*m+k] = coeff[k];
+        }
+        if (type2z2r[i][j] >= 0) {
+          coeff = z2r_spline[type2z2r[i][j]][m];
+          for (k = 0; k < 3; k++) ftab[16*m+6+k] = coeff[k];
+          for (k = 0; k < 4; k++) ftab[16*m+9+k] = coeff[3+k];
+        }
+      }
+    }
+}
+
+/* ---------------------------------------------------------------------- */
+
+void PairEAMOptOMP::compute(int eflag, int vflag)
+{
+  if (eflag || vflag) {
+    ev_setup(eflag,vflag);
+  } else evflag = vflag_fdotr = eflag_global = eflag_atom = 0;
+
+  const int nall = atom->nlocal + atom->nghost;
+  const int nthreads = comm->nthreads;
+  const int inum = list->inum;
+
+  // grow energy and fp arrays if necessary
+  // need to be atom->nmax in length
+  // each thread only sets rho of its own atoms, so no per-thread copies
+
+  if (atom->nmax > nmax) {
+    memory->destroy(rho);
+    memory->destroy(fp);
+    nmax = atom->nmax;
+    memory->create(rho,nmax,"pair:rho");
+    memory->create(fp,nmax,"pair:fp");
+  }
+
+  // neighbor caches are grown by each thread in eval()
+
+  if (nthreads > maxthreads) {
+    for (int t = 0; t < maxthreads; t++) {
+      memory->destroy(jcache[t]);
+      memory->destroy(rcache[t]);
+    }
+    delete [] maxcache;
+    delete [] jcache;
+    delete [] rcache;
+    maxthreads = nthreads;
+    maxcache = new int[maxthreads];
+    jcache = new int*[maxthreads];
+    rcache = new double*[maxthreads];
+    for (int t = 0; t < maxthreads; t++) {
+      maxcache[t] = 0;
+      jcache[t] = NULL;
+      rcache[t] = NULL;
+    }
+  }
+
+  if (inum > maxncache) {
+    maxncache = atom->nmax;
+    memory->destroy(ncache);
+    memory->create(ncache,maxncache,"pair:ncache");
+  }
+
+#if defined(_OPENMP)
+#pragma omp parallel default(none) shared(eflag,vflag)
+#endif
+  {
+    int ifrom, ito, tid;
+
+    loop_setup_thr(ifrom, ito, tid, inum, nthreads);
+    ThrData *thr = fix->get_thr(tid);
+    ev_setup_thr(eflag, vflag, nall, eatom, vatom, thr);
+
+    if (evflag) {
+      if (eflag) eval<1,1>(ifrom, ito, thr);
+      else eval<1,0>(ifrom, ito, thr);
+    } else eval<0,0>(ifrom, ito, thr);
+
+    reduce_thr((Pair *) this, eflag, vflag, thr);
+  } // end of omp parallel region
+}
+
+/* ----------------------------------------------------------------------
+   full neighbor list, so each thread sums the complete density of its
+   own atoms and computes forces on them only:
+   no reverse comm of rho, no per-thread rho, no writes to neighbors
+   neighbors inside the cutoff are cached in the density pass with
+   their distance, so the force pass needs no cutoff test or sqrt()
+------------------------------------------------------------------------- */
+
+template <int EVFLAG, int EFLAG>
+void PairEAMOptOMP::eval(int iifrom, int iito, ThrData * const thr)
+{
+  int i,j,ii,jj,kk,k,m,jnum,itype,nk;
+  double xtmp,ytmp,ztmp,delx,dely,delz,fpair,fpi;
+  double rsq,r,p,rhoip,rhojp,z2,z2p,recip,phip,psip,phi,rhotmp;
+  const double *c,*itab;
+  int *jlist;
+
+  const dbl3_t * _noalias const x = (dbl3_t *) atom->x[0];
+  dbl3_t * _noalias const f = (dbl3_t *) thr->get_f()[0];
+  const int tid = thr->get_tid();
+
+  const int * _noalias const type = atom->type;
+  const int nlocal = atom->nlocal;
+  const int ntypes = atom->ntypes;
+  const int nr1 = nr-1;
+  const double cutsq = cutforcesq;
+  const double rdrone = rdr;
+
+  const int * _noalias const ilist = list->ilist;
+  const int * _noalias const numneigh = list->numneigh;
+  int ** const firstneigh = list->firstneigh;
+
+  double fxtmp,fytmp,fztmp;
+  double v[6];
+
+  // grow neighbor cache of this thread
+
+  k = 0;
+  for (ii = iifrom; ii < iito; ii++) k += numneigh[ilist[ii]];
+  if (k > maxcache[tid]) {
+    maxcache[tid] = k;
+    memory->destroy(jcache[tid]);
+    memory->destroy(rcache[tid]);
+    memory->create(jcache[tid],k,"pair:jcache");
+    memory->create(rcache[tid],k,"pair:rcache");
+  }
+  int * _noalias const jc = jcache[tid];
+  double * _noalias const rc = rcache[tid];
+
+  // rho = density at each atom
+  // loop over neighbors of my atoms
+  // distance test and spline evaluation are separate loops,
+  //   so the latter runs over a compact list without branches
+
+  k = 0;
+  for (ii = iifrom; ii < iito; ii++) {
+    i = ilist[ii];
+    xtmp = x[i].x;
+    ytmp = x[i].y;
+    ztmp = x[i].z;
+    itype = type[i] - 1;
+    jlist = firstneigh[i];
+    jnum = numneigh[i];
+
+    const int kfirst = k;
+    for (jj = 0; jj < jnum; jj++) {
+      j = jlist[jj];
+      j &= NEIGHMASK;
+
+      delx = xtmp - x[j].x;
+      dely = ytmp - x[j].y;
+      delz = ztmp - x[j].z;
+      rsq = delx*delx + dely*dely + delz*delz;
+
+      if (rsq < cutsq) {
+        jc[k] = j;
+        rc[k] = rsq;
+        k++;
+      }
+    }
+    ncache[ii] = k - kfirst;
+
+    itab = &rhor_pack[itype*ntypes*nknot*4];
+    rhotmp = 0.0;
+    for (kk = kfirst; kk < k; kk++) {
+      r = sqrt(rc[kk]);
+      rc[kk] = r;
+      p = r*rdrone + 1.0;
+      m = static_cast<int> (p);
+      m = MIN(m,nr1);
+      p -= m;
+      p = MIN(p,1.0);
+      c = &itab[((type[jc[kk]]-1)*nknot + m)*4];
+      rhotmp += ((c[0]*p + c[1])*p + c[2])*p + c[3];
+    }
+    rho[i] = rhotmp;
+  }
+
+  // fp = derivative of embedding energy at each atom
+  // phi = embedding energy at each atom
+  // if rho > rhomax (e.g. due to close approach of two atoms),
+  //   will exceed table, so add linear term to conserve energy
+
+  for (ii = iifrom; ii < iito; ii++) {
+    i = ilist[ii];
+    p = rho[i]*rdrho + 1.0;
+    m = static_cast<int> (p);
+    m = MAX(1,MIN(m,nrho-1));
+    p -= m;
+    p = MIN(p,1.0);
+    c = frho_spline[type2frho[type[i]]][m];
+    fp[i] = (c[0]*p + c[1])*p + c[2];
+    if (EFLAG) {
+      phi = ((c[3]*p + c[4])*p + c[5])*p + c[6];
+      if (rho[i] > rhomax) phi += fp[i] * (rho[i]-rhomax);
+      e_tally_thr(this, i, i, nlocal, 1, phi, 0.0, thr);
+    }
+  }
+
+  // wait until all theads are done with computation
+  sync_threads();
+
+  // communicate derivative of embedding function
+  // MPI communication only on master thread
+#if defined(_OPENMP)
+#pragma omp master
+#endif
+  { comm->forward_comm_pair(this); }
+
+  // wait until master thread is done with communication
+  sync_threads();
+
+  // compute forces on each atom
+  // loop over cached neighbors of my atoms
+
+  k = 0;
+  for (ii = iifrom; ii < iito; ii++) {
+    i = ilist[ii];
+    xtmp = x[i].x;
+    ytmp = x[i].y;
+    ztmp = x[i].z;
+    itype = type[i] - 1;
+    fpi = fp[i];
+    fxtmp = fytmp = fztmp = 0.0;
+
+    itab = &force_pack[itype*ntypes*nknot*16];
+    nk = k + ncache[ii];
+
+    for (kk = k; kk < nk; kk++) {
+      j = jc[kk];
+      r = rc[kk];
+      p = r*rdrone + 1.0;
+      m = static_cast<int> (p);
+      m = MIN(m,nr1);
+      p -= m;
+      p = MIN(p,1.0);
+
+      // rhoip = derivative of (density at atom j due to atom i)
+      // rhojp = derivative of (density at atom i due to atom j)
+      // phi = pair potential energy
+      // phip = phi'
+      // z2 = phi * r
+      // z2p = (phi * r)' = (phi' r) + phi
+      // psip needs both fp[i] and fp[j] terms since r_ij appears in two
+      //   terms of embed eng: Fi(sum rho_ij) and Fj(sum rho_ji)
+      //   hence embed' = Fi(sum rho_ij) rhojp + Fj(sum rho_ji) rhoip
+
+      c = &itab[((type[j]-1)*nknot + m)*16];
+      rhoip = (c[0]*p + c[1])*p + c[2];
+      rhojp = (c[3]*p + c[4])*p + c[5];
+      z2p = (c[6]*p + c[7])*p + c[8];
+      z2 = ((c[9]*p + c[10])*p + c[11])*p + c[12];
+
+      recip = 1.0/r;
+      phi = z2*recip;
+      phip = z2p*recip - phi*recip;
+      psip = fpi*rhojp + fp[j]*rhoip + phip;
+      fpair = -psip*recip;
+
+      delx = xtmp - x[j].x;
+      dely = ytmp - x[j].y;
+      delz = ztmp - x[j].z;
+      fxtmp += delx*fpair;
+      fytmp += dely*fpair;
+      fztmp += delz*fpair;
+
+      // each pair is seen from both atoms, so tally half of it to atom i
+
+      if (EVFLAG) {
+        if (EFLAG) e_tally_thr(this, i, i, nlocal, 1, 0.5*phi, 0.0, thr);
+        if (vflag_either) {
+          v[0] = 0.5*delx*delx*fpair;
+          v[1] = 0.5*dely*dely*fpair;
+          v[2] = 0.5*delz*delz*fpair;
+          v[3] = 0.5*delx*dely*fpair;
+          v[4] = 0.5*delx*delz*fpair;
+          v[5] = 0.5*dely*delz*fpair;
+          v_tally_thr(this, i, i, nlocal, 1, v, thr);
+        }
+      }
+    }
+    f[i].x += fxtmp;
+    f[i].y += fytmp;
+    f[i].z += fztmp;
+    k = nk;
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+double PairEAMOptOMP::memory_usage()
+{
+  double bytes = PairEAMOMP::memory_usage();
+  bytes += atom->ntypes*atom->ntypes*nknot*20 * sizeof(double);
+  for (int t = 0; t < maxthreads; t++)
+    bytes += maxcache[t] * (sizeof(int) + sizeof(double));
+  bytes += maxncache * sizeof(int);
+
+  return bytes;
+}
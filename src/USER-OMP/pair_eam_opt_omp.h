@@ -0,0 +1,61 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef PAIR_CLASS
+
+PairStyle(eam/opt/omp,PairEAMOptOMP)
+
+#else
+
+#ifndef LMP_PAIR_EAM_OPT_OMP_H
+#define LMP_PAIR_EAM_OPT_OMP_H
+
+#include "pair_eam_omp.h"
+
+namespace LAMMPS_NS {
+
+// use virtual public since this class is parent in multiple inheritance
+
+class PairEAMOptOMP : virtual public PairEAMOMP {
+ public:
+  PairEAMOptOMP(class LAMMPS *);
+  virtual ~PairEAMOptOMP();
+
+  virtual void compute(int, int);
+  void init_style();
+  virtual double memory_usage();
+
+ protected:
+  int nknot;                    // # of knots per type pair in packed tables
+  double *rhor_pack;            // density at I due to J, 4 coeffs per knot
+  double *force_pack;           // d(density) at J and I, (phi r) and its
+                                // derivative, 16 coeffs per knot
+
+  int maxthreads;               // # of threads the caches are allocated for
+  int *maxcache;                // size of neighbor cache of each thread
+  int **jcache;                 // neighbors of each thread inside cutoff
+  double **rcache;              // and their distances
+  int *ncache;                  // # of cached neighbors of each list entry
+  int maxncache;
+
+  void pack_splines();
+
+ private:
+  template <int EVFLAG, int EFLAG>
+  void eval(int iifrom, int iito, ThrData * const thr);
+};
+
+}
+
+#endif
+#endif
@@ -49,6 +49,16 @@ PPPMOMP::PPPMOMP(LAMMPS *lmp, int narg, char **arg) :
 {
   triclinic_support = 0;
   suffix_flag |= Suffix::OMP;
+
+  density_thr = NULL;
+  nthr_density = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+PPPMOMP::~PPPMOMP()
+{
+  memory->destroy(density_thr);
 }
 
 /* ----------------------------------------------------------------------
@@ -81,6 +91,12 @@ void PPPMOMP::deallocate()
 {
   PPPM::deallocate();
 
+  // per-thread density bricks depend on ngrid, make_rho() reallocates them
+
+  memory->destroy(density_thr);
+  density_thr = NULL;
+  nthr_density = 0;
+
 #if defined(_OPENMP)
 #pragma omp parallel default(none)
 #endif
@@ -342,6 +358,24 @@ void PPPMOMP::make_rho()
   const int nlocal = atom->nlocal;
   if (nlocal == 0) return;
 
+  // stencil weights of each charge are kept for fieldforce() of this step
+  // threads other than the first deposit into their own density brick
+
+  const int nthreads = comm->nthreads;
+
+  if (nlocal > nmax_rho1d) {
+    memory->destroy(rho1d_atom);
+    nmax_rho1d = atom->nmax;
+    memory->create(rho1d_atom,nmax_rho1d,3*order,"pppm:rho1d_atom");
+  }
+
+  if (nthreads != nthr_density) {
+    memory->destroy(density_thr);
+    nthr_density = nthreads;
+    if (nthreads > 1)
+      memory->create(density_thr,(nthreads-1)*ngrid,"pppm:density_thr");
+  }
+
   const int ix = nxhi_out - nxlo_out + 1;
   const int iy = nyhi_out - nylo_out + 1;
 
@@ -357,58 +391,63 @@ void PPPMOMP::make_rho()
     const double boxloy = boxlo[1];
     const double boxloz = boxlo[2];
 
-    // determine range of grid points handled by this thread
-    int i,jfrom,jto,tid;
-    loop_setup_thr(jfrom,jto,tid,ngrid,comm->nthreads);
+    // determine range of atoms handled by this thread
+    int i,ifrom,ito,tid;
+    loop_setup_thr(ifrom,ito,tid,nlocal,nthreads);
 
-    // get per thread data
-    ThrData *thr = fix->get_thr(tid);
-    FFT_SCALAR * const * const r1d = static_cast<FFT_SCALAR **>(thr->get_rho1d());
+    // density brick this thread adds to
+    FFT_SCALAR * _noalias const dt =
+      (tid == 0) ? d : density_thr + (tid-1)*ngrid;
+    if (tid > 0) memset(dt,0,ngrid*sizeof(FFT_SCALAR));
 
     // loop over my charges, add their contribution to nearby grid points
     // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
     // (dx,dy,dz) = distance to "lower left" grid pt
+    // w = weights of stencil pts in x,y,z, indexed from nlower to nupper
 
-    // loop over all local atoms for all threads
-    for (i = 0; i < nlocal; i++) {
+    for (i = ifrom; i < ito; i++) {
 
       const int nx = p2g[i].a;
       const int ny = p2g[i].b;
       const int nz = p2g[i].t;
-
-      // pre-screen whether this atom will ever come within 
-      // reach of the data segement this thread is updating.
-      if ( ((nz+nlower-nzlo_out)*ix*iy >= jto)
-           || ((nz+nupper-nzlo_out+1)*ix*iy < jfrom) ) continue;
-
       const FFT_SCALAR dx = nx+shiftone - (x[i].x-boxlox)*delxinv;
       const FFT_SCALAR dy = ny+shiftone - (x[i].y-boxloy)*delyinv;
       const FFT_SCALAR dz = nz+shiftone - (x[i].z-boxloz)*delzinv;
 
-      compute_rho1d_thr(r1d,dx,dy,dz);
+      FFT_SCALAR * const wx = rho1d_atom[i] - nlower;
+      FFT_SCALAR * const w[3] = {wx, wx+order, wx+2*order};
+      compute_rho1d_thr(w,dx,dy,dz);
 
       const FFT_SCALAR z0 = delvolinv * q[i];
 
       for (int n = nlower; n <= nupper; ++n) {
         const int jn = (nz+n-nzlo_out)*ix*iy;
-        const FFT_SCALAR y0 = z0*r1d[2][n];
+        const FFT_SCALAR y0 = z0*w[2][n];
 
         for (int m = nlower; m <= nupper; ++m) {
-          const int jm = jn+(ny+m-nylo_out)*ix;
-          const FFT_SCALAR x0 = y0*r1d[1][m];
-
-          for (int l = nlower; l <= nupper; ++l) {
-            const int jl = jm+nx+l-nxlo_out;
-            // make sure each thread only updates
-            // "his" elements of the density grid
-            if (jl >= jto) break;
-            if (jl < jfrom) continue;
+          FFT_SCALAR * _noalias const row = dt + jn+(ny+m-nylo_out)*ix+nx-nxlo_out;
+          const FFT_SCALAR x0 = y0*w[1][m];
 
-            d[jl] += x0*r1d[0][l];
-          }
+          for (int l = nlower; l <= nupper; ++l)
+            row[l] += x0*wx[l];
         }
       }
     }
+
+    // add bricks of the other threads to the density brick,
+    // each thread sums over its own range of grid points
+
+#if defined(_OPENMP)
+    if (nthreads > 1) {
+#pragma omp barrier
+      int j,jfrom,jto,t;
+      loop_setup_thr(jfrom,jto,tid,ngrid,nthreads);
+      for (t = 0; t < nthreads-1; ++t) {
+        const FFT_SCALAR * _noalias const ds = density_thr + t*ngrid;
+        for (j = jfrom; j < jto; ++j) d[j] += ds[j];
+      }
+    }
+#endif
   }
 }
 
@@ -420,8 +459,8 @@ void PPPMOMP::fieldforce_ik()
 {
   // loop over my charges, interpolate electric field from nearby grid points
   // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
-  // (dx,dy,dz) = distance to "lower left" grid pt
-  // (mx,my,mz) = global coords of moving stencil pt
+  // (wx,wy,wz) = stencil weights stored by make_rho() in this step
+  // rowx,rowy,rowz = x-rows of the 3 field bricks in the stencil
   // ek = 3 components of E-field on particle
 
   const int nthreads = comm->nthreads;
@@ -431,52 +470,48 @@ void PPPMOMP::fieldforce_ik()
 
   if (nlocal == 0) return;
 
-  const dbl3_t * _noalias const x = (dbl3_t *) atom->x[0];
   const double * _noalias const q = atom->q;
   const int3_t * _noalias const p2g = (int3_t *) part2grid[0];
 
   const double qqrd2e = force->qqrd2e;
-  const double boxlox = boxlo[0];
-  const double boxloy = boxlo[1];
-  const double boxloz = boxlo[2];
 
 #if defined(_OPENMP)
 #pragma omp parallel default(none)
 #endif
   {
     FFT_SCALAR x0,y0,z0,ekx,eky,ekz;
-    int i,ifrom,ito,tid,l,m,n,mx,my,mz;
+    const FFT_SCALAR *wx,*wy,*wz,*rowx,*rowy,*rowz;
+    int i,ifrom,ito,tid,l,m,n,my,mz;
 
     loop_setup_thr(ifrom,ito,tid,nlocal,nthreads);
 
     // get per thread data
     ThrData *thr = fix->get_thr(tid);
     dbl3_t * _noalias const f = (dbl3_t *) thr->get_f()[0];
-    FFT_SCALAR * const * const r1d = static_cast<FFT_SCALAR **>(thr->get_rho1d());
 
     for (i = ifrom; i < ito; ++i) {
       const int nx = p2g[i].a;
       const int ny = p2g[i].b;
       const int nz = p2g[i].t;
-      const FFT_SCALAR dx = nx+shiftone - (x[i].x-boxlox)*delxinv;
-      const FFT_SCALAR dy = ny+shiftone - (x[i].y-boxloy)*delyinv;
-      const FFT_SCALAR dz = nz+shiftone - (x[i].z-boxloz)*delzinv;
-
-      compute_rho1d_thr(r1d,dx,dy,dz);
+      wx = rho1d_atom[i] - nlower;
+      wy = wx + order;
+      wz = wy + order;
 
       ekx = eky = ekz = ZEROF;
       for (n = nlower; n <= nupper; n++) {
         mz = n+nz;
-        z0 = r1d[2][n];
+        z0 = wz[n];
         for (m = nlower; m <= nupper; m++) {
           my = m+ny;
-          y0 = z0*r1d[1][m];
+          y0 = z0*wy[m];
+          rowx = &vdx_brick[mz][my][nx];
+          rowy = &vdy_brick[mz][my][nx];
+          rowz = &vdz_brick[mz][my][nx];
           for (l = nlower; l <= nupper; l++) {
-            mx = l+nx;
-            x0 = y0*r1d[0][l];
-            ekx -= x0*vdx_brick[mz][my][mx];
-            eky -= x0*vdy_brick[mz][my][mx];
-            ekz -= x0*vdz_brick[mz][my][mx];
+            x0 = y0*wx[l];
+            ekx -= x0*rowx[l];
+            eky -= x0*rowy[l];
+            ekz -= x0*rowz[l];
           }
         }
       }
@@ -512,7 +547,8 @@ void PPPMOMP::fieldforce_ad()
   // loop over my charges, interpolate electric field from nearby grid points
   // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
   // (dx,dy,dz) = distance to "lower left" grid pt
-  // (mx,my,mz) = global coords of moving stencil pt
+  // (wx,wy,wz) = stencil weights stored by make_rho() in this step
+  // row = x-row of potential brick in the stencil
   // ek = 3 components of E-field on particle
 
   const dbl3_t * _noalias const x = (dbl3_t *) atom->x[0];
@@ -529,14 +565,14 @@ void PPPMOMP::fieldforce_ad()
   {
     double s1,s2,s3,sf;
     FFT_SCALAR ekx,eky,ekz;
-    int i,ifrom,ito,tid,l,m,n,mx,my,mz;
+    const FFT_SCALAR *wx,*wy,*wz,*row;
+    int i,ifrom,ito,tid,l,m,n,my,mz;
 
     loop_setup_thr(ifrom,ito,tid,nlocal,nthreads);
 
     // get per thread data
     ThrData *thr = fix->get_thr(tid);
     dbl3_t * _noalias const f = (dbl3_t *) thr->get_f()[0];
-    FFT_SCALAR * const * const r1d = static_cast<FFT_SCALAR **>(thr->get_rho1d());
     FFT_SCALAR * const * const d1d = static_cast<FFT_SCALAR **>(thr->get_drho1d());
 
     for (i = ifrom; i < ito; ++i) {
@@ -547,19 +583,21 @@ void PPPMOMP::fieldforce_ad()
       const FFT_SCALAR dy = ny+shiftone - (x[i].y-boxloy)*delyinv;
       const FFT_SCALAR dz = nz+shiftone - (x[i].z-boxloz)*delzinv;
 
-      compute_rho1d_thr(r1d,dx,dy,dz);
       compute_drho1d_thr(d1d,dx,dy,dz);
+      wx = rho1d_atom[i] - nlower;
+      wy = wx + order;
+      wz = wy + order;
 
       ekx = eky = ekz = ZEROF;
       for (n = nlower; n <= nupper; n++) {
         mz = n+nz;
         for (m = nlower; m <= nupper; m++) {
           my = m+ny;
+          row = &u_brick[mz][my][nx];
           for (l = nlower; l <= nupper; l++) {
-            mx = l+nx;
-            ekx += d1d[0][l]*r1d[1][m]*r1d[2][n]*u_brick[mz][my][mx];
-            eky += r1d[0][l]*d1d[1][m]*r1d[2][n]*u_brick[mz][my][mx];
-            ekz += r1d[0][l]*r1d[1][m]*d1d[2][n]*u_brick[mz][my][mx];
+            ekx += d1d[0][l]*wy[m]*wz[n]*row[l];
+            eky += wx[l]*d1d[1][m]*wz[n]*row[l];
+            ekz += wx[l]*wy[m]*d1d[2][n]*row[l];
           }
         }
       }
@@ -675,6 +713,18 @@ void PPPMOMP::fieldforce_peratom()
   } // end of parallel region
 }
 
+/* ----------------------------------------------------------------------
+   memory usage of local arrays
+------------------------------------------------------------------------- */
+
+double PPPMOMP::memory_usage()
+{
+  double bytes = PPPM::memory_usage();
+  if (nthr_density > 1)
+    bytes += (double) (nthr_density-1)*ngrid * sizeof(FFT_SCALAR);
+  return bytes;
+}
+
 /* ----------------------------------------------------------------------
    charge assignment into rho1d
    dx,dy,dz = distance of particle from "lower left" grid point
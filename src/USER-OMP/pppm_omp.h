@@ -28,8 +28,9 @@ namespace LAMMPS_NS {
 class PPPMOMP : public PPPM, public ThrOMP {
  public:
   PPPMOMP(class LAMMPS *, int, char **);
-  virtual ~PPPMOMP () {};
+  virtual ~PPPMOMP ();
   virtual void compute(int, int);
+  virtual double memory_usage();
 
  protected:
   virtual void allocate();
@@ -43,6 +44,9 @@ class PPPMOMP : public PPPM, public ThrOMP {
   virtual void fieldforce_ad();
   virtual void fieldforce_peratom();
 
+  FFT_SCALAR *density_thr;     // density bricks of threads 1 to nthreads-1
+  int nthr_density;            // # of threads density_thr is allocated for
+
  private:
   void compute_rho1d_thr(FFT_SCALAR * const * const, const FFT_SCALAR &,
                          const FFT_SCALAR &, const FFT_SCALAR &);
@@ -53,6 +53,7 @@ FixPhaseChange::FixPhaseChange(LAMMPS *lmp, int narg, char **arg) :
 
   restart_global = 1;
   time_depend = 1;
+  ninserted = 0;
 
   // required args
   int m = 3;
@@ -156,6 +157,19 @@ void FixPhaseChange::init()
   neighbor->requests[irequest]->full = 1;
 }
 
+/* ----------------------------------------------------------------------
+   extract # of atoms inserted by this proc, used by fix trace
+------------------------------------------------------------------------- */
+
+void *FixPhaseChange::extract(const char *str, int &dim)
+{
+  dim = 0;
+  if (strcmp(str,"ninserted") == 0) return &ninserted;
+  return NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
 void FixPhaseChange::init_list(int, NeighList *ptr)
 {
   list = ptr;
@@ -336,6 +350,7 @@ void FixPhaseChange::pre_exchange()
   // if global map exists, reset it now instead of waiting for comm
   // since deleting atoms messes up ghosts
   next_reneighbor += nfreq;
+  ninserted += nins;
   int ninsall;
   MPI_Allreduce(&nins,&ninsall,1,MPI_INT,MPI_SUM,world);
   if (ninsall>0) {
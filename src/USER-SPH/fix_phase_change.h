@@ -35,8 +35,10 @@ class FixPhaseChange : public Fix {
   void pre_exchange();
   void write_restart(FILE *);
   void restart(char *);
+  void *extract(const char *, int &);
   
  private:
+  int ninserted;      // # of atoms inserted by this proc since fix was defined
   int from_type,to_type,nfreq,seed;
   int iregion,maxattempt,scaleflag;
   char *idregion;
@@ -88,6 +88,8 @@ FixSetMeso::FixSetMeso(LAMMPS *lmp, int narg, char **arg) :
 
   maxatom = 0;
   smesovar = NULL;
+  maxflag = 0;
+  rflag = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -97,6 +99,7 @@ FixSetMeso::~FixSetMeso()
   delete [] xstr;
   delete [] idregion;
   memory->destroy(smesovar);
+  memory->destroy(rflag);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -205,6 +208,18 @@ void FixSetMeso::post_force(int vflag)
     memory->create(smesovar,maxatom,"setmesode:smesovar");
   }
 
+  // test all atoms against region at once
+
+  if (iregion >= 0) {
+    if (nlocal > maxflag) {
+      maxflag = atom->nmax;
+      memory->destroy(rflag);
+      memory->create(rflag,maxflag,"setmeso:rflag");
+    }
+    domain->regions[iregion]->prematch();
+    domain->regions[iregion]->match_many(x,nlocal,rflag);
+  }
+
   mesovarorg = 0.0;
   force_flag = 0;
 
@@ -212,12 +227,10 @@ void FixSetMeso::post_force(int vflag)
     for (int i = 0; i < nlocal; i++)
       if (mask[i] & groupbit) {
 	if (iregion >= 0) {
-	  if ( (regionflag) && 
-	      !domain->regions[iregion]->match(x[i][0],x[i][1],x[i][2]))
+	  if ( (regionflag) && !rflag[i])
           continue;
 	  /// applay fix outside of the region
-	  if ( (!regionflag) && 
-	      domain->regions[iregion]->match(x[i][0],x[i][1],x[i][2]))
+	  if ( (!regionflag) && rflag[i])
           continue;
 	}
 
@@ -246,9 +259,7 @@ void FixSetMeso::post_force(int vflag)
 
     for (int i = 0; i < nlocal; i++)
       if (mask[i] & groupbit) {
-        if (iregion >= 0 &&
-            !domain->regions[iregion]->match(x[i][0],x[i][1],x[i][2]))
-          continue;
+        if (iregion >= 0 && !rflag[i]) continue;
 
         mesovarorg += mesovar[i];
         if (xstyle == ATOM) {
@@ -327,5 +338,6 @@ double FixSetMeso::memory_usage()
 {
   double bytes = 0.0;
   if (varflag == ATOM) bytes = atom->nmax*3 * sizeof(double);
+  bytes += maxflag * sizeof(int);
   return bytes;
 }
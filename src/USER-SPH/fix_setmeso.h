@@ -52,6 +52,8 @@ class FixSetMeso : public Fix {
 
   int maxatom;
   double *smesovar;
+  int maxflag;                  // region match of each atom
+  int *rflag;
 };
 
 }
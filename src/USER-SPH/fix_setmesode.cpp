@@ -79,6 +79,8 @@ FixSetMesodE::FixSetMesodE(LAMMPS *lmp, int narg, char **arg) :
 
   maxatom = 0;
   sde = NULL;
+  maxflag = 0;
+  rflag = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -88,6 +90,7 @@ FixSetMesodE::~FixSetMesodE()
   delete [] xstr;
   delete [] idregion;
   memory->destroy(sde);
+  memory->destroy(rflag);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -183,15 +186,25 @@ void FixSetMesodE::post_force(int vflag)
     memory->create(sde,maxatom,"setmesode:sde");
   }
 
+  // test all atoms against region at once
+
+  if (iregion >= 0) {
+    if (nlocal > maxflag) {
+      maxflag = atom->nmax;
+      memory->destroy(rflag);
+      memory->create(rflag,maxflag,"setmesode:rflag");
+    }
+    domain->regions[iregion]->prematch();
+    domain->regions[iregion]->match_many(x,nlocal,rflag);
+  }
+
   deoriginal = 0.0;
   force_flag = 0;
 
   if (varflag == CONSTANT) {
     for (int i = 0; i < nlocal; i++)
       if (mask[i] & groupbit) {
-        if (iregion >= 0 &&
-            !domain->regions[iregion]->match(x[i][0],x[i][1],x[i][2]))
-          continue;
+        if (iregion >= 0 && !rflag[i]) continue;
 
         deoriginal += de[i];
         if (xstyle) de[i] = xvalue;
@@ -211,9 +224,7 @@ void FixSetMesodE::post_force(int vflag)
 
     for (int i = 0; i < nlocal; i++)
       if (mask[i] & groupbit) {
-        if (iregion >= 0 &&
-            !domain->regions[iregion]->match(x[i][0],x[i][1],x[i][2]))
-          continue;
+        if (iregion >= 0 && !rflag[i]) continue;
 
         deoriginal += de[i];
         if (xstyle == ATOM) de[i] = sde[i];
@@ -271,5 +282,6 @@ double FixSetMesodE::memory_usage()
 {
   double bytes = 0.0;
   if (varflag == ATOM) bytes = atom->nmax*3 * sizeof(double);
+  bytes += maxflag * sizeof(int);
   return bytes;
 }
@@ -50,6 +50,8 @@ class FixSetMesodE : public Fix {
 
   int maxatom;
   double *sde;
+  int maxflag;                  // region match of each atom
+  int *rflag;
 };
 
 }
@@ -725,9 +725,12 @@ void Atom::deallocate_topology()
 /* ----------------------------------------------------------------------
    unpack n lines from Atom section of data file
    call style-specific routine to parse line
+   allflag = 0: keep only atoms in my sub-domain, all procs see all lines
+   allflag = 1: keep all atoms inside global box, procs see different lines
+     caller must migrate them to owning procs
 ------------------------------------------------------------------------- */
 
-void Atom::data_atoms(int n, char *buf)
+void Atom::data_atoms(int n, char *buf, int allflag)
 {
   int m,xptr,iptr;
   imageint imagedata;
@@ -740,12 +743,14 @@ void Atom::data_atoms(int n, char *buf)
   int nwords = count_words(buf);
   *next = '\n';
 
-  if (nwords != avec->size_data_atom && nwords != avec->size_data_atom + 3)
+  if (nwords != avec->size_data_atom && nwords != avec->size_data_atom + 3) {
+    if (allflag) error->one(FLERR,"Incorrect atom format in data file");
     error->all(FLERR,"Incorrect atom format in data file");
+  }
 
   char **values = new char*[nwords];
 
-  // set bounds for my proc
+  // set bounds for my proc, or global box if allflag
   // if periodic and I am lo/hi proc, adjust bounds by EPSILON
   // insures all data atoms will be owned even with round-off
 
@@ -760,42 +765,66 @@ void Atom::data_atoms(int n, char *buf)
   }
 
   double sublo[3],subhi[3];
-  if (triclinic == 0) {
-    sublo[0] = domain->sublo[0]; subhi[0] = domain->subhi[0];
-    sublo[1] = domain->sublo[1]; subhi[1] = domain->subhi[1];
-    sublo[2] = domain->sublo[2]; subhi[2] = domain->subhi[2];
-  } else {
-    sublo[0] = domain->sublo_lamda[0]; subhi[0] = domain->subhi_lamda[0];
-    sublo[1] = domain->sublo_lamda[1]; subhi[1] = domain->subhi_lamda[1];
-    sublo[2] = domain->sublo_lamda[2]; subhi[2] = domain->subhi_lamda[2];
-  }
-
-  if (comm->layout != LAYOUT_TILED) {
+  if (allflag) {
+    if (triclinic == 0) {
+      sublo[0] = domain->boxlo[0]; subhi[0] = domain->boxhi[0];
+      sublo[1] = domain->boxlo[1]; subhi[1] = domain->boxhi[1];
+      sublo[2] = domain->boxlo[2]; subhi[2] = domain->boxhi[2];
+    } else {
+      sublo[0] = sublo[1] = sublo[2] = 0.0;
+      subhi[0] = subhi[1] = subhi[2] = 1.0;
+    }
     if (domain->xperiodic) {
-      if (comm->myloc[0] == 0) sublo[0] -= epsilon[0];
-      if (comm->myloc[0] == comm->procgrid[0]-1) subhi[0] += epsilon[0];
+      sublo[0] -= epsilon[0];
+      subhi[0] += epsilon[0];
     }
     if (domain->yperiodic) {
-      if (comm->myloc[1] == 0) sublo[1] -= epsilon[1];
-      if (comm->myloc[1] == comm->procgrid[1]-1) subhi[1] += epsilon[1];
+      sublo[1] -= epsilon[1];
+      subhi[1] += epsilon[1];
     }
     if (domain->zperiodic) {
-      if (comm->myloc[2] == 0) sublo[2] -= epsilon[2];
-      if (comm->myloc[2] == comm->procgrid[2]-1) subhi[2] += epsilon[2];
+      sublo[2] -= epsilon[2];
+      subhi[2] += epsilon[2];
     }
 
   } else {
-    if (domain->xperiodic) {
-      if (comm->mysplit[0][0] == 0.0) sublo[0] -= epsilon[0];
-      if (comm->mysplit[0][1] == 1.0) subhi[0] += epsilon[0];
-    }
-    if (domain->yperiodic) {
-      if (comm->mysplit[1][0] == 0.0) sublo[1] -= epsilon[1];
-      if (comm->mysplit[1][1] == 1.0) subhi[1] += epsilon[1];
+    if (triclinic == 0) {
+      sublo[0] = domain->sublo[0]; subhi[0] = domain->subhi[0];
+      sublo[1] = domain->sublo[1]; subhi[1] = domain->subhi[1];
+      sublo[2] = domain->sublo[2]; subhi[2] = domain->subhi[2];
+    } else {
+      sublo[0] = domain->sublo_lamda[0]; subhi[0] = domain->subhi_lamda[0];
+      sublo[1] = domain->sublo_lamda[1]; subhi[1] = domain->subhi_lamda[1];
+      sublo[2] = domain->sublo_lamda[2]; subhi[2] = domain->subhi_lamda[2];
     }
-    if (domain->zperiodic) {
-      if (comm->mysplit[2][0] == 0.0) sublo[2] -= epsilon[2];
-      if (comm->mysplit[2][1] == 1.0) subhi[2] += epsilon[2];
+
+    if (comm->layout != LAYOUT_TILED) {
+      if (domain->xperiodic) {
+        if (comm->myloc[0] == 0) sublo[0] -= epsilon[0];
+        if (comm->myloc[0] == comm->procgrid[0]-1) subhi[0] += epsilon[0];
+      }
+      if (domain->yperiodic) {
+        if (comm->myloc[1] == 0) sublo[1] -= epsilon[1];
+        if (comm->myloc[1] == comm->procgrid[1]-1) subhi[1] += epsilon[1];
+      }
+      if (domain->zperiodic) {
+        if (comm->myloc[2] == 0) sublo[2] -= epsilon[2];
+        if (comm->myloc[2] == comm->procgrid[2]-1) subhi[2] += epsilon[2];
+      }
+
+    } else {
+      if (domain->xperiodic) {
+        if (comm->mysplit[0][0] == 0.0) sublo[0] -= epsilon[0];
+        if (comm->mysplit[0][1] == 1.0) subhi[0] += epsilon[0];
+      }
+      if (domain->yperiodic) {
+        if (comm->mysplit[1][0] == 0.0) sublo[1] -= epsilon[1];
+        if (comm->mysplit[1][1] == 1.0) subhi[1] += epsilon[1];
+      }
+      if (domain->zperiodic) {
+        if (comm->mysplit[2][0] == 0.0) sublo[2] -= epsilon[2];
+        if (comm->mysplit[2][1] == 1.0) subhi[2] += epsilon[2];
+      }
     }
   }
 
@@ -817,12 +846,16 @@ void Atom::data_atoms(int n, char *buf)
     next = strchr(buf,'\n');
 
     values[0] = strtok(buf," \t\n\r\f");
-    if (values[0] == NULL)
+    if (values[0] == NULL) {
+      if (allflag) error->one(FLERR,"Incorrect atom format in data file");
       error->all(FLERR,"Incorrect atom format in data file");
+    }
     for (m = 1; m < nwords; m++) {
       values[m] = strtok(NULL," \t\n\r\f");
-      if (values[m] == NULL)
+      if (values[m] == NULL) {
+        if (allflag) error->one(FLERR,"Incorrect atom format in data file");
         error->all(FLERR,"Incorrect atom format in data file");
+      }
     }
 
     if (imageflag)
@@ -1955,11 +1988,85 @@ void *Atom::extract(char *name)
   if (strcmp(name,"e") == 0) return (void *) e;
   if (strcmp(name,"de") == 0) return (void *) de;
   if (strcmp(name,"cv") == 0) return (void *) cv;
+  if (strcmp(name,"colorgradient") == 0) return (void *) colorgradient;
   if (strcmp(name,"vest") == 0) return (void *) vest;
 
   return NULL;
 }
 
+/* ----------------------------------------------------------------------
+   extract a per-atom quantity as one contiguous block of values
+   return pointer to 1st value of 1st atom, no copy is made
+   type = 0 for int, 1 for double, 2 for 64-bit int values
+   count = # of values per atom, stride between consecutive atoms
+   first nlocal atoms are owned, pointer is invalid after atoms
+     are added, deleted, sorted, or migrated
+   return NULL if name is not recognized or not allocated
+------------------------------------------------------------------------- */
+
+void *Atom::extract_local(char *name, int &type, int &count)
+{
+  int itype = sizeof(imageint) == sizeof(int) ? 0 : 2;
+  int ttype = sizeof(tagint) == sizeof(int) ? 0 : 2;
+
+  type = 1;
+  count = 1;
+
+  if (strcmp(name,"id") == 0) { type = ttype; return (void *) tag; }
+  if (strcmp(name,"type") == 0) { type = 0; return (void *) this->type; }
+  if (strcmp(name,"mask") == 0) { type = 0; return (void *) mask; }
+  if (strcmp(name,"image") == 0) { type = itype; return (void *) image; }
+  if (strcmp(name,"molecule") == 0) { type = ttype; return (void *) molecule; }
+  if (strcmp(name,"ellipsoid") == 0) { type = 0; return (void *) ellipsoid; }
+  if (strcmp(name,"line") == 0) { type = 0; return (void *) line; }
+  if (strcmp(name,"tri") == 0) { type = 0; return (void *) tri; }
+  if (strcmp(name,"spin") == 0) { type = 0; return (void *) spin; }
+  if (strcmp(name,"etag") == 0) { type = 0; return (void *) etag; }
+
+  if (strcmp(name,"q") == 0) return (void *) q;
+  if (strcmp(name,"radius") == 0) return (void *) radius;
+  if (strcmp(name,"rmass") == 0) return (void *) rmass;
+  if (strcmp(name,"vfrac") == 0) return (void *) vfrac;
+  if (strcmp(name,"s0") == 0) return (void *) s0;
+  if (strcmp(name,"eradius") == 0) return (void *) eradius;
+  if (strcmp(name,"ervel") == 0) return (void *) ervel;
+  if (strcmp(name,"erforce") == 0) return (void *) erforce;
+  if (strcmp(name,"ervelforce") == 0) return (void *) ervelforce;
+  if (strcmp(name,"rho") == 0) return (void *) rho;
+  if (strcmp(name,"drho") == 0) return (void *) drho;
+  if (strcmp(name,"e") == 0) return (void *) e;
+  if (strcmp(name,"de") == 0) return (void *) de;
+  if (strcmp(name,"cv") == 0) return (void *) cv;
+
+  // flat per-atom vectors with multiple values per atom
+
+  count = 2;
+  if (strcmp(name,"cs") == 0) return (void *) cs;
+  if (strcmp(name,"csforce") == 0) return (void *) csforce;
+  count = 3;
+  if (strcmp(name,"vforce") == 0) return (void *) vforce;
+
+  // 2d arrays are allocated contiguously by Memory::grow()
+
+  double **array = NULL;
+  if (strcmp(name,"x") == 0) array = x;
+  else if (strcmp(name,"v") == 0) array = v;
+  else if (strcmp(name,"f") == 0) array = f;
+  else if (strcmp(name,"omega") == 0) array = omega;
+  else if (strcmp(name,"angmom") == 0) array = angmom;
+  else if (strcmp(name,"torque") == 0) array = torque;
+  else if (strcmp(name,"x0") == 0) array = x0;
+  else if (strcmp(name,"colorgradient") == 0) array = colorgradient;
+  else if (strcmp(name,"vest") == 0) array = vest;
+  else if (strcmp(name,"mu") == 0) {
+    array = mu;
+    count = 4;
+  } else return NULL;
+
+  if (array == NULL) return NULL;
+  return (void *) &array[0][0];
+}
+
 /* ----------------------------------------------------------------------
    return # of bytes of allocated memory
    call to avec tallies per-atom vectors
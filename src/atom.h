@@ -189,7 +189,7 @@ class Atom : protected Pointers {
 
   void deallocate_topology();
 
-  void data_atoms(int, char *);
+  void data_atoms(int, char *, int allflag = 0);
   void data_vels(int, char *);
 
   void data_bonds(int, char *, int *);
@@ -228,6 +228,7 @@ class Atom : protected Pointers {
   virtual void sync_modify(ExecutionSpace, unsigned int, unsigned int) {}
 
   void *extract(char *);
+  void *extract_local(char *, int &, int &);
 
   inline int* get_map_array() {return map_array;};
   inline int get_map_size() {return map_tag_max+1;};
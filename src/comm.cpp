@@ -28,6 +28,7 @@
 #include "dump.h"
 #include "group.h"
 #include "procmap.h"
+#include "timer.h"
 #include "accelerator_kokkos.h"
 #include "memory.h"
 #include "error.h"
@@ -56,6 +57,14 @@ Comm::Comm(LAMMPS *lmp) : Pointers(lmp)
   bordergroup = 0;
   cutghostuser = 0.0;
   ghost_velocity = 0;
+  wait_flag = 0;
+  wait_time = 0.0;
+
+  // timer regions are created in init(), -1 = not timed until then
+
+  region_forward = region_reverse = region_exchange = region_borders = -1;
+  region_forward_pair = region_reverse_pair = -1;
+  region_forward_fix = region_reverse_fix = -1;
 
   user_procgrid[0] = user_procgrid[1] = user_procgrid[2] = 0;
   coregrid[0] = coregrid[1] = coregrid[2] = 1;
@@ -161,6 +170,15 @@ void Comm::init()
   triclinic = domain->triclinic;
   map_style = atom->map_style;
 
+  region_forward = timer->region_create("forward_comm");
+  region_reverse = timer->region_create("reverse_comm");
+  region_exchange = timer->region_create("exchange");
+  region_borders = timer->region_create("borders");
+  region_forward_pair = timer->region_create("forward_comm_pair");
+  region_reverse_pair = timer->region_create("reverse_comm_pair");
+  region_forward_fix = timer->region_create("forward_comm_fix");
+  region_reverse_fix = timer->region_create("reverse_comm_fix");
+
   // warn if any proc's sub-box is smaller than neigh skin
   // since may lead to lost atoms in exchange()
   // really should check every exchange() in case box size is shrinking
@@ -208,6 +226,12 @@ void Comm::init()
 
   for (int i = 0; i < modify->nfix; i++)
     size_border += modify->fix[i]->comm_border;
+
+  // tally time in MPI_Wait() only while a fix trace records it
+
+  wait_flag = 0;
+  for (int i = 0; i < modify->nfix; i++)
+    if (strcmp(modify->fix[i]->style,"trace") == 0) wait_flag = 1;
   
   // per-atom limits for communication
   // maxexchange = max # of datums in exchange comm, set in exchange()
@@ -38,6 +38,8 @@ class Comm : protected Pointers {
   int maxexchange_atom;             // max contribution to exchange from AtomVec
   int maxexchange_fix;              // max contribution to exchange from Fixes
   int nthreads;                     // OpenMP threads per MPI process
+  int wait_flag;                    // 1 if time in MPI_Wait() is tallied
+  double wait_time;                 // time spent in MPI_Wait() by comm
 
   // public settings specific to layout = UNIFORM, NONUNIFORM
 
@@ -98,6 +100,18 @@ class Comm : protected Pointers {
   int read_lines_from_file(FILE *, int, int, char *);  
   int read_lines_from_file_universe(FILE *, int, int, char *);  
 
+  // MPI_Wait() for a swap, tallies time waiting for the other proc
+
+  void wait(MPI_Request *request, MPI_Status *status) {
+    if (!wait_flag) {
+      MPI_Wait(request,status);
+      return;
+    }
+    double start = MPI_Wtime();
+    MPI_Wait(request,status);
+    wait_time += MPI_Wtime() - start;
+  }
+
  protected:
   int mode;                  // 0 = single cutoff, 1 = multi-type cutoff
   int bordergroup;           // only communicate this group in borders
@@ -113,6 +127,11 @@ class Comm : protected Pointers {
   int maxforward,maxreverse;        // max # of datums in forward/reverse comm
   int maxexchange;                  // max # of datums/atom in exchange comm 
 
+  int region_forward,region_reverse;          // timer regions for profiling
+  int region_exchange,region_borders;
+  int region_forward_pair,region_reverse_pair;
+  int region_forward_fix,region_reverse_fix;
+
   int gridflag;                     // option for creating 3d grid
   int mapflag;                      // option for mapping procs to 3d grid
   char xyz[4];                      // xyz mapping of procs to 3d grid
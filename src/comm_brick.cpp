@@ -37,6 +37,7 @@
 #include "output.h"
 #include "dump.h"
 #include "math_extra.h"
+#include "timer.h"
 #include "error.h"
 #include "memory.h"
 
@@ -443,6 +444,8 @@ int CommBrick::updown(int dim, int dir, int loc,
 
 void CommBrick::forward_comm(int dummy)
 {
+  timer->region_start(region_forward);
+
   int n;
   MPI_Request request;
   MPI_Status status;
@@ -466,7 +469,7 @@ void CommBrick::forward_comm(int dummy)
         n = avec->pack_comm(sendnum[iswap],sendlist[iswap],
                             buf_send,pbc_flag[iswap],pbc[iswap]);
         if (n) MPI_Send(buf_send,n,MPI_DOUBLE,sendproc[iswap],0,world);
-        if (size_forward_recv[iswap]) MPI_Wait(&request,&status);
+        if (size_forward_recv[iswap]) wait(&request,&status);
       } else if (ghost_velocity) {
         if (size_forward_recv[iswap])
           MPI_Irecv(buf_recv,size_forward_recv[iswap],MPI_DOUBLE,
@@ -474,7 +477,7 @@ void CommBrick::forward_comm(int dummy)
         n = avec->pack_comm_vel(sendnum[iswap],sendlist[iswap],
                                 buf_send,pbc_flag[iswap],pbc[iswap]);
         if (n) MPI_Send(buf_send,n,MPI_DOUBLE,sendproc[iswap],0,world);
-        if (size_forward_recv[iswap]) MPI_Wait(&request,&status);
+        if (size_forward_recv[iswap]) wait(&request,&status);
         avec->unpack_comm_vel(recvnum[iswap],firstrecv[iswap],buf_recv);
       } else {
         if (size_forward_recv[iswap])
@@ -483,7 +486,7 @@ void CommBrick::forward_comm(int dummy)
         n = avec->pack_comm(sendnum[iswap],sendlist[iswap],
                             buf_send,pbc_flag[iswap],pbc[iswap]);
         if (n) MPI_Send(buf_send,n,MPI_DOUBLE,sendproc[iswap],0,world);
-        if (size_forward_recv[iswap]) MPI_Wait(&request,&status);
+        if (size_forward_recv[iswap]) wait(&request,&status);
         avec->unpack_comm(recvnum[iswap],firstrecv[iswap],buf_recv);
       }
 
@@ -503,6 +506,8 @@ void CommBrick::forward_comm(int dummy)
       }
     }
   }
+
+  timer->region_stop(region_forward);
 }
 
 /* ----------------------------------------------------------------------
@@ -512,6 +517,8 @@ void CommBrick::forward_comm(int dummy)
 
 void CommBrick::reverse_comm()
 {
+  timer->region_start(region_reverse);
+
   int n;
   MPI_Request request;
   MPI_Status status;
@@ -535,14 +542,14 @@ void CommBrick::reverse_comm()
           MPI_Send(buf,size_reverse_send[iswap],MPI_DOUBLE,
                    recvproc[iswap],0,world);
         }
-        if (size_reverse_recv[iswap]) MPI_Wait(&request,&status);
+        if (size_reverse_recv[iswap]) wait(&request,&status);
       } else {
         if (size_reverse_recv[iswap])
           MPI_Irecv(buf_recv,size_reverse_recv[iswap],MPI_DOUBLE,
                     sendproc[iswap],0,world,&request);
         n = avec->pack_reverse(recvnum[iswap],firstrecv[iswap],buf_send);
         if (n) MPI_Send(buf_send,n,MPI_DOUBLE,recvproc[iswap],0,world);
-        if (size_reverse_recv[iswap]) MPI_Wait(&request,&status);
+        if (size_reverse_recv[iswap]) wait(&request,&status);
       }
       avec->unpack_reverse(sendnum[iswap],sendlist[iswap],buf_recv);
 
@@ -557,6 +564,8 @@ void CommBrick::reverse_comm()
       }
     }
   }
+
+  timer->region_stop(region_reverse);
 }
 
 /* ----------------------------------------------------------------------
@@ -572,6 +581,8 @@ void CommBrick::reverse_comm()
 
 void CommBrick::exchange()
 {
+  timer->region_start(region_exchange);
+
   int i,m,nsend,nrecv,nrecv1,nrecv2,nlocal;
   double lo,hi,value;
   double **x;
@@ -657,13 +668,13 @@ void CommBrick::exchange()
       MPI_Irecv(buf_recv,nrecv1,MPI_DOUBLE,procneigh[dim][1],0,
                 world,&request);
       MPI_Send(buf_send,nsend,MPI_DOUBLE,procneigh[dim][0],0,world);
-      MPI_Wait(&request,&status);
+      wait(&request,&status);
 
       if (procgrid[dim] > 2) {
         MPI_Irecv(&buf_recv[nrecv1],nrecv2,MPI_DOUBLE,procneigh[dim][0],0,
                   world,&request);
         MPI_Send(buf_send,nsend,MPI_DOUBLE,procneigh[dim][1],0,world);
-        MPI_Wait(&request,&status);
+        wait(&request,&status);
       }
     }
 
@@ -681,6 +692,8 @@ void CommBrick::exchange()
   }
 
   if (atom->firstgroupname) atom->first_reorder();
+
+  timer->region_stop(region_exchange);
 }
 
 /* ----------------------------------------------------------------------
@@ -695,6 +708,8 @@ void CommBrick::exchange()
 
 void CommBrick::borders()
 {
+  timer->region_start(region_borders);
+
   int i,n,itype,iswap,dim,ineed,twoneed;
   int nsend,nrecv,sendflag,nfirst,nlast,ngroup;
   double lo,hi;
@@ -822,7 +837,7 @@ void CommBrick::borders()
         if (nrecv) MPI_Irecv(buf_recv,nrecv*size_border,MPI_DOUBLE,
                              recvproc[iswap],0,world,&request);
         if (n) MPI_Send(buf_send,n,MPI_DOUBLE,sendproc[iswap],0,world);
-        if (nrecv) MPI_Wait(&request,&status);
+        if (nrecv) wait(&request,&status);
         buf = buf_recv;
       } else {
         nrecv = nsend;
@@ -861,6 +876,8 @@ void CommBrick::borders()
   // reset global->local map
 
   if (map_style) atom->map_set();
+
+  timer->region_stop(region_borders);
 }
 
 /* ----------------------------------------------------------------------
@@ -870,6 +887,8 @@ void CommBrick::borders()
 
 void CommBrick::forward_comm_pair(Pair *pair)
 {
+  timer->region_start(region_forward_pair);
+
   int iswap,n;
   double *buf;
   MPI_Request request;
@@ -893,7 +912,7 @@ void CommBrick::forward_comm_pair(Pair *pair)
                   recvproc[iswap],0,world,&request);
       if (sendnum[iswap])
         MPI_Send(buf_send,n,MPI_DOUBLE,sendproc[iswap],0,world);
-      if (recvnum[iswap]) MPI_Wait(&request,&status);
+      if (recvnum[iswap]) wait(&request,&status);
       buf = buf_recv;
     } else buf = buf_send;
 
@@ -901,6 +920,8 @@ void CommBrick::forward_comm_pair(Pair *pair)
 
     pair->unpack_forward_comm(recvnum[iswap],firstrecv[iswap],buf);
   }
+
+  timer->region_stop(region_forward_pair);
 }
 
 /* ----------------------------------------------------------------------
@@ -910,6 +931,8 @@ void CommBrick::forward_comm_pair(Pair *pair)
 
 void CommBrick::reverse_comm_pair(Pair *pair)
 {
+  timer->region_start(region_reverse_pair);
+
   int iswap,n;
   double *buf;
   MPI_Request request;
@@ -932,7 +955,7 @@ void CommBrick::reverse_comm_pair(Pair *pair)
                   world,&request);
       if (recvnum[iswap])
         MPI_Send(buf_send,n,MPI_DOUBLE,recvproc[iswap],0,world);
-      if (sendnum[iswap]) MPI_Wait(&request,&status);
+      if (sendnum[iswap]) wait(&request,&status);
       buf = buf_recv;
     } else buf = buf_send;
 
@@ -940,6 +963,8 @@ void CommBrick::reverse_comm_pair(Pair *pair)
 
     pair->unpack_reverse_comm(sendnum[iswap],sendlist[iswap],buf);
   }
+
+  timer->region_stop(region_reverse_pair);
 }
 
 /* ----------------------------------------------------------------------
@@ -953,6 +978,8 @@ void CommBrick::reverse_comm_pair(Pair *pair)
 
 void CommBrick::forward_comm_fix(Fix *fix, int size)
 {
+  timer->region_start(region_forward_fix);
+
   int iswap,n,nsize;
   double *buf;
   MPI_Request request;
@@ -977,7 +1004,7 @@ void CommBrick::forward_comm_fix(Fix *fix, int size)
                   world,&request);
       if (sendnum[iswap])
         MPI_Send(buf_send,n,MPI_DOUBLE,sendproc[iswap],0,world);
-      if (recvnum[iswap]) MPI_Wait(&request,&status);
+      if (recvnum[iswap]) wait(&request,&status);
       buf = buf_recv;
     } else buf = buf_send;
 
@@ -985,6 +1012,8 @@ void CommBrick::forward_comm_fix(Fix *fix, int size)
 
     fix->unpack_forward_comm(recvnum[iswap],firstrecv[iswap],buf);
   }
+
+  timer->region_stop(region_forward_fix);
 }
 
 /* ----------------------------------------------------------------------
@@ -998,6 +1027,8 @@ void CommBrick::forward_comm_fix(Fix *fix, int size)
 
 void CommBrick::reverse_comm_fix(Fix *fix, int size)
 {
+  timer->region_start(region_reverse_fix);
+
   int iswap,n,nsize;
   double *buf;
   MPI_Request request;
@@ -1021,7 +1052,7 @@ void CommBrick::reverse_comm_fix(Fix *fix, int size)
                   world,&request);
       if (recvnum[iswap])
         MPI_Send(buf_send,n,MPI_DOUBLE,recvproc[iswap],0,world);
-      if (sendnum[iswap]) MPI_Wait(&request,&status);
+      if (sendnum[iswap]) wait(&request,&status);
       buf = buf_recv;
     } else buf = buf_send;
     
@@ -1029,6 +1060,8 @@ void CommBrick::reverse_comm_fix(Fix *fix, int size)
 
     fix->unpack_reverse_comm(sendnum[iswap],sendlist[iswap],buf);
   }
+
+  timer->region_stop(region_reverse_fix);
 }
 
 /* ----------------------------------------------------------------------
@@ -1061,7 +1094,7 @@ void CommBrick::forward_comm_compute(Compute *compute)
                   world,&request);
       if (sendnum[iswap])
         MPI_Send(buf_send,n,MPI_DOUBLE,sendproc[iswap],0,world);
-      if (recvnum[iswap]) MPI_Wait(&request,&status);
+      if (recvnum[iswap]) wait(&request,&status);
       buf = buf_recv;
     } else buf = buf_send;
 
@@ -1100,7 +1133,7 @@ void CommBrick::reverse_comm_compute(Compute *compute)
                   world,&request);
       if (recvnum[iswap])
         MPI_Send(buf_send,n,MPI_DOUBLE,recvproc[iswap],0,world);
-      if (sendnum[iswap]) MPI_Wait(&request,&status);
+      if (sendnum[iswap]) wait(&request,&status);
       buf = buf_recv;
     } else buf = buf_send;
 
@@ -1140,7 +1173,7 @@ void CommBrick::forward_comm_dump(Dump *dump)
                   world,&request);
       if (sendnum[iswap])
         MPI_Send(buf_send,n,MPI_DOUBLE,sendproc[iswap],0,world);
-      if (recvnum[iswap]) MPI_Wait(&request,&status);
+      if (recvnum[iswap]) wait(&request,&status);
       buf = buf_recv;
     } else buf = buf_send;
 
@@ -1179,7 +1212,7 @@ void CommBrick::reverse_comm_dump(Dump *dump)
                   world,&request);
       if (recvnum[iswap])
         MPI_Send(buf_send,n,MPI_DOUBLE,recvproc[iswap],0,world);
-      if (sendnum[iswap]) MPI_Wait(&request,&status);
+      if (sendnum[iswap]) wait(&request,&status);
       buf = buf_recv;
     } else buf = buf_send;
 
@@ -1230,7 +1263,7 @@ void CommBrick::forward_comm_array(int nsize, double **array)
       if (sendnum[iswap])
         MPI_Send(buf_send,nsize*sendnum[iswap],MPI_DOUBLE,
                  sendproc[iswap],0,world);
-      if (recvnum[iswap]) MPI_Wait(&request,&status);
+      if (recvnum[iswap]) wait(&request,&status);
       buf = buf_recv;
     } else buf = buf_send;
 
@@ -1285,13 +1318,13 @@ int CommBrick::exchange_variable(int n, double *inbuf, double *&outbuf)
     MPI_Irecv(&buf_recv[nsend],nrecv1,MPI_DOUBLE,procneigh[dim][1],0,
               world,&request);
     MPI_Send(buf_recv,nsend,MPI_DOUBLE,procneigh[dim][0],0,world);
-    MPI_Wait(&request,&status);
+    wait(&request,&status);
     
     if (procgrid[dim] > 2) {
       MPI_Irecv(&buf_recv[nsend+nrecv1],nrecv2,MPI_DOUBLE,procneigh[dim][0],0,
                 world,&request);
       MPI_Send(buf_recv,nsend,MPI_DOUBLE,procneigh[dim][1],0,world);
-      MPI_Wait(&request,&status);
+      wait(&request,&status);
     }
   }
 
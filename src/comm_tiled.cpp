@@ -26,6 +26,7 @@
 #include "compute.h"
 #include "output.h"
 #include "dump.h"
+#include "timer.h"
 #include "memory.h"
 #include "error.h"
 
@@ -438,6 +439,8 @@ void CommTiled::setup()
 
 void CommTiled::forward_comm(int dummy)
 {
+  timer->region_start(region_forward);
+
   int i,irecv,n,nsend,nrecv;
   MPI_Status status;
   AtomVec *avec = atom->avec;
@@ -533,6 +536,8 @@ void CommTiled::forward_comm(int dummy)
       }
     }
   }
+
+  timer->region_stop(region_forward);
 }
 
 /* ----------------------------------------------------------------------
@@ -542,6 +547,8 @@ void CommTiled::forward_comm(int dummy)
 
 void CommTiled::reverse_comm()
 {
+  timer->region_start(region_reverse);
+
   int i,irecv,n,nsend,nrecv;
   MPI_Status status;
   AtomVec *avec = atom->avec;
@@ -614,6 +621,8 @@ void CommTiled::reverse_comm()
       }
     }
   }
+
+  timer->region_stop(region_reverse);
 }
 
 /* ----------------------------------------------------------------------
@@ -634,6 +643,8 @@ void CommTiled::exchange()
   double **x;
   AtomVec *avec = atom->avec;
 
+  timer->region_start(region_exchange);
+
   // clear global->local map for owned and ghost atoms
   // b/c atoms migrate to new procs in exchange() and
   //   new ghosts are created in borders()
@@ -761,6 +772,8 @@ void CommTiled::exchange()
   }
 
   if (atom->firstgroupname) atom->first_reorder();
+
+  timer->region_stop(region_exchange);
 }
 
 /* ----------------------------------------------------------------------
@@ -781,6 +794,8 @@ void CommTiled::borders()
   double **x;
   AtomVec *avec = atom->avec;
 
+  timer->region_start(region_borders);
+
   // send/recv max one = max # of atoms in single send/recv for any swap
   // send/recv max all = max # of atoms in all sends/recvs within any swap
 
@@ -976,6 +991,8 @@ void CommTiled::borders()
   // reset global->local map
 
   if (map_style) atom->map_set();
+
+  timer->region_stop(region_borders);
 }
 
 /* ----------------------------------------------------------------------
@@ -985,6 +1002,8 @@ void CommTiled::borders()
 
 void CommTiled::forward_comm_pair(Pair *pair)
 {
+  timer->region_start(region_forward_pair);
+
   int i,irecv,n,nsend,nrecv;
   MPI_Status status;
 
@@ -1023,6 +1042,8 @@ void CommTiled::forward_comm_pair(Pair *pair)
       }
     }
   }
+
+  timer->region_stop(region_forward_pair);
 }
 
 /* ----------------------------------------------------------------------
@@ -1032,6 +1053,8 @@ void CommTiled::forward_comm_pair(Pair *pair)
 
 void CommTiled::reverse_comm_pair(Pair *pair)
 {
+  timer->region_start(region_reverse_pair);
+
   int i,irecv,n,nsend,nrecv;
   MPI_Status status;
 
@@ -1069,6 +1092,8 @@ void CommTiled::reverse_comm_pair(Pair *pair)
       }
     }
   }
+
+  timer->region_stop(region_reverse_pair);
 }
 
 /* ----------------------------------------------------------------------
@@ -1082,6 +1107,8 @@ void CommTiled::reverse_comm_pair(Pair *pair)
 
 void CommTiled::forward_comm_fix(Fix *fix, int size)
 {
+  timer->region_start(region_forward_fix);
+
   int i,irecv,n,nsize,nsend,nrecv;
   MPI_Status status;
 
@@ -1121,6 +1148,8 @@ void CommTiled::forward_comm_fix(Fix *fix, int size)
       }
     }
   }
+
+  timer->region_stop(region_forward_fix);
 }
 
 /* ----------------------------------------------------------------------
@@ -1134,6 +1163,8 @@ void CommTiled::forward_comm_fix(Fix *fix, int size)
 
 void CommTiled::reverse_comm_fix(Fix *fix, int size)
 {
+  timer->region_start(region_reverse_fix);
+
   int i,irecv,n,nsize,nsend,nrecv;
   MPI_Status status;
 
@@ -1172,6 +1203,8 @@ void CommTiled::reverse_comm_fix(Fix *fix, int size)
       }
     }
   }
+
+  timer->region_stop(region_reverse_fix);
 }
 
 /* ----------------------------------------------------------------------
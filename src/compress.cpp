@@ -0,0 +1,182 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "string.h"
+#include "compress.h"
+#include "error.h"
+
+#ifdef LAMMPS_ZLIB
+#include "zlib.h"
+#endif
+
+#ifdef LAMMPS_ZSTD
+#include "zstd.h"
+#endif
+
+using namespace LAMMPS_NS;
+
+#define GZIP_LEVEL 6        // same as "gzip -6" used for piped output
+#define ZSTD_LEVEL 3        // zstd default level
+
+/* ----------------------------------------------------------------------
+   compress and decompress independent chunks of bytes in memory
+   each GZIP chunk is a complete gzip member, so a file of concatenated
+     chunks is a valid gzip file, same for ZSTD chunks which are frames
+------------------------------------------------------------------------- */
+
+Compress::Compress(LAMMPS *lmp, int which) : Pointers(lmp)
+{
+  codec = which;
+  if (!available(codec))
+    error->all(FLERR,"Compression codec is not available "
+               "in this LAMMPS executable");
+}
+
+/* ----------------------------------------------------------------------
+   return codec for a codec name, -1 if not recognized
+------------------------------------------------------------------------- */
+
+int Compress::find(const char *name)
+{
+  if (strcmp(name,"none") == 0) return NONE;
+  if (strcmp(name,"zlib") == 0) return GZIP;
+  if (strcmp(name,"zstd") == 0) return ZSTD;
+  return -1;
+}
+
+/* ----------------------------------------------------------------------
+   return codec implied by a file name suffix, NONE if not compressed
+------------------------------------------------------------------------- */
+
+int Compress::suffix(const char *file)
+{
+  int n = strlen(file);
+  if (n > 3 && strcmp(&file[n-3],".gz") == 0) return GZIP;
+  if (n > 4 && strcmp(&file[n-4],".zst") == 0) return ZSTD;
+  return NONE;
+}
+
+/* ----------------------------------------------------------------------
+   return 1 if codec was compiled into this executable, else 0
+------------------------------------------------------------------------- */
+
+int Compress::available(int which)
+{
+  if (which == NONE) return 1;
+#ifdef LAMMPS_ZLIB
+  if (which == GZIP) return 1;
+#endif
+#ifdef LAMMPS_ZSTD
+  if (which == ZSTD) return 1;
+#endif
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   return max # of bytes that N bytes can compress to
+------------------------------------------------------------------------- */
+
+int Compress::bound(int n)
+{
+  bigint nbound = n;
+
+#ifdef LAMMPS_ZLIB
+  // compressBound() is for a zlib wrapper, gzip header+trailer is larger
+
+  if (codec == GZIP) nbound = (bigint) compressBound(n) + 18;
+#endif
+#ifdef LAMMPS_ZSTD
+  if (codec == ZSTD) nbound = ZSTD_compressBound(n);
+#endif
+
+  if (nbound > MAXSMALLINT)
+    error->one(FLERR,"Too much data to compress in one chunk");
+  return static_cast<int> (nbound);
+}
+
+/* ----------------------------------------------------------------------
+   compress N bytes of in into out which can hold maxout bytes
+   return # of compressed bytes
+------------------------------------------------------------------------- */
+
+int Compress::compress(const char *in, int n, char *out, int maxout)
+{
+  int nout = -1;
+
+#ifdef LAMMPS_ZLIB
+  if (codec == GZIP) {
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    if (deflateInit2(&strm,GZIP_LEVEL,Z_DEFLATED,15+16,8,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+      error->one(FLERR,"Compression of output chunk failed");
+    strm.next_in = (Bytef *) in;
+    strm.avail_in = n;
+    strm.next_out = (Bytef *) out;
+    strm.avail_out = maxout;
+    if (deflate(&strm,Z_FINISH) == Z_STREAM_END) nout = strm.total_out;
+    deflateEnd(&strm);
+  }
+#endif
+
+#ifdef LAMMPS_ZSTD
+  if (codec == ZSTD) {
+    size_t nz = ZSTD_compress(out,maxout,in,n,ZSTD_LEVEL);
+    if (!ZSTD_isError(nz)) nout = static_cast<int> (nz);
+  }
+#endif
+
+  if (nout < 0) error->one(FLERR,"Compression of output chunk failed");
+  return nout;
+}
+
+/* ----------------------------------------------------------------------
+   decompress N bytes of in into out
+   nout = # of bytes the chunk was compressed from, error if different
+   return nout
+------------------------------------------------------------------------- */
+
+int Compress::decompress(const char *in, int n, char *out, int nout)
+{
+  int flag = 0;
+
+#ifdef LAMMPS_ZLIB
+  if (codec == GZIP) {
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    strm.next_in = (Bytef *) in;
+    strm.avail_in = n;
+    if (inflateInit2(&strm,15+16) != Z_OK)
+      error->one(FLERR,"Decompression of input chunk failed");
+    strm.next_out = (Bytef *) out;
+    strm.avail_out = nout;
+    if (inflate(&strm,Z_FINISH) == Z_STREAM_END && strm.total_out == nout)
+      flag = 1;
+    inflateEnd(&strm);
+  }
+#endif
+
+#ifdef LAMMPS_ZSTD
+  if (codec == ZSTD) {
+    size_t nz = ZSTD_decompress(out,nout,in,n);
+    if (!ZSTD_isError(nz) && nz == (size_t) nout) flag = 1;
+  }
+#endif
+
+  if (!flag) error->one(FLERR,"Decompression of input chunk failed");
+  return nout;
+}
@@ -0,0 +1,64 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifndef LMP_COMPRESS_H
+#define LMP_COMPRESS_H
+
+#include "pointers.h"
+
+namespace LAMMPS_NS {
+
+class Compress : protected Pointers {
+ public:
+  enum{NONE,GZIP,ZSTD};
+
+  int codec;                     // which compression library is used
+
+  Compress(class LAMMPS *, int);
+  ~Compress() {}
+
+  static int find(const char *);
+  static int suffix(const char *);
+  static int available(int);
+
+  int bound(int);
+  int compress(const char *, int, char *, int);
+  int decompress(const char *, int, char *, int);
+};
+
+}
+
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Compression codec is not available in this LAMMPS executable
+
+The zlib codec requires LAMMPS to be compiled with -DLAMMPS_ZLIB and
+the zstd codec requires -DLAMMPS_ZSTD.  See Section_start 2.2.
+
+E: Too much data to compress in one chunk
+
+The compressed size of a per-processor chunk of output must fit in a
+32-bit integer.
+
+E: Compression of output chunk failed
+
+The compression library returned an error.
+
+E: Decompression of input chunk failed
+
+The compressed data is corrupted or does not decompress to the size
+that was stored with it.
+
+*/
@@ -69,6 +69,7 @@ Compute::Compute(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
   tempbias = 0;
 
   timeflag = 0;
+  reduceflag = 0;
   comm_forward = comm_reverse = 0;
   dynamic_group_allow = 1;
   cudable = 0;
@@ -74,6 +74,10 @@ class Compute : protected Pointers {
 
   double dof;         // degrees-of-freedom for temperature
 
+  int reduceflag;     // 1 if global sums of compute_scalar() or compute_vector()
+                      //   can be batched with other computes,
+                      //   see Modify::reduce_computes()
+
   int comm_forward;         // size of forward communication (0 if none)
   int comm_reverse;         // size of reverse communication (0 if none)
   int dynamic_group_allow;  // 1 if can be used with dynamic group, else 0
@@ -103,6 +107,10 @@ class Compute : protected Pointers {
   virtual int pack_reverse_comm(int, int, double *) {return 0;}
   virtual void unpack_reverse_comm(int, int *, double *) {}
 
+  virtual int size_reduce(int) {return 0;}
+  virtual void pack_reduce(int, double *) {}
+  virtual void unpack_reduce(int, double *) {}
+
   virtual void dof_remove_pre() {}
   virtual int dof_remove(int) {return 0;}
   virtual void remove_bias(int, double *) {}
@@ -22,6 +22,8 @@
 
 using namespace LAMMPS_NS;
 
+#define INVOKED_SCALAR 1
+
 /* ---------------------------------------------------------------------- */
 
 ComputeKE::ComputeKE(LAMMPS *lmp, int narg, char **arg) :
@@ -31,6 +33,7 @@ ComputeKE::ComputeKE(LAMMPS *lmp, int narg, char **arg) :
 
   scalar_flag = 1;
   extscalar = 1;
+  reduceflag = 1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -43,6 +46,27 @@ void ComputeKE::init()
 /* ---------------------------------------------------------------------- */
 
 double ComputeKE::compute_scalar()
+{
+  double ke;
+  pack_reduce(INVOKED_SCALAR,&ke);
+  MPI_Allreduce(&ke,&scalar,1,MPI_DOUBLE,MPI_SUM,world);
+  scalar *= pfactor;
+  return scalar;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int ComputeKE::size_reduce(int flag)
+{
+  if (flag == INVOKED_SCALAR) return 1;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   sum KE of my atoms
+------------------------------------------------------------------------- */
+
+void ComputeKE::pack_reduce(int flag, double *buf)
 {
   invoked_scalar = update->ntimestep;
 
@@ -66,7 +90,12 @@ double ComputeKE::compute_scalar()
           (v[i][0]*v[i][0] + v[i][1]*v[i][1] + v[i][2]*v[i][2]);
   }
 
-  MPI_Allreduce(&ke,&scalar,1,MPI_DOUBLE,MPI_SUM,world);
-  scalar *= pfactor;
-  return scalar;
+  buf[0] = ke;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ComputeKE::unpack_reduce(int flag, double *buf)
+{
+  scalar = buf[0] * pfactor;
 }
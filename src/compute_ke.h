@@ -29,6 +29,9 @@ class ComputeKE : public Compute {
   ComputeKE(class LAMMPS *, int, char **);
   void init();
   double compute_scalar();
+  int size_reduce(int);
+  void pack_reduce(int, double *);
+  void unpack_reduce(int, double *);
 
  private:
   double pfactor;
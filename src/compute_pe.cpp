@@ -29,6 +29,8 @@
 
 using namespace LAMMPS_NS;
 
+#define INVOKED_SCALAR 1
+
 /* ---------------------------------------------------------------------- */
 
 ComputePE::ComputePE(LAMMPS *lmp, int narg, char **arg) :
@@ -41,6 +43,7 @@ ComputePE::ComputePE(LAMMPS *lmp, int narg, char **arg) :
   extscalar = 1;
   peflag = 1;
   timeflag = 1;
+  reduceflag = 1;
 
   if (narg == 3) {
     pairflag = 1;
@@ -69,6 +72,28 @@ ComputePE::ComputePE(LAMMPS *lmp, int narg, char **arg) :
 /* ---------------------------------------------------------------------- */
 
 double ComputePE::compute_scalar()
+{
+  double one;
+  pack_reduce(INVOKED_SCALAR,&one);
+  double all;
+  MPI_Allreduce(&one,&all,1,MPI_DOUBLE,MPI_SUM,world);
+  unpack_reduce(INVOKED_SCALAR,&all);
+  return scalar;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int ComputePE::size_reduce(int flag)
+{
+  if (flag == INVOKED_SCALAR) return 1;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   sum energies tallied by my proc
+------------------------------------------------------------------------- */
+
+void ComputePE::pack_reduce(int flag, double *buf)
 {
   invoked_scalar = update->ntimestep;
   if (update->eflag_global != invoked_scalar)
@@ -85,7 +110,16 @@ double ComputePE::compute_scalar()
     if (improperflag && force->improper) one += force->improper->energy;
   }
 
-  MPI_Allreduce(&one,&scalar,1,MPI_DOUBLE,MPI_SUM,world);
+  buf[0] = one;
+}
+
+/* ----------------------------------------------------------------------
+   add global energy terms to sum over all procs
+------------------------------------------------------------------------- */
+
+void ComputePE::unpack_reduce(int flag, double *buf)
+{
+  scalar = buf[0];
 
   if (kspaceflag && force->kspace) scalar += force->kspace->energy;
 
@@ -95,6 +129,4 @@ double ComputePE::compute_scalar()
   }
 
   if (thermoflag && modify->n_thermo_energy) scalar += modify->thermo_energy();
-
-  return scalar;
 }
@@ -30,6 +30,9 @@ class ComputePE : public Compute {
   ~ComputePE() {}
   void init() {}
   double compute_scalar();
+  int size_reduce(int);
+  void pack_reduce(int, double *);
+  void unpack_reduce(int, double *);
 
  private:
   int pairflag,bondflag,angleflag,dihedralflag,improperflag,kspaceflag;
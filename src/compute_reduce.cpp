@@ -33,6 +33,7 @@ enum{SUM,MINN,MAXX,AVE};
 enum{X,V,F,COMPUTE,FIX,VARIABLE};
 enum{PERATOM,LOCAL};
 
+#define INVOKED_SCALAR 1
 #define INVOKED_VECTOR 2
 #define INVOKED_ARRAY 4
 #define INVOKED_PERATOM 8
@@ -146,6 +147,7 @@ ComputeReduce::ComputeReduce(LAMMPS *lmp, int narg, char **arg) :
 
   replace = new int[nvalues];
   for (int i = 0; i < nvalues; i++) replace[i] = -1;
+  stable = 0;
 
   while (iarg < narg) {
     if (strcmp(arg[iarg],"replace") == 0) {
@@ -161,6 +163,12 @@ ComputeReduce::ComputeReduce(LAMMPS *lmp, int narg, char **arg) :
         error->all(FLERR,"Invalid replace values in compute reduce");
       replace[col1] = col2;
       iarg += 3;
+    } else if (strcmp(arg[iarg],"stable") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal compute reduce command");
+      if (strcmp(arg[iarg+1],"yes") == 0) stable = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) stable = 0;
+      else error->all(FLERR,"Illegal compute reduce command");
+      iarg += 2;
     } else error->all(FLERR,"Illegal compute reduce command");
   }
 
@@ -272,6 +280,10 @@ ComputeReduce::ComputeReduce(LAMMPS *lmp, int narg, char **arg) :
     owner = new int[size_vector];
   }
 
+  // sums can be batched with other computes
+
+  if (mode == SUM) reduceflag = 1;
+
   maxatom = 0;
   varatom = NULL;
 }
@@ -370,13 +382,11 @@ void ComputeReduce::compute_vector()
     }
 
   if (mode == SUM) {
-    for (int m = 0; m < nvalues; m++)
-      MPI_Allreduce(&onevec[m],&vector[m],1,MPI_DOUBLE,MPI_SUM,world);
+    MPI_Allreduce(onevec,vector,nvalues,MPI_DOUBLE,MPI_SUM,world);
 
   } else if (mode == MINN) {
     if (!replace) {
-      for (int m = 0; m < nvalues; m++)
-        MPI_Allreduce(&onevec[m],&vector[m],1,MPI_DOUBLE,MPI_MIN,world);
+      MPI_Allreduce(onevec,vector,nvalues,MPI_DOUBLE,MPI_MIN,world);
 
     } else {
       for (int m = 0; m < nvalues; m++)
@@ -397,8 +407,7 @@ void ComputeReduce::compute_vector()
 
   } else if (mode == MAXX) {
     if (!replace) {
-      for (int m = 0; m < nvalues; m++)
-        MPI_Allreduce(&onevec[m],&vector[m],1,MPI_DOUBLE,MPI_MAX,world);
+      MPI_Allreduce(onevec,vector,nvalues,MPI_DOUBLE,MPI_MAX,world);
 
     } else {
       for (int m = 0; m < nvalues; m++)
@@ -418,14 +427,48 @@ void ComputeReduce::compute_vector()
     }
 
   } else if (mode == AVE) {
+    MPI_Allreduce(onevec,vector,nvalues,MPI_DOUBLE,MPI_SUM,world);
     for (int m = 0; m < nvalues; m++) {
-      MPI_Allreduce(&onevec[m],&vector[m],1,MPI_DOUBLE,MPI_SUM,world);
       bigint n = count(m);
       if (n) vector[m] /= n;
     }
   }
 }
 
+/* ----------------------------------------------------------------------
+   # of values to sum across procs, only used for mode = SUM
+------------------------------------------------------------------------- */
+
+int ComputeReduce::size_reduce(int flag)
+{
+  if (flag == INVOKED_SCALAR && scalar_flag) return 1;
+  if (flag == INVOKED_VECTOR && vector_flag) return nvalues;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   sum each input over my atoms
+------------------------------------------------------------------------- */
+
+void ComputeReduce::pack_reduce(int flag, double *buf)
+{
+  if (flag == INVOKED_SCALAR) {
+    invoked_scalar = update->ntimestep;
+    buf[0] = compute_one(0,-1);
+  } else {
+    invoked_vector = update->ntimestep;
+    for (int m = 0; m < nvalues; m++) buf[m] = compute_one(m,-1);
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ComputeReduce::unpack_reduce(int flag, double *buf)
+{
+  if (flag == INVOKED_SCALAR) scalar = buf[0];
+  else for (int m = 0; m < nvalues; m++) vector[m] = buf[m];
+}
+
 /* ----------------------------------------------------------------------
    calculate reduced value for one input M and return it
    if flag = -1:
@@ -444,6 +487,7 @@ double ComputeReduce::compute_one(int m, int flag)
   // only include atoms in group for atom properties and per-atom quantities
 
   index = -1;
+  comp = 0.0;
   int vidx = value2index[m];
   int aidx = argindex[m];
 
@@ -587,7 +631,9 @@ double ComputeReduce::compute_one(int m, int flag)
     } else one = varatom[flag];
   }
 
-  return one;
+  // add compensation of last Kahan sum, which is 0.0 if not used
+
+  return one - comp;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -627,13 +673,20 @@ bigint ComputeReduce::count(int m)
 
 /* ----------------------------------------------------------------------
    combine two values according to reduction mode
+   for SUM/AVE with stable set, Kahan sum with compensation in comp
    for MIN/MAX, also update index with winner
 ------------------------------------------------------------------------- */
 
 void ComputeReduce::combine(double &one, double two, int i)
 {
-  if (mode == SUM || mode == AVE) one += two;
-  else if (mode == MINN) {
+  if (mode == SUM || mode == AVE) {
+    if (stable) {
+      double y = two - comp;
+      double t = one + y;
+      comp = (t - one) - y;
+      one = t;
+    } else one += two;
+  } else if (mode == MINN) {
     if (two < one) {
       one = two;
       index = i;
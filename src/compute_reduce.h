@@ -31,6 +31,9 @@ class ComputeReduce : public Compute {
   void init();
   double compute_scalar();
   void compute_vector();
+  int size_reduce(int);
+  void pack_reduce(int, double *);
+  void unpack_reduce(int, double *);
   double memory_usage();
 
  protected:
@@ -41,6 +44,8 @@ class ComputeReduce : public Compute {
   double *onevec;
   int *replace,*indices,*owner;
   int index;
+  int stable;            // 1 if sums are compensated (Kahan)
+  double comp;           // compensation of current sum
   char *idregion;
 
   int maxatom;
@@ -65,6 +65,7 @@ double ComputeReduceRegion::compute_one(int m, int flag)
   // only include atoms in group
 
   index = -1;
+  comp = 0.0;
   double **x = atom->x;
   int *mask = atom->mask;
   int nlocal = atom->nlocal;
@@ -216,7 +217,9 @@ double ComputeReduceRegion::compute_one(int m, int flag)
     } else one = varatom[flag];
   }
 
-  return one;
+  // add compensation of last Kahan sum, which is 0.0 if not used
+
+  return one - comp;
 }
 
 /* ---------------------------------------------------------------------- */
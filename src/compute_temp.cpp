@@ -23,6 +23,9 @@
 
 using namespace LAMMPS_NS;
 
+#define INVOKED_SCALAR 1
+#define INVOKED_VECTOR 2
+
 /* ---------------------------------------------------------------------- */
 
 ComputeTemp::ComputeTemp(LAMMPS *lmp, int narg, char **arg) :
@@ -35,6 +38,7 @@ ComputeTemp::ComputeTemp(LAMMPS *lmp, int narg, char **arg) :
   extscalar = 0;
   extvector = 1;
   tempflag = 1;
+  reduceflag = 1;
 
   vector = new double[6];
 }
@@ -70,28 +74,8 @@ void ComputeTemp::dof_compute()
 
 double ComputeTemp::compute_scalar()
 {
-  invoked_scalar = update->ntimestep;
-
-  double **v = atom->v;
-  double *mass = atom->mass;
-  double *rmass = atom->rmass;
-  int *type = atom->type;
-  int *mask = atom->mask;
-  int nlocal = atom->nlocal;
-
-  double t = 0.0;
-
-  if (rmass) {
-    for (int i = 0; i < nlocal; i++)
-      if (mask[i] & groupbit)
-        t += (v[i][0]*v[i][0] + v[i][1]*v[i][1] + v[i][2]*v[i][2]) * rmass[i];
-  } else {
-    for (int i = 0; i < nlocal; i++)
-      if (mask[i] & groupbit)
-        t += (v[i][0]*v[i][0] + v[i][1]*v[i][1] + v[i][2]*v[i][2]) *
-          mass[type[i]];
-  }
-
+  double t;
+  pack_reduce(INVOKED_SCALAR,&t);
   MPI_Allreduce(&t,&scalar,1,MPI_DOUBLE,MPI_SUM,world);
   if (dynamic) dof_compute();
   scalar *= tfactor;
@@ -102,9 +86,33 @@ double ComputeTemp::compute_scalar()
 
 void ComputeTemp::compute_vector()
 {
-  int i;
+  double t[6];
+  pack_reduce(INVOKED_VECTOR,t);
+  MPI_Allreduce(t,vector,6,MPI_DOUBLE,MPI_SUM,world);
+  for (int i = 0; i < 6; i++) vector[i] *= force->mvv2e;
+}
 
-  invoked_vector = update->ntimestep;
+/* ----------------------------------------------------------------------
+   # of values summed across procs for scalar or vector
+   0 if scalar needs a global count of atoms in a dynamic group
+------------------------------------------------------------------------- */
+
+int ComputeTemp::size_reduce(int flag)
+{
+  if (flag == INVOKED_SCALAR) {
+    if (dynamic) return 0;
+    return 1;
+  }
+  return 6;
+}
+
+/* ----------------------------------------------------------------------
+   sum contribution of my atoms to scalar or vector
+------------------------------------------------------------------------- */
+
+void ComputeTemp::pack_reduce(int flag, double *buf)
+{
+  int i;
 
   double **v = atom->v;
   double *mass = atom->mass;
@@ -113,6 +121,29 @@ void ComputeTemp::compute_vector()
   int *mask = atom->mask;
   int nlocal = atom->nlocal;
 
+  if (flag == INVOKED_SCALAR) {
+    invoked_scalar = update->ntimestep;
+
+    double t = 0.0;
+
+    if (rmass) {
+      for (i = 0; i < nlocal; i++)
+        if (mask[i] & groupbit)
+          t += (v[i][0]*v[i][0] + v[i][1]*v[i][1] + v[i][2]*v[i][2]) *
+            rmass[i];
+    } else {
+      for (i = 0; i < nlocal; i++)
+        if (mask[i] & groupbit)
+          t += (v[i][0]*v[i][0] + v[i][1]*v[i][1] + v[i][2]*v[i][2]) *
+            mass[type[i]];
+    }
+
+    buf[0] = t;
+    return;
+  }
+
+  invoked_vector = update->ntimestep;
+
   double massone,t[6];
   for (i = 0; i < 6; i++) t[i] = 0.0;
 
@@ -128,6 +159,15 @@ void ComputeTemp::compute_vector()
       t[5] += massone * v[i][1]*v[i][2];
     }
 
-  MPI_Allreduce(t,vector,6,MPI_DOUBLE,MPI_SUM,world);
-  for (i = 0; i < 6; i++) vector[i] *= force->mvv2e;
+  for (i = 0; i < 6; i++) buf[i] = t[i];
+}
+
+/* ----------------------------------------------------------------------
+   set scalar or vector from sums over all procs
+------------------------------------------------------------------------- */
+
+void ComputeTemp::unpack_reduce(int flag, double *buf)
+{
+  if (flag == INVOKED_SCALAR) scalar = buf[0] * tfactor;
+  else for (int i = 0; i < 6; i++) vector[i] = buf[i] * force->mvv2e;
 }
@@ -32,6 +32,9 @@ class ComputeTemp : public Compute {
   void setup();
   double compute_scalar();
   void compute_vector();
+  int size_reduce(int);
+  void pack_reduce(int, double *);
+  void unpack_reduce(int, double *);
 
  protected:
   double tfactor;
@@ -40,6 +40,7 @@ using namespace MathConst;
 
 #define BIG 1.0e30
 #define EPSILON 1.0e-6
+#define GROW_FACTOR 1.5
 
 enum{BOX,REGION,SINGLE,RANDOM};
 enum{ATOM,MOLECULE};
@@ -691,6 +692,24 @@ void CreateAtoms::add_lattice()
     bboxlo[2] = domain->sublo[2]; bboxhi[2] = domain->subhi[2];
   } else domain->bbox(domain->sublo_lamda,domain->subhi_lamda,bboxlo,bboxhi);
 
+  // limit bbox to extent of region if it is static and bounded
+  // for block regions this is exactly the part of my subbox they cover
+  // return if they do not overlap
+
+  if (style == REGION) {
+    Region *region = domain->regions[nregion];
+    if (region->bboxflag && !region->dynamic_check()) {
+      bboxlo[0] = MAX(bboxlo[0],region->extent_xlo);
+      bboxhi[0] = MIN(bboxhi[0],region->extent_xhi);
+      bboxlo[1] = MAX(bboxlo[1],region->extent_ylo);
+      bboxhi[1] = MIN(bboxhi[1],region->extent_yhi);
+      bboxlo[2] = MAX(bboxlo[2],region->extent_zlo);
+      bboxhi[2] = MIN(bboxhi[2],region->extent_zhi);
+      if (bboxlo[0] > bboxhi[0] || bboxlo[1] > bboxhi[1] ||
+          bboxlo[2] > bboxhi[2]) return;
+    }
+  }
+
   double xmin,ymin,zmin,xmax,ymax,zmax;
   xmin = ymin = zmin = BIG;
   xmax = ymax = zmax = -BIG;
@@ -737,6 +756,9 @@ void CreateAtoms::add_lattice()
   // iterate on nbasis atoms in each unit cell
   // convert lattice coords to box coords
   // add atom or molecule (on each basis point) if it meets all criteria
+  // test cheap subbox criterion before region and variable
+  // grow atom arrays by a factor, not by a fixed chunk per new atom,
+  //   so creating N atoms copies the arrays O(log N) times
 
   double **basis = domain->lattice->basis;
   double x[3],lamda[3];
@@ -756,15 +778,6 @@ void CreateAtoms::add_lattice()
 
           domain->lattice->lattice2box(x[0],x[1],x[2]);
 
-          // if a region was specified, test if atom is in it
-
-          if (style == REGION)
-            if (!domain->regions[nregion]->match(x[0],x[1],x[2])) continue;
-
-          // if variable test specified, eval variable
-
-          if (varflag && vartest(x) == 0) continue;
-
           // test if atom/molecule position is in my subbox
 
           if (triclinic) {
@@ -776,10 +789,24 @@ void CreateAtoms::add_lattice()
               coord[1] < sublo[1] || coord[1] >= subhi[1] ||
               coord[2] < sublo[2] || coord[2] >= subhi[2]) continue;
 
+          // if a region was specified, test if atom is in it
+
+          if (style == REGION)
+            if (!domain->regions[nregion]->match(x[0],x[1],x[2])) continue;
+
+          // if variable test specified, eval variable
+
+          if (varflag && vartest(x) == 0) continue;
+
           // add the atom or entire molecule to my list of atoms
 
-          if (mode == ATOM) atom->avec->create_atom(basistype[m],x);
-          else add_molecule(x);
+          if (mode == ATOM) {
+            if (atom->nlocal == atom->nmax) {
+              bigint n = static_cast<bigint> (GROW_FACTOR*atom->nmax) + 1;
+              atom->avec->grow(MIN(n,MAXSMALLINT));
+            }
+            atom->avec->create_atom(basistype[m],x);
+          } else add_molecule(x);
         }
 }
 
@@ -23,6 +23,7 @@
 #include "domain.h"
 #include "group.h"
 #include "output.h"
+#include "compress.h"
 #include "memory.h"
 #include "error.h"
 #include "force.h"
@@ -82,18 +83,22 @@ Dump::Dump(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
 
   maxsbuf = 0;
   sbuf = NULL;
+  maxzbuf = 0;
+  zbuf = NULL;
 
   // parse filename for special syntax
   // if contains '%', write one file per proc and replace % with proc-ID
   // if contains '*', write one file per timestep and replace * with timestep
   // check file suffixes
   //   if ends in .bin = binary file
-  //   else if ends in .gz = gzipped text file
+  //   else if ends in .gz or .zst = compressed text file
   //   else ASCII text file
 
   fp = NULL;
   singlefile_opened = 0;
   compressed = 0;
+  zip = NULL;
+  zfp = idxfp = NULL;
   binary = 0;
   multifile = 0;
 
@@ -124,8 +129,7 @@ Dump::Dump(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
 
   char *suffix = filename + strlen(filename) - strlen(".bin");
   if (suffix > filename && strcmp(suffix,".bin") == 0) binary = 1;
-  suffix = filename + strlen(filename) - strlen(".gz");
-  if (suffix > filename && strcmp(suffix,".gz") == 0) compressed = 1;
+  if (Compress::suffix(filename) != Compress::NONE) compressed = 1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -150,9 +154,20 @@ Dump::~Dump()
   delete irregular;
 
   memory->destroy(sbuf);
+  memory->destroy(zbuf);
 
   if (multiproc) MPI_Comm_free(&clustercomm);
 
+  // in-process compression writes headers to fp = a temporary file
+
+  if (zip) {
+    if (zfp) fclose(zfp);
+    if (idxfp) fclose(idxfp);
+    if (fp) fclose(fp);
+    fp = NULL;
+    delete zip;
+  }
+
   // XTC style sets fp to NULL since it closes file in its destructor
 
   if (multifile == 0 && fp != NULL) {
@@ -168,6 +183,15 @@ Dump::~Dump()
 
 void Dump::init()
 {
+  // compress in-process if style can convert its output to strings
+  //   and codec is available, else output goes through a gzip/zstd pipe
+  // must precede init_style() since it may open the file
+
+  if (compressed && zip == NULL && buffer_allow && !binary) {
+    int codec = Compress::suffix(filename);
+    if (Compress::available(codec)) zip = new Compress(lmp,codec);
+  }
+
   init_style();
 
   if (!sort_flag) {
@@ -343,8 +367,9 @@ void Dump::write()
   // if buffering, convert doubles into strings
   // insure sbuf is sized for communicating
   // cannot buffer if output is to binary file
+  // in-process compression always buffers
 
-  if (buffer_flag && !binary) {
+  if ((buffer_flag || zip) && !binary) {
     nsme = convert_string(nme,buf);
     int nsmin,nsmax;
     MPI_Allreduce(&nsme,&nsmin,1,MPI_INT,MPI_MIN,world);
@@ -356,6 +381,11 @@ void Dump::write()
       maxsbuf = nsmax;
       memory->grow(sbuf,maxsbuf,"dump:sbuf");
     }
+    if (zip && zip->bound(nsmax) > maxzbuf) {
+      maxzbuf = zip->bound(nsmax);
+      memory->destroy(zbuf);
+      memory->create(zbuf,maxzbuf,"dump:zbuf");
+    }
   }
 
   // filewriter = 1 = this proc writes to file
@@ -366,9 +396,62 @@ void Dump::write()
   MPI_Status status;
   MPI_Request request;
 
+  // comm and output compressed sbuf
+  // each proc compresses its own string as an independent chunk,
+  //   fileproc prepends the header to its string first
+
+  if (zip) {
+    int nhead = 0;
+    if (filewriter) {
+      nhead = ftell(fp);
+      if (nsme+nhead > maxsbuf) {
+        maxsbuf = nsme+nhead;
+        memory->grow(sbuf,maxsbuf,"dump:sbuf");
+      }
+      if (zip->bound(nsme+nhead) > maxzbuf) {
+        maxzbuf = zip->bound(nsme+nhead);
+        memory->destroy(zbuf);
+        memory->create(zbuf,maxzbuf,"dump:zbuf");
+      }
+      memmove(&sbuf[nhead],sbuf,nsme);
+      rewind(fp);
+      if ((int) fread(sbuf,sizeof(char),nhead,fp) != nhead)
+        error->one(FLERR,"Cannot write dump header");
+      rewind(fp);
+    }
+
+    int nzme = zip->compress(sbuf,nsme+nhead,zbuf,maxzbuf);
+
+    if (filewriter) {
+      bigint offset = ftell(zfp);
+      bigint nbytes = 0;
+      for (int iproc = 0; iproc < nclusterprocs; iproc++) {
+        if (iproc) {
+          MPI_Irecv(zbuf,maxzbuf,MPI_CHAR,me+iproc,0,world,&request);
+          MPI_Send(&tmp,0,MPI_INT,me+iproc,0,world);
+          MPI_Wait(&request,&status);
+          MPI_Get_count(&status,MPI_CHAR,&nchars);
+        } else nchars = nzme;
+
+        fwrite(zbuf,sizeof(char),nchars,zfp);
+        nbytes += nchars;
+      }
+
+      fprintf(idxfp,BIGINT_FORMAT " " BIGINT_FORMAT " " BIGINT_FORMAT
+              " " BIGINT_FORMAT "\n",update->ntimestep,nheader,offset,nbytes);
+      if (flush_flag) {
+        fflush(zfp);
+        fflush(idxfp);
+      }
+
+    } else {
+      MPI_Recv(&tmp,0,MPI_INT,fileproc,0,world,&status);
+      MPI_Rsend(zbuf,nzme,MPI_CHAR,fileproc,0,world);
+    }
+
   // comm and output buf of doubles
 
-  if (buffer_flag == 0 || binary) {
+  } else if (buffer_flag == 0 || binary) {
     if (filewriter) {
       for (int iproc = 0; iproc < nclusterprocs; iproc++) {
         if (iproc) {
@@ -413,7 +496,13 @@ void Dump::write()
   // if file per timestep, close file if I am filewriter
 
   if (multifile) {
-    if (compressed) {
+    if (zip) {
+      if (filewriter) {
+        fclose(zfp);
+        fclose(idxfp);
+        zfp = idxfp = NULL;
+      }
+    } else if (compressed) {
       if (filewriter) pclose(fp);
     } else {
       if (filewriter) fclose(fp);
@@ -457,12 +546,34 @@ void Dump::openfile()
   }
 
   // each proc with filewriter = 1 opens a file
+  // in-process compression writes to zfp, plus index of snapshots to idxfp
+  //   header is written to fp = temporary file, then compressed with data
 
   if (filewriter) {
-    if (compressed) {
+    if (zip) {
+      if (append_flag) zfp = fopen(filecurrent,"ab");
+      else zfp = fopen(filecurrent,"wb");
+      if (zfp == NULL) error->one(FLERR,"Cannot open dump file");
+      fseek(zfp,0,SEEK_END);
+
+      char *idxfile = new char[strlen(filecurrent) + 8];
+      sprintf(idxfile,"%s.idx",filecurrent);
+      if (append_flag) idxfp = fopen(idxfile,"a");
+      else idxfp = fopen(idxfile,"w");
+      delete [] idxfile;
+      if (idxfp == NULL) error->one(FLERR,"Cannot open dump index file");
+      fseek(idxfp,0,SEEK_END);
+      if (ftell(idxfp) == 0)
+        fprintf(idxfp,"# timestep natoms offset bytes\n");
+
+      if (fp == NULL) fp = tmpfile();
+
+    } else if (compressed) {
 #ifdef LAMMPS_GZIP
       char gzip[128];
-      sprintf(gzip,"gzip -6 > %s",filecurrent);
+      if (Compress::suffix(filecurrent) == Compress::ZSTD)
+        sprintf(gzip,"zstd -q > %s",filecurrent);
+      else sprintf(gzip,"gzip -6 > %s",filecurrent);
 #ifdef _WIN32
       fp = _popen(gzip,"wb");
 #else
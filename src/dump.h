@@ -54,6 +54,9 @@ class Dump : protected Pointers {
 
   char *filename;            // user-specified file
   int compressed;            // 1 if dump file is written compressed, 0 no
+  class Compress *zip;       // in-process compression of dump file, if any
+  FILE *zfp;                 // compressed file written via zip
+  FILE *idxfp;               // index of snapshots in compressed file
   int binary;                // 1 if dump file is written binary, 0 no
   int multifile;             // 0 = one big file, 1 = one file per timestep
   int multiproc;             // 0 = proc 0 writes for all,
@@ -100,6 +103,8 @@ class Dump : protected Pointers {
   double *buf;               // memory for atom quantities
   int maxsbuf;               // size of sbuf
   char *sbuf;                // memory for atom quantities in string format
+  int maxzbuf;               // size of zbuf
+  char *zbuf;                // memory for compressed sbuf
 
   int maxids;                // size of ids
   int maxsort;               // size of bufsort, idsort, index
@@ -167,13 +172,24 @@ dump.
 E: Cannot open gzipped file
 
 LAMMPS was compiled without support for reading and writing gzipped
-files through a pipeline to the gzip program with -DLAMMPS_GZIP.
+files through a pipeline to the gzip program with -DLAMMPS_GZIP, or
+for writing them in-process with -DLAMMPS_ZLIB.
 
 E: Cannot open dump file
 
 The output file for the dump command cannot be opened.  Check that the
 path and name are correct.
 
+E: Cannot open dump index file
+
+The index file written alongside a compressed dump file, with the
+same name plus a ".idx" suffix, cannot be opened.
+
+E: Cannot write dump header
+
+The header of a snapshot could not be read back from the temporary
+file it is written to before being compressed.
+
 E: Illegal ... command
 
 Self-explanatory.  Check the input script syntax and compare to the
@@ -555,14 +555,21 @@ void DumpImage::write()
 
   // write image file
 
-  if (me == 0) {
-    if (filetype == JPG) image->write_JPG(fp);
-    else if (filetype == PNG) image->write_PNG(fp);
-    else image->write_PPM(fp);
-    if (multifile) {
-      fclose(fp);
-      fp = NULL;
-    }
+  if (me == 0) write_image();
+}
+
+/* ----------------------------------------------------------------------
+   write merged image to file, only called on proc 0
+------------------------------------------------------------------------- */
+
+void DumpImage::write_image()
+{
+  if (filetype == JPG) image->write_JPG(fp);
+  else if (filetype == PNG) image->write_PNG(fp);
+  else image->write_PPM(fp);
+  if (multifile) {
+    fclose(fp);
+    fp = NULL;
   }
 }
 
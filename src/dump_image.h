@@ -71,6 +71,7 @@ class DumpImage : public DumpCustom {
   virtual void init_style();
   int modify_param(int, char **);
   void write();
+  virtual void write_image();
 
   void box_center();
   void view_params();
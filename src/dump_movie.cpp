@@ -19,6 +19,7 @@
 #include "stdlib.h"
 #include "string.h"
 #include "dump_movie.h"
+#include "image.h"
 #include "comm.h"
 #include "force.h"
 #include "memory.h"
@@ -38,6 +39,48 @@ DumpMovie::DumpMovie(LAMMPS *lmp, int narg, char **arg) :
   bitrate = 2000;
   framerate = 24;
   fp = NULL;
+
+  nqueue = 0;
+  dropflag = 0;
+  framebytes = 0;
+  frames = NULL;
+  nhead = ntail = 0;
+  writerflag = doneflag = 0;
+
+  nframes = ndropped = 0;
+  stalltime = 0.0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+DumpMovie::~DumpMovie()
+{
+  // let writer thread drain the queue, then wait for it to exit
+
+#if defined(LAMMPS_ASYNC_MOVIE)
+  if (writerflag) {
+    pthread_mutex_lock(&queue_mutex);
+    doneflag = 1;
+    pthread_cond_broadcast(&queue_cond);
+    pthread_mutex_unlock(&queue_mutex);
+    pthread_join(writer,NULL);
+    pthread_mutex_destroy(&queue_mutex);
+    pthread_cond_destroy(&queue_cond);
+  }
+#endif
+
+  memory->sfree(frames);
+
+  if (comm->me == 0 && nframes) {
+    if (screen)
+      fprintf(screen,"Dump movie %s: " BIGINT_FORMAT " frames, "
+              BIGINT_FORMAT " dropped, %g secs waiting on encoder\n",
+              id,nframes,ndropped,stalltime);
+    if (logfile)
+      fprintf(logfile,"Dump movie %s: " BIGINT_FORMAT " frames, "
+              BIGINT_FORMAT " dropped, %g secs waiting on encoder\n",
+              id,nframes,ndropped,stalltime);
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -68,6 +111,109 @@ void DumpMovie::openfile()
     }
   }
 }
+/* ----------------------------------------------------------------------
+   pass merged image to FFmpeg, only called on proc 0
+   without a queue, write directly and time how long the pipe blocks
+------------------------------------------------------------------------- */
+
+void DumpMovie::write_image()
+{
+  nframes++;
+
+  if (nqueue == 0) {
+    double time1 = MPI_Wtime();
+    image->write_PPM(fp);
+    stalltime += MPI_Wtime() - time1;
+    return;
+  }
+
+  queue_frame();
+}
+
+/* ----------------------------------------------------------------------
+   copy image into the next free slot of the ring buffer
+   start writer thread on first frame
+   if queue is full, either drop the frame or wait for the writer
+------------------------------------------------------------------------- */
+
+void DumpMovie::queue_frame()
+{
+#if defined(LAMMPS_ASYNC_MOVIE)
+  if (!writerflag) {
+    framebytes = 3 * (bigint) image->width * image->height;
+    frames = (unsigned char *)
+      memory->smalloc(nqueue*framebytes,"dump:frames");
+    pthread_mutex_init(&queue_mutex,NULL);
+    pthread_cond_init(&queue_cond,NULL);
+    pthread_create(&writer,NULL,&dump_movie_writer,this);
+    writerflag = 1;
+  }
+
+  pthread_mutex_lock(&queue_mutex);
+  if (nhead-ntail == nqueue) {
+    if (dropflag) {
+      ndropped++;
+      pthread_mutex_unlock(&queue_mutex);
+      return;
+    }
+    double time1 = MPI_Wtime();
+    while (nhead-ntail == nqueue)
+      pthread_cond_wait(&queue_cond,&queue_mutex);
+    stalltime += MPI_Wtime() - time1;
+  }
+  pthread_mutex_unlock(&queue_mutex);
+
+  // writer does not touch slot nhead until nhead is incremented
+
+  image->pack_PPM(&frames[(nhead % nqueue) * framebytes]);
+
+  pthread_mutex_lock(&queue_mutex);
+  nhead++;
+  pthread_cond_broadcast(&queue_cond);
+  pthread_mutex_unlock(&queue_mutex);
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   writer thread: write queued frames to FFmpeg pipe in order
+   exits once queue is empty and doneflag is set
+------------------------------------------------------------------------- */
+
+#if defined(LAMMPS_ASYNC_MOVIE)
+void *dump_movie_writer(void *ptr)
+{
+  DumpMovie *movie = (DumpMovie *) ptr;
+  movie->frame_writer();
+  return NULL;
+}
+#endif
+
+void DumpMovie::frame_writer()
+{
+#if defined(LAMMPS_ASYNC_MOVIE)
+  while (1) {
+    pthread_mutex_lock(&queue_mutex);
+    while (ntail == nhead && !doneflag)
+      pthread_cond_wait(&queue_cond,&queue_mutex);
+    if (ntail == nhead) {
+      pthread_mutex_unlock(&queue_mutex);
+      return;
+    }
+    unsigned char *frame = &frames[(ntail % nqueue) * framebytes];
+    pthread_mutex_unlock(&queue_mutex);
+
+    fprintf(fp,"P6\n%d %d\n255\n",image->width,image->height);
+    fwrite(frame,1,framebytes,fp);
+    fflush(fp);
+
+    pthread_mutex_lock(&queue_mutex);
+    ntail++;
+    pthread_cond_broadcast(&queue_cond);
+    pthread_mutex_unlock(&queue_mutex);
+  }
+#endif
+}
+
 /* ---------------------------------------------------------------------- */
 
 void DumpMovie::init_style()
@@ -101,6 +247,23 @@ int DumpMovie::modify_param(int narg, char **arg)
     return 2;
   }
 
+  if (strcmp(arg[0],"queue") == 0) {
+    if (narg < 3) error->all(FLERR,"Illegal dump_modify command");
+    if (writerflag)
+      error->one(FLERR,"Dump_modify queue cannot be changed once frames "
+                 "have been written");
+    nqueue = force->inumeric(FLERR,arg[1]);
+    if (nqueue < 0) error->all(FLERR,"Illegal dump_modify command");
+    if (strcmp(arg[2],"block") == 0) dropflag = 0;
+    else if (strcmp(arg[2],"drop") == 0) dropflag = 1;
+    else error->all(FLERR,"Illegal dump_modify command");
+#if !defined(LAMMPS_ASYNC_MOVIE)
+    if (nqueue > 0)
+      error->all(FLERR,"Support for asynchronous movie writing not included");
+#endif
+    return 3;
+  }
+
   return 0;
 }
 
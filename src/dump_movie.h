@@ -22,19 +22,51 @@ DumpStyle(movie,DumpMovie)
 
 #include "dump_image.h"
 
+#if defined(LAMMPS_ASYNC_MOVIE)
+#include <pthread.h>
+#endif
+
+/* prototype for c wrapper that calls the real frame writer */
+extern "C" void *dump_movie_writer(void *);
+
 namespace LAMMPS_NS {
 
 class DumpMovie : public DumpImage {
  public:
   DumpMovie(LAMMPS *, int, char**);
+  virtual ~DumpMovie();
 
   virtual void openfile();
   virtual void init_style();
   virtual int modify_param(int, char **);
 
+  void frame_writer();
+
  protected:
   double framerate;             // frame rate of animation
   int bitrate;                  // bitrate of video file in kbps
+
+  // queue of frames written to FFmpeg by a separate thread on proc 0
+
+  int nqueue;                   // # of frames in ring buffer, 0 = no thread
+  int dropflag;                 // 1 = drop frames when queue is full
+  bigint framebytes;            // size of one frame in bytes
+  unsigned char *frames;        // ring buffer of nqueue frames
+  bigint nhead,ntail;           // # of frames queued and written so far
+  int writerflag;               // 1 if writer thread is running
+  int doneflag;                 // 1 when writer thread should exit
+
+  bigint nframes,ndropped;      // statistics
+  double stalltime;             // time proc 0 waited on the encoder
+
+#if defined(LAMMPS_ASYNC_MOVIE)
+  pthread_mutex_t queue_mutex;  // protects nhead, ntail, doneflag
+  pthread_cond_t queue_cond;    // signaled when a frame is queued or removed
+  pthread_t writer;             // thread id of writer thread
+#endif
+
+  virtual void write_image();
+  void queue_frame();
 };
 
 }
@@ -58,6 +90,16 @@ E: Failed to open FFmpeg pipeline to file %s
 The specified file cannot be opened.  Check that the path and name are
 correct and writable and that the FFmpeg executable can be found and run.
 
+E: Support for asynchronous movie writing not included
+
+LAMMPS was not built with the -DLAMMPS_ASYNC_MOVIE switch in the
+Makefile, which is required for the dump_modify queue option.
+
+E: Dump_modify queue cannot be changed once frames have been written
+
+The size of the frame queue is fixed once the writer thread has
+started.
+
 E: Illegal ... command
 
 Self-explanatory.  Check the input script syntax and compare to the
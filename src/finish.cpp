@@ -662,6 +662,10 @@ void Finish::end(int flag)
                 neighbor->ncalls);
         fprintf(screen,"Dangerous builds = " BIGINT_FORMAT "\n",
                 neighbor->ndanger);
+        if (neighbor->validate)
+          fprintf(screen,"Validation builds = " BIGINT_FORMAT
+                  ", missed pairs = " BIGINT_FORMAT "\n",
+                  neighbor->nvalidate,neighbor->nmissed);
       }
       if (logfile) {
         if (nall < 2.0e9)
@@ -677,10 +681,18 @@ void Finish::end(int flag)
                 neighbor->ncalls);
         fprintf(logfile,"Dangerous builds = " BIGINT_FORMAT "\n",
                 neighbor->ndanger);
+        if (neighbor->validate)
+          fprintf(logfile,"Validation builds = " BIGINT_FORMAT
+                  ", missed pairs = " BIGINT_FORMAT "\n",
+                  neighbor->nvalidate,neighbor->nmissed);
       }
     }
   }
 
+  // per-region profile of all procs, if enabled by timer command
+
+  timer->profile_output();
+
   if (logfile) fflush(logfile);
 }
 
@@ -51,6 +51,7 @@ FixAveSpatial::FixAveSpatial(LAMMPS *lmp, int narg, char **arg) :
   if (narg < 6) error->all(FLERR,"Illegal fix ave/spatial command");
 
   MPI_Comm_rank(world,&me);
+  MPI_Comm_size(world,&nprocs);
 
   nevery = force->inumeric(FLERR,arg[3]);
   nrepeat = force->inumeric(FLERR,arg[4]);
@@ -164,9 +165,11 @@ FixAveSpatial::FixAveSpatial(LAMMPS *lmp, int narg, char **arg) :
   regionflag = 0;
   idregion = NULL;
   fp = NULL;
+  fileflag = 0;
   ave = ONE;
   nwindow = 0;
   overwrite = 0;
+  parallel = 0;
   char *title1 = NULL;
   char *title2 = NULL;
   char *title3 = NULL;
@@ -205,6 +208,7 @@ FixAveSpatial::FixAveSpatial(LAMMPS *lmp, int narg, char **arg) :
           error->one(FLERR,str);
         }
       }
+      fileflag = 1;
       iarg += 2;
     } else if (strcmp(arg[iarg],"ave") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal fix ave/spatial command");
@@ -222,6 +226,12 @@ FixAveSpatial::FixAveSpatial(LAMMPS *lmp, int narg, char **arg) :
     } else if (strcmp(arg[iarg],"overwrite") == 0) {
       overwrite = 1;
       iarg += 1;
+    } else if (strcmp(arg[iarg],"parallel") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix ave/spatial command");
+      if (strcmp(arg[iarg+1],"yes") == 0) parallel = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) parallel = 0;
+      else error->all(FLERR,"Illegal fix ave/spatial command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"title1") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal fix ave/spatial command");
       delete [] title1;
@@ -329,8 +339,9 @@ FixAveSpatial::FixAveSpatial(LAMMPS *lmp, int narg, char **arg) :
 
   // this fix produces a global array
   // size_array_rows set by setup_bins()
+  // not if bins are distributed, since no proc stores all of them
 
-  array_flag = 1;
+  if (!parallel) array_flag = 1;
   size_array_cols = 1 + ndim + nvalues;
   extarray = 0;
 
@@ -375,12 +386,27 @@ FixAveSpatial::FixAveSpatial(LAMMPS *lmp, int narg, char **arg) :
   bin = NULL;
 
   nbins = maxbin = 0;
+  nbox = maxbox = 0;
+  maxoccupy = 0;
+  occupy = NULL;
   count_one = count_many = count_sum = count_total = NULL;
   coord = NULL;
   count_list = NULL;
   values_one = values_many = values_sum = values_total = NULL;
   values_list = NULL;
 
+  sendcounts = senddispls = recvcounts = recvdispls = NULL;
+  maxsend = maxrecv = maxsbuf = 0;
+  sendbuf = recvbuf = NULL;
+  sbuf = NULL;
+
+  if (parallel) {
+    memory->create(sendcounts,nprocs,"ave/spatial:sendcounts");
+    memory->create(senddispls,nprocs,"ave/spatial:senddispls");
+    memory->create(recvcounts,nprocs,"ave/spatial:recvcounts");
+    memory->create(recvdispls,nprocs,"ave/spatial:recvdispls");
+  }
+
   setup_bins();
 
   // nvalid = next step on which end_of_step does something
@@ -419,6 +445,15 @@ FixAveSpatial::~FixAveSpatial()
   memory->destroy(values_sum);
   memory->destroy(values_total);
   memory->destroy(values_list);
+
+  memory->destroy(occupy);
+  memory->destroy(sendcounts);
+  memory->destroy(senddispls);
+  memory->destroy(recvcounts);
+  memory->destroy(recvdispls);
+  memory->destroy(sendbuf);
+  memory->destroy(recvbuf);
+  memory->destroy(sbuf);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -520,17 +555,21 @@ void FixAveSpatial::end_of_step()
 
   if (irepeat == 0) {
     if (domain->box_change) setup_bins();
-    for (m = 0; m < nbins; m++) {
+    for (m = 0; m < nown; m++) {
       count_many[m] = count_sum[m] = 0.0;
       for (i = 0; i < nvalues; i++) values_many[m][i] = 0.0;
     }
+    nbox = 0;
   }
 
   // zero out arrays for one sample
+  // if parallel, setup_box() does this for the bins my atoms are in
 
-  for (m = 0; m < nbins; m++) {
-    count_one[m] = 0.0;
-    for (i = 0; i < nvalues; i++) values_one[m][i] = 0.0;
+  if (!parallel) {
+    for (m = 0; m < nbins; m++) {
+      count_one[m] = 0.0;
+      for (i = 0; i < nvalues; i++) values_one[m][i] = 0.0;
+    }
   }
 
   // assign each atom to a bin
@@ -545,10 +584,19 @@ void FixAveSpatial::end_of_step()
     memory->create(bin,maxatom,"ave/spatial:bin");
   }
 
+  for (i = 0; i < nlocal; i++) bin[i] = -1;
+
   if (ndim == 1) atom2bin1d();
   else if (ndim == 2) atom2bin2d();
   else atom2bin3d();
 
+  // if parallel, convert global bin indices to ones in my box of bins
+
+  if (parallel) setup_box();
+
+  for (i = 0; i < nlocal; i++)
+    if (bin[i] >= 0) count_one[bin[i]] += 1.0;
+
   // perform the computation for one sample
   // accumulate results of attributes,computes,fixes,variables to local copy
   // sum within each bin, only include atoms in fix group
@@ -689,21 +737,30 @@ void FixAveSpatial::end_of_step()
   // if normflag = ALL, accumulate values,count separately to many
   // if normflag = SAMPLE, one = value/count, accumulate one to many
   // exception is SAMPLE density: no normalization by atom count
+  // if parallel and normflag = ALL, box of bins accumulates all samples,
+  //   else each sample is summed onto the procs that own the bins
+
+  double **vone = values_one;
 
   if (normflag == ALL) {
-    for (m = 0; m < nbins; m++) {
-      count_many[m] += count_one[m];
-      for (j = 0; j < nvalues; j++)
-        values_many[m][j] += values_one[m][j];
-    }
+    if (!parallel)
+      for (m = 0; m < nbins; m++) {
+        count_many[m] += count_one[m];
+        for (j = 0; j < nvalues; j++)
+          values_many[m][j] += values_one[m][j];
+      }
   } else {
-    MPI_Allreduce(count_one,count_many,nbins,MPI_DOUBLE,MPI_SUM,world);
-    for (m = 0; m < nbins; m++) {
+    if (parallel) {
+      reduce_bins(count_many,values_sum);
+      vone = values_sum;
+    } else
+      MPI_Allreduce(count_one,count_many,nbins,MPI_DOUBLE,MPI_SUM,world);
+    for (m = 0; m < nown; m++) {
       if (count_many[m] > 0.0)
         for (j = 0; j < nvalues; j++) {
           if (which[j] == DENSITY_NUMBER || which[j] == DENSITY_MASS)
-            values_many[m][j] += values_one[m][j];
-          else values_many[m][j] += values_one[m][j]/count_many[m];
+            values_many[m][j] += vone[m][j];
+          else values_many[m][j] += vone[m][j]/count_many[m];
         }
       count_sum[m] += count_many[m];
     }
@@ -732,10 +789,13 @@ void FixAveSpatial::end_of_step()
   double mv2d = force->mv2d;
 
   if (normflag == ALL) {
-    MPI_Allreduce(count_many,count_sum,nbins,MPI_DOUBLE,MPI_SUM,world);
-    MPI_Allreduce(&values_many[0][0],&values_sum[0][0],nbins*nvalues,
-                  MPI_DOUBLE,MPI_SUM,world);
-    for (m = 0; m < nbins; m++) {
+    if (parallel) reduce_bins(count_sum,values_sum);
+    else {
+      MPI_Allreduce(count_many,count_sum,nbins,MPI_DOUBLE,MPI_SUM,world);
+      MPI_Allreduce(&values_many[0][0],&values_sum[0][0],nbins*nvalues,
+                    MPI_DOUBLE,MPI_SUM,world);
+    }
+    for (m = 0; m < nown; m++) {
       if (count_sum[m] > 0.0)
         for (j = 0; j < nvalues; j++) {
           if (which[j] == DENSITY_NUMBER) values_sum[m][j] /= repeat;
@@ -746,9 +806,14 @@ void FixAveSpatial::end_of_step()
       count_sum[m] /= repeat;
     }
   } else {
-    MPI_Allreduce(&values_many[0][0],&values_sum[0][0],nbins*nvalues,
-                  MPI_DOUBLE,MPI_SUM,world);
-    for (m = 0; m < nbins; m++) {
+    if (parallel) {
+      for (m = 0; m < nown; m++)
+        for (j = 0; j < nvalues; j++)
+          values_sum[m][j] = values_many[m][j];
+    } else
+      MPI_Allreduce(&values_many[0][0],&values_sum[0][0],nbins*nvalues,
+                    MPI_DOUBLE,MPI_SUM,world);
+    for (m = 0; m < nown; m++) {
       for (j = 0; j < nvalues; j++)
         values_sum[m][j] /= repeat;
       count_sum[m] /= repeat;
@@ -759,7 +824,7 @@ void FixAveSpatial::end_of_step()
 
   for (j = 0; j < nvalues; j++)
     if (which[j] == DENSITY_NUMBER || which[j] == DENSITY_MASS)
-      for (m = 0; m < nbins; m++)
+      for (m = 0; m < nown; m++)
         values_sum[m][j] /= bin_volume;
 
   // if ave = ONE, only single Nfreq timestep value is needed
@@ -767,7 +832,7 @@ void FixAveSpatial::end_of_step()
   // if ave = WINDOW, comine with nwindow most recent Nfreq timestep values
 
   if (ave == ONE) {
-    for (m = 0; m < nbins; m++) {
+    for (m = 0; m < nown; m++) {
       for (i = 0; i < nvalues; i++)
         values_total[m][i] = values_sum[m][i];
       count_total[m] = count_sum[m];
@@ -775,7 +840,7 @@ void FixAveSpatial::end_of_step()
     norm = 1;
 
   } else if (ave == RUNNING) {
-    for (m = 0; m < nbins; m++) {
+    for (m = 0; m < nown; m++) {
       for (i = 0; i < nvalues; i++)
         values_total[m][i] += values_sum[m][i];
       count_total[m] += count_sum[m];
@@ -783,7 +848,7 @@ void FixAveSpatial::end_of_step()
     norm++;
 
   } else if (ave == WINDOW) {
-    for (m = 0; m < nbins; m++) {
+    for (m = 0; m < nown; m++) {
       for (i = 0; i < nvalues; i++) {
         values_total[m][i] += values_sum[m][i];
         if (window_limit) values_total[m][i] -= values_list[iwindow][m][i];
@@ -804,8 +869,11 @@ void FixAveSpatial::end_of_step()
   }
 
   // output result to file
+  // if parallel, each proc formats the bins it owns
 
-  if (fp && me == 0) {
+  if (parallel) {
+    if (fileflag) write_bins(ntimestep);
+  } else if (fp && me == 0) {
     if (overwrite) fseek(fp,filepos,SEEK_SET);
     fprintf(fp,BIGINT_FORMAT " %d\n",ntimestep,nbins);
     if (ndim == 1)
@@ -902,32 +970,45 @@ void FixAveSpatial::setup_bins()
 
   size_array_rows = nbins;
 
+  // if parallel, I own a contiguous range of bins for averaging and output
+  // count/values one and coords are then not stored for all bins
+
+  if (parallel) {
+    olo = static_cast<int> ((bigint) me*nbins/nprocs);
+    nown = static_cast<int> ((bigint) (me+1)*nbins/nprocs) - olo;
+  } else {
+    olo = 0;
+    nown = nbins;
+  }
+
   // reallocate bin arrays if needed
 
-  if (nbins > maxbin) {
-    maxbin = nbins;
-    memory->grow(count_one,nbins,"ave/spatial:count_one");
-    memory->grow(count_many,nbins,"ave/spatial:count_many");
-    memory->grow(count_sum,nbins,"ave/spatial:count_sum");
-    memory->grow(count_total,nbins,"ave/spatial:count_total");
+  if (nown > maxbin) {
+    maxbin = nown;
+    if (!parallel) {
+      memory->grow(count_one,nbins,"ave/spatial:count_one");
+      memory->grow(coord,nbins,ndim,"ave/spatial:coord");
+      memory->grow(values_one,nbins,nvalues,"ave/spatial:values_one");
+    }
+    memory->grow(count_many,nown,"ave/spatial:count_many");
+    memory->grow(count_sum,nown,"ave/spatial:count_sum");
+    memory->grow(count_total,nown,"ave/spatial:count_total");
 
-    memory->grow(coord,nbins,ndim,"ave/spatial:coord");
-    memory->grow(values_one,nbins,nvalues,"ave/spatial:values_one");
-    memory->grow(values_many,nbins,nvalues,"ave/spatial:values_many");
-    memory->grow(values_sum,nbins,nvalues,"ave/spatial:values_sum");
-    memory->grow(values_total,nbins,nvalues,"ave/spatial:values_total");
+    memory->grow(values_many,nown,nvalues,"ave/spatial:values_many");
+    memory->grow(values_sum,nown,nvalues,"ave/spatial:values_sum");
+    memory->grow(values_total,nown,nvalues,"ave/spatial:values_total");
 
     // only allocate count and values list for ave = WINDOW
 
     if (ave == WINDOW) {
-      memory->create(count_list,nwindow,nbins,"ave/spatial:count_list");
-      memory->create(values_list,nwindow,nbins,nvalues,
+      memory->create(count_list,nwindow,nown,"ave/spatial:count_list");
+      memory->create(values_list,nwindow,nown,nvalues,
                      "ave/spatial:values_list");
     }
 
     // reinitialize regrown count/values total since they accumulate
 
-    for (m = 0; m < nbins; m++) {
+    for (m = 0; m < nown; m++) {
       for (i = 0; i < nvalues; i++) values_total[m][i] = 0.0;
       count_total[m] = 0.0;
     }
@@ -935,6 +1016,8 @@ void FixAveSpatial::setup_bins()
 
   // set bin coordinates
 
+  if (parallel) return;
+
   if (ndim == 1) {
     for (i = 0; i < nlayers[0]; i++)
       coord[i][0] = offset[0] + (i+0.5)*delta[0];
@@ -965,6 +1048,284 @@ void FixAveSpatial::setup_bins()
   }
 }
 
+/* ----------------------------------------------------------------------
+   set box of bins my atoms are in, for parallel = yes
+   box is a range of layers in each dim, which can wrap around the box
+   if normflag = ALL, box also covers bins of previous samples of this
+     Nfreq window, whose accumulated counts/values are copied into it
+   convert bin of each atom from global index to index within the box
+------------------------------------------------------------------------- */
+
+void FixAveSpatial::setup_box()
+{
+  int i,k,m,n,b,gap,maxgap,start,ibox;
+  int oldstart[3],oldnum[3],stride[3],ilayer[3];
+
+  int nlocal = atom->nlocal;
+
+  stride[ndim-1] = 1;
+  for (m = ndim-2; m >= 0; m--) stride[m] = stride[m+1]*nlayers[m+1];
+
+  int merge = 0;
+  if (normflag == ALL && nbox) merge = 1;
+  int oldnbox = nbox;
+  for (m = 0; m < ndim; m++) {
+    oldstart[m] = bstart[m];
+    oldnum[m] = bnum[m];
+  }
+
+  n = 0;
+  for (m = 0; m < ndim; m++) n = MAX(n,nlayers[m]);
+  if (n > maxoccupy) {
+    maxoccupy = n;
+    memory->destroy(occupy);
+    memory->create(occupy,maxoccupy,"ave/spatial:occupy");
+  }
+
+  // flag each layer in dim m that has an atom or is in previous box
+  // box is all but the longest run of empty layers, treated as a ring
+
+  nbox = 1;
+  for (m = 0; m < ndim; m++) {
+    n = nlayers[m];
+    for (k = 0; k < n; k++) occupy[k] = 0;
+    if (merge)
+      for (k = 0; k < oldnum[m]; k++) occupy[(oldstart[m]+k) % n] = 1;
+    for (i = 0; i < nlocal; i++)
+      if (bin[i] >= 0) occupy[bin[i]/stride[m] % n] = 1;
+
+    maxgap = gap = start = 0;
+    for (k = 0; k < 2*n; k++) {
+      if (occupy[k % n]) gap = 0;
+      else if (++gap > maxgap && gap <= n) {
+        maxgap = gap;
+        start = (k+1) % n;
+      }
+    }
+    bstart[m] = start;
+    bnum[m] = n - maxgap;
+    nbox *= bnum[m];
+  }
+
+  // copy previously accumulated bins into a new box if it changed
+
+  int change = 0;
+  for (m = 0; m < ndim; m++)
+    if (bstart[m] != oldstart[m] || bnum[m] != oldnum[m]) change = 1;
+
+  if (merge && change) {
+    double *count_new;
+    double **values_new;
+    memory->create(count_new,nbox,"ave/spatial:count_one");
+    memory->create(values_new,nbox,nvalues,"ave/spatial:values_one");
+    for (b = 0; b < nbox; b++) {
+      count_new[b] = 0.0;
+      for (i = 0; i < nvalues; i++) values_new[b][i] = 0.0;
+    }
+
+    for (b = 0; b < oldnbox; b++) {
+      k = b;
+      for (m = ndim-1; m >= 0; m--) {
+        ilayer[m] = (oldstart[m] + k % oldnum[m]) % nlayers[m];
+        k /= oldnum[m];
+      }
+      ibox = 0;
+      for (m = 0; m < ndim; m++)
+        ibox = ibox*bnum[m] +
+          (ilayer[m] - bstart[m] + nlayers[m]) % nlayers[m];
+      count_new[ibox] = count_one[b];
+      for (i = 0; i < nvalues; i++) values_new[ibox][i] = values_one[b][i];
+    }
+
+    memory->destroy(count_one);
+    memory->destroy(values_one);
+    count_one = count_new;
+    values_one = values_new;
+    maxbox = nbox;
+
+  } else if (!merge) {
+    if (nbox > maxbox) {
+      maxbox = nbox;
+      memory->destroy(count_one);
+      memory->destroy(values_one);
+      memory->create(count_one,maxbox,"ave/spatial:count_one");
+      memory->create(values_one,maxbox,nvalues,"ave/spatial:values_one");
+    }
+    for (b = 0; b < nbox; b++) {
+      count_one[b] = 0.0;
+      for (i = 0; i < nvalues; i++) values_one[b][i] = 0.0;
+    }
+  }
+
+  for (i = 0; i < nlocal; i++) {
+    if (bin[i] < 0) continue;
+    ibox = 0;
+    for (m = 0; m < ndim; m++) {
+      k = bin[i]/stride[m] % nlayers[m];
+      ibox = ibox*bnum[m] + (k - bstart[m] + nlayers[m]) % nlayers[m];
+    }
+    bin[i] = ibox;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   return global index of bin with index ibox within my box of bins
+------------------------------------------------------------------------- */
+
+int FixAveSpatial::box2bin(int ibox)
+{
+  int ilayer[3];
+
+  for (int m = ndim-1; m >= 0; m--) {
+    ilayer[m] = (bstart[m] + ibox % bnum[m]) % nlayers[m];
+    ibox /= bnum[m];
+  }
+
+  int ibin = 0;
+  for (int m = 0; m < ndim; m++) ibin = ibin*nlayers[m] + ilayer[m];
+  return ibin;
+}
+
+/* ----------------------------------------------------------------------
+   sum counts/values of my box of bins onto the procs that own the bins
+   only bins with atoms are sent, each with its global index
+   return count,values for the bins I own
+------------------------------------------------------------------------- */
+
+void FixAveSpatial::reduce_bins(double *count, double **values)
+{
+  int i,j,b,ibin,iproc;
+
+  int nper = nvalues + 2;
+
+  for (iproc = 0; iproc < nprocs; iproc++) sendcounts[iproc] = 0;
+  for (b = 0; b < nbox; b++)
+    if (count_one[b] > 0.0) {
+      ibin = box2bin(b);
+      sendcounts[((bigint) (ibin+1)*nprocs - 1)/nbins] += nper;
+    }
+
+  MPI_Alltoall(sendcounts,1,MPI_INT,recvcounts,1,MPI_INT,world);
+
+  int nsend = 0;
+  int nrecv = 0;
+  for (iproc = 0; iproc < nprocs; iproc++) {
+    senddispls[iproc] = nsend;
+    recvdispls[iproc] = nrecv;
+    nsend += sendcounts[iproc];
+    nrecv += recvcounts[iproc];
+  }
+
+  if (nsend > maxsend) {
+    maxsend = nsend;
+    memory->destroy(sendbuf);
+    memory->create(sendbuf,maxsend,"ave/spatial:sendbuf");
+  }
+  if (nrecv > maxrecv) {
+    maxrecv = nrecv;
+    memory->destroy(recvbuf);
+    memory->create(recvbuf,maxrecv,"ave/spatial:recvbuf");
+  }
+
+  // sendcounts are rebuilt as each proc's section is packed
+
+  for (iproc = 0; iproc < nprocs; iproc++) sendcounts[iproc] = 0;
+  for (b = 0; b < nbox; b++)
+    if (count_one[b] > 0.0) {
+      ibin = box2bin(b);
+      iproc = ((bigint) (ibin+1)*nprocs - 1)/nbins;
+      double *buf = &sendbuf[senddispls[iproc] + sendcounts[iproc]];
+      buf[0] = ibin;
+      buf[1] = count_one[b];
+      for (j = 0; j < nvalues; j++) buf[j+2] = values_one[b][j];
+      sendcounts[iproc] += nper;
+    }
+
+  MPI_Alltoallv(sendbuf,sendcounts,senddispls,MPI_DOUBLE,
+                recvbuf,recvcounts,recvdispls,MPI_DOUBLE,world);
+
+  for (i = 0; i < nown; i++) {
+    count[i] = 0.0;
+    for (j = 0; j < nvalues; j++) values[i][j] = 0.0;
+  }
+
+  for (i = 0; i < nrecv; i += nper) {
+    b = static_cast<int> (recvbuf[i]) - olo;
+    count[b] += recvbuf[i+1];
+    for (j = 0; j < nvalues; j++) values[b][j] += recvbuf[i+j+2];
+  }
+}
+
+/* ----------------------------------------------------------------------
+   write bins I own to file, for parallel = yes
+   each proc formats its lines, proc 0 writes them in order of procs
+------------------------------------------------------------------------- */
+
+void FixAveSpatial::write_bins(bigint ntimestep)
+{
+  int i,k,m,ibin,tmp,nchars,nmax;
+  int stride[3];
+  MPI_Status status;
+  MPI_Request request;
+
+  stride[ndim-1] = 1;
+  for (m = ndim-2; m >= 0; m--) stride[m] = stride[m+1]*nlayers[m+1];
+
+  // line = bin ID, Ndim coords, count, Nvalues, with at most 16 chars each
+
+  bigint nbytes = (bigint) nown * 16*(ndim+nvalues+2) + 1;
+  if (nbytes > MAXSMALLINT)
+    error->one(FLERR,"Too much per-proc output in fix ave/spatial");
+  if (nbytes > maxsbuf) {
+    maxsbuf = nbytes;
+    memory->grow(sbuf,maxsbuf,"ave/spatial:sbuf");
+  }
+
+  int n = 0;
+  for (m = 0; m < nown; m++) {
+    ibin = olo + m;
+    n += sprintf(&sbuf[n],"  %d",ibin+1);
+    for (k = 0; k < ndim; k++)
+      n += sprintf(&sbuf[n]," %g",
+                   offset[k] + (ibin/stride[k] % nlayers[k] + 0.5)*delta[k]);
+    n += sprintf(&sbuf[n]," %g",count_total[m]/norm);
+    for (i = 0; i < nvalues; i++)
+      n += sprintf(&sbuf[n]," %g",values_total[m][i]/norm);
+    n += sprintf(&sbuf[n],"\n");
+  }
+
+  MPI_Allreduce(&n,&nmax,1,MPI_INT,MPI_MAX,world);
+
+  if (me == 0) {
+    if (overwrite) fseek(fp,filepos,SEEK_SET);
+    fprintf(fp,BIGINT_FORMAT " %d\n",ntimestep,nbins);
+    fwrite(sbuf,sizeof(char),n,fp);
+
+    if (nmax+1 > maxsbuf) {
+      maxsbuf = nmax+1;
+      memory->grow(sbuf,maxsbuf,"ave/spatial:sbuf");
+    }
+
+    for (int iproc = 1; iproc < nprocs; iproc++) {
+      MPI_Irecv(sbuf,nmax,MPI_CHAR,iproc,0,world,&request);
+      MPI_Send(&tmp,0,MPI_INT,iproc,0,world);
+      MPI_Wait(&request,&status);
+      MPI_Get_count(&status,MPI_CHAR,&nchars);
+      fwrite(sbuf,sizeof(char),nchars,fp);
+    }
+
+    fflush(fp);
+    if (overwrite) {
+      long fileend = ftell(fp);
+      ftruncate(fileno(fp),fileend);
+    }
+
+  } else {
+    MPI_Recv(&tmp,0,MPI_INT,0,0,world,&status);
+    MPI_Rsend(sbuf,n,MPI_CHAR,0,0,world);
+  }
+}
+
 /* ----------------------------------------------------------------------
    assign each atom to a 1d bin
 ------------------------------------------------------------------------- */
@@ -1012,7 +1373,6 @@ void FixAveSpatial::atom2bin1d()
         ibin = MAX(ibin,0);
         ibin = MIN(ibin,nlayerm1);
         bin[i] = ibin;
-        count_one[ibin] += 1.0;
       }
     if (scaleflag == REDUCED) domain->lamda2x(nlocal);
 
@@ -1031,7 +1391,6 @@ void FixAveSpatial::atom2bin1d()
         ibin = MAX(ibin,0);
         ibin = MIN(ibin,nlayerm1);
         bin[i] = ibin;
-        count_one[ibin] += 1.0;
       }
   }
 }
@@ -1096,7 +1455,6 @@ void FixAveSpatial::atom2bin2d()
 
         ibin = i1bin*nlayers[1] + i2bin;
         bin[i] = ibin;
-        count_one[ibin] += 1.0;
       }
     if (scaleflag == REDUCED) domain->lamda2x(nlocal);
 
@@ -1130,7 +1488,6 @@ void FixAveSpatial::atom2bin2d()
 
         ibin = i1bin*nlayers[1] + i2bin;
         bin[i] = ibin;
-        count_one[ibin] += 1.0;
       }
   }
 }
@@ -1206,7 +1563,6 @@ void FixAveSpatial::atom2bin3d()
 
         ibin = i1bin*nlayers[1]*nlayers[2] + i2bin*nlayers[2] + i3bin;
         bin[i] = ibin;
-        count_one[ibin] += 1.0;
       }
     if (scaleflag == REDUCED) domain->lamda2x(nlocal);
 
@@ -1250,7 +1606,6 @@ void FixAveSpatial::atom2bin3d()
 
         ibin = i1bin*nlayers[1]*nlayers[2] + i2bin*nlayers[2] + i3bin;
         bin[i] = ibin;
-        count_one[ibin] += 1.0;
       }
   }
 }
@@ -1297,6 +1652,17 @@ double FixAveSpatial::memory_usage()
 {
   double bytes = maxvar * sizeof(double);         // varatom
   bytes += maxatom * sizeof(int);                 // bin
+  if (parallel) {
+    bytes += maxbox * sizeof(double);             // count one
+    bytes += 3*nown * sizeof(double);             // count many,sum,total
+    bytes += nvalues*maxbox * sizeof(double);     // values one
+    bytes += 3*nvalues*nown * sizeof(double);     // values many,sum,total
+    bytes += (maxsend+maxrecv) * sizeof(double);  // send/recv bufs
+    bytes += maxsbuf * sizeof(char);              // sbuf
+    bytes += nwindow*nown * sizeof(double);          // count_list
+    bytes += nwindow*nown*nvalues * sizeof(double);  // values_list
+    return bytes;
+  }
   bytes += 4*nbins * sizeof(double);              // count one,many,sum,total
   bytes += ndim*nbins * sizeof(double);           // coord
   bytes += nvalues*nbins * sizeof(double);        // values one,many,sum,total
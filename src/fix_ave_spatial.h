@@ -38,10 +38,10 @@ class FixAveSpatial : public Fix {
   void reset_timestep(bigint);
 
  private:
-  int me,nvalues;
+  int me,nprocs,nvalues;
   int nrepeat,nfreq,irepeat;
   bigint nvalid;
-  int ndim,normflag,regionflag,overwrite;
+  int ndim,normflag,regionflag,overwrite,fileflag;
   char *tstring,*sstring,*idregion;
   int *which,*argindex,*value2index;
   char **ids;
@@ -65,16 +65,31 @@ class FixAveSpatial : public Fix {
   int *bin;
 
   int nbins,maxbin;
+  int parallel;              // 1 if bins are distributed across procs
+  int olo,nown;              // global range of bins whose averages I store
+  int bstart[3],bnum[3];     // per-dim bins my atoms are accumulated into
+  int nbox,maxbox;           // # of bins in that box
+  int maxoccupy;
+  int *occupy;
   double **coord;
   double *count_one,*count_many,*count_sum;
   double **values_one,**values_many,**values_sum;
   double *count_total,**count_list;
   double **values_total,***values_list;
 
+  int *sendcounts,*senddispls,*recvcounts,*recvdispls;
+  int maxsend,maxrecv,maxsbuf;
+  double *sendbuf,*recvbuf;
+  char *sbuf;
+
   void setup_bins();
   void atom2bin1d();
   void atom2bin2d();
   void atom2bin3d();
+  void setup_box();
+  int box2bin(int);
+  void reduce_bins(double *, double **);
+  void write_bins(bigint);
   bigint nextvalid();
 };
 
@@ -170,6 +185,11 @@ E: Fix for fix ave/spatial not computed at compatible time
 Fixes generate their values on specific timesteps.  Fix ave/spatial is
 requesting a value on a non-allowed timestep.
 
+E: Too much per-proc output in fix ave/spatial
+
+The formatted output of the bins owned by one processor with parallel
+yes must fit in a 32-bit integer number of bytes.
+
 E: Fix ave/spatial missed timestep
 
 You cannot reset the timestep to a value beyond where the fix
@@ -15,6 +15,7 @@
    Contributing author: Pieter in 't Veld (SNL)
 ------------------------------------------------------------------------- */
 
+#include "math.h"
 #include "stdlib.h"
 #include "string.h"
 #include "unistd.h"
@@ -33,7 +34,7 @@ using namespace LAMMPS_NS;
 using namespace FixConst;
 
 enum{COMPUTE,FIX,VARIABLE};
-enum{ONE,RUNNING,WINDOW};
+enum{ONE,RUNNING,WINDOW,EXP};
 enum{SCALAR,VECTOR};
 
 #define INVOKED_SCALAR 1
@@ -78,6 +79,8 @@ FixAveTime::FixAveTime(LAMMPS *lmp, int narg, char **arg) :
   //   adjust nvalues accordingly via maxvalues
 
   which = argindex = value2index = offcol = NULL;
+  compute_invoked = NULL;
+  computes = NULL;
   ids = NULL;
   int maxvalues = nvalues;
   allocate_values(maxvalues);
@@ -173,6 +176,10 @@ FixAveTime::FixAveTime(LAMMPS *lmp, int narg, char **arg) :
     error->all(FLERR,"Illegal fix ave/time command");
   if (ave != RUNNING && overwrite)
     error->all(FLERR,"Illegal fix ave/time command");
+  if (stddevflag && mode != SCALAR)
+    error->all(FLERR,"Fix ave/time stddev requires mode scalar");
+  if (stddevflag && ave == EXP)
+    error->all(FLERR,"Fix ave/time stddev cannot be used with ave exp");
 
   for (int i = 0; i < nvalues; i++) {
     if (which[i] == COMPUTE && mode == SCALAR) {
@@ -273,6 +280,8 @@ FixAveTime::FixAveTime(LAMMPS *lmp, int narg, char **arg) :
     else if (mode == SCALAR) {
       fprintf(fp,"# TimeStep");
       for (int i = 0; i < nvalues; i++) fprintf(fp," %s",arg[6+i]);
+      if (stddevflag)
+        for (int i = 0; i < nvalues; i++) fprintf(fp," stddev_%s",arg[6+i]);
       fprintf(fp,"\n");
     } else fprintf(fp,"# TimeStep Number-of-rows\n");
     if (title3 && mode == VECTOR) fprintf(fp,"%s\n",title3);
@@ -297,19 +306,32 @@ FixAveTime::FixAveTime(LAMMPS *lmp, int narg, char **arg) :
 
   vector = vector_total = NULL;
   vector_list = NULL;
+  vector_comp = vector_m2 = m2_total = NULL;
+  m2_list = NULL;
   array = array_total = NULL;
   array_list = NULL;
+  array_comp = NULL;
 
   if (mode == SCALAR) {
     vector = new double[nvalues];
     vector_total = new double[nvalues];
     if (ave == WINDOW)
       memory->create(vector_list,nwindow,nvalues,"ave/time:vector_list");
+    if (stable && ave == RUNNING)
+      memory->create(vector_comp,nvalues,"ave/time:vector_comp");
+    if (stddevflag) {
+      memory->create(vector_m2,nvalues,"ave/time:vector_m2");
+      memory->create(m2_total,nvalues,"ave/time:m2_total");
+      if (ave == WINDOW)
+        memory->create(m2_list,nwindow,nvalues,"ave/time:m2_list");
+    }
   } else {
     memory->create(array,nrows,nvalues,"ave/time:array");
     memory->create(array_total,nrows,nvalues,"ave/time:array_total");
     if (ave == WINDOW)
       memory->create(array_list,nwindow,nrows,nvalues,"ave/time:array_list");
+    if (stable && ave == RUNNING)
+      memory->create(array_comp,nrows,nvalues,"ave/time:array_comp");
   }
 
   // this fix produces either a global scalar or vector or array
@@ -320,7 +342,7 @@ FixAveTime::FixAveTime(LAMMPS *lmp, int narg, char **arg) :
   extlist = NULL;
 
   if (mode == SCALAR) {
-    if (nvalues == 1) {
+    if (nvalues == 1 && !stddevflag) {
       scalar_flag = 1;
       if (which[0] == COMPUTE) {
         Compute *compute = modify->compute[modify->find_compute(ids[0])];
@@ -338,8 +360,9 @@ FixAveTime::FixAveTime(LAMMPS *lmp, int narg, char **arg) :
     } else {
       vector_flag = 1;
       size_vector = nvalues;
+      if (stddevflag) size_vector = 2*nvalues;
       extvector = -1;
-      extlist = new int[nvalues];
+      extlist = new int[size_vector];
       for (int i = 0; i < nvalues; i++) {
         if (which[i] == COMPUTE) {
           Compute *compute = modify->compute[modify->find_compute(ids[i])];
@@ -353,6 +376,7 @@ FixAveTime::FixAveTime(LAMMPS *lmp, int narg, char **arg) :
           else extlist[i] = fix->extlist[argindex[i]-1];
         } else if (which[i] == VARIABLE)
           extlist[i] = 0;
+        if (stddevflag) extlist[nvalues+i] = extlist[i];
       }
     }
 
@@ -413,11 +437,19 @@ FixAveTime::FixAveTime(LAMMPS *lmp, int narg, char **arg) :
   iwindow = window_limit = 0;
   norm = 0;
 
-  if (mode == SCALAR)
+  if (mode == SCALAR) {
     for (int i = 0; i < nvalues; i++) vector_total[i] = 0.0;
-  else
+    if (vector_comp)
+      for (int i = 0; i < nvalues; i++) vector_comp[i] = 0.0;
+    if (m2_total)
+      for (int i = 0; i < nvalues; i++) m2_total[i] = 0.0;
+  } else {
     for (int i = 0; i < nrows; i++)
       for (int j = 0; j < nvalues; j++) array_total[i][j] = 0.0;
+    if (array_comp)
+      for (int i = 0; i < nrows; i++)
+        for (int j = 0; j < nvalues; j++) array_comp[i][j] = 0.0;
+  }
 
   // nvalid = next step on which end_of_step does something
   // add nvalid to all computes that store invocation times
@@ -436,6 +468,8 @@ FixAveTime::~FixAveTime()
   memory->destroy(argindex);
   memory->destroy(value2index);
   memory->destroy(offcol);
+  memory->destroy(compute_invoked);
+  memory->sfree(computes);
   for (int i = 0; i < nvalues; i++) delete [] ids[i];
   memory->sfree(ids);
 
@@ -446,9 +480,15 @@ FixAveTime::~FixAveTime()
   delete [] vector;
   delete [] vector_total;
   delete [] column;
+  memory->destroy(vector_list);
+  memory->destroy(vector_comp);
+  memory->destroy(vector_m2);
+  memory->destroy(m2_total);
+  memory->destroy(m2_list);
   memory->destroy(array);
   memory->destroy(array_total);
   memory->destroy(array_list);
+  memory->destroy(array_comp);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -472,18 +512,28 @@ void FixAveTime::init()
       if (icompute < 0)
         error->all(FLERR,"Compute ID for fix ave/time does not exist");
       value2index[i] = icompute;
+      computes[i] = modify->compute[icompute];
+      if (mode == SCALAR) {
+        if (argindex[i] == 0) compute_invoked[i] = INVOKED_SCALAR;
+        else compute_invoked[i] = INVOKED_VECTOR;
+      } else {
+        if (argindex[i] == 0) compute_invoked[i] = INVOKED_VECTOR;
+        else compute_invoked[i] = INVOKED_ARRAY;
+      }
 
     } else if (which[i] == FIX) {
       int ifix = modify->find_fix(ids[i]);
       if (ifix < 0)
         error->all(FLERR,"Fix ID for fix ave/time does not exist");
       value2index[i] = ifix;
+      computes[i] = NULL;
 
     } else if (which[i] == VARIABLE) {
       int ivariable = input->variable->find(ids[i]);
       if (ivariable < 0)
         error->all(FLERR,"Variable name for fix ave/time does not exist");
       value2index[i] = ivariable;
+      computes[i] = NULL;
     }
   }
 
@@ -527,13 +577,17 @@ void FixAveTime::invoke_scalar(bigint ntimestep)
 
   // zero if first step
 
-  if (irepeat == 0)
+  if (irepeat == 0) {
     for (i = 0; i < nvalues; i++) vector[i] = 0.0;
+    if (stddevflag)
+      for (i = 0; i < nvalues; i++) vector_m2[i] = 0.0;
+  }
 
   // accumulate results of computes,fixes,variables to local copy
   // compute/fix/variable may invoke computes so wrap with clear/add
 
   modify->clearstep_compute();
+  modify->reduce_computes(nvalues,computes,compute_invoked);
 
   for (i = 0; i < nvalues; i++) {
     m = value2index[i];
@@ -571,9 +625,14 @@ void FixAveTime::invoke_scalar(bigint ntimestep)
       scalar = input->variable->compute_equal(m);
 
     // add value to vector or just set directly if offcol is set
+    // if stable, vector is the running mean of the samples (Welford)
 
     if (offcol[i]) vector[i] = scalar;
-    else vector[i] += scalar;
+    else if (stable) {
+      double delta = scalar - vector[i];
+      vector[i] += delta/(irepeat+1);
+      if (stddevflag) vector_m2[i] += delta*(scalar - vector[i]);
+    } else vector[i] += scalar;
   }
 
   // done if irepeat < nrepeat
@@ -593,26 +652,52 @@ void FixAveTime::invoke_scalar(bigint ntimestep)
   // average the final result for the Nfreq timestep
 
   double repeat = nrepeat;
-  for (i = 0; i < nvalues; i++)
-    if (offcol[i] == 0) vector[i] /= repeat;
+  if (!stable)
+    for (i = 0; i < nvalues; i++)
+      if (offcol[i] == 0) vector[i] /= repeat;
 
   // if ave = ONE, only single Nfreq timestep value is needed
   // if ave = RUNNING, combine with all previous Nfreq timestep values
   // if ave = WINDOW, combine with nwindow most recent Nfreq timestep values
+  // if ave = EXP, exponential average with weight 1/M for newest value
+  // if stable, RUNNING uses compensated sums and WINDOW re-sums its values
+  // if stddev, also combine squared deviations of each Nfreq block
 
   if (ave == ONE) {
     for (i = 0; i < nvalues; i++) vector_total[i] = vector[i];
+    if (stddevflag)
+      for (i = 0; i < nvalues; i++) m2_total[i] = vector_m2[i];
     norm = 1;
 
   } else if (ave == RUNNING) {
-    for (i = 0; i < nvalues; i++) vector_total[i] += vector[i];
+    if (stddevflag && norm) {
+      double factor = repeat*norm/(norm+1);
+      for (i = 0; i < nvalues; i++) {
+        double delta = vector[i] - vector_total[i]/norm;
+        m2_total[i] += vector_m2[i] + delta*delta*factor;
+      }
+    } else if (stddevflag)
+      for (i = 0; i < nvalues; i++) m2_total[i] = vector_m2[i];
+
+    if (stable)
+      for (i = 0; i < nvalues; i++) {
+        double y = vector[i] - vector_comp[i];
+        double t = vector_total[i] + y;
+        vector_comp[i] = (t - vector_total[i]) - y;
+        vector_total[i] = t;
+      }
+    else
+      for (i = 0; i < nvalues; i++) vector_total[i] += vector[i];
     norm++;
 
   } else if (ave == WINDOW) {
     for (i = 0; i < nvalues; i++) {
-      vector_total[i] += vector[i];
-      if (window_limit) vector_total[i] -= vector_list[iwindow][i];
+      if (!stable) {
+        vector_total[i] += vector[i];
+        if (window_limit) vector_total[i] -= vector_list[iwindow][i];
+      }
       vector_list[iwindow][i] = vector[i];
+      if (stddevflag) m2_list[iwindow][i] = vector_m2[i];
     }
 
     iwindow++;
@@ -622,6 +707,27 @@ void FixAveTime::invoke_scalar(bigint ntimestep)
     }
     if (window_limit) norm = nwindow;
     else norm = iwindow;
+
+    if (stable)
+      for (i = 0; i < nvalues; i++)
+        vector_total[i] = pairwise(&vector_list[0][i],norm,nvalues);
+
+    if (stddevflag)
+      for (i = 0; i < nvalues; i++) {
+        double mean = vector_total[i]/norm;
+        double sum = 0.0;
+        for (m = 0; m < norm; m++) {
+          double delta = vector_list[m][i] - mean;
+          sum += m2_list[m][i] + repeat*delta*delta;
+        }
+        m2_total[i] = sum;
+      }
+
+  } else if (ave == EXP) {
+    if (iwindow < nwindow) iwindow++;
+    for (i = 0; i < nvalues; i++)
+      vector_total[i] += (vector[i] - vector_total[i])/iwindow;
+    norm = 1;
   }
 
   // insure any columns with offcol set are effectively set to last value
@@ -635,6 +741,8 @@ void FixAveTime::invoke_scalar(bigint ntimestep)
     if (overwrite) fseek(fp,filepos,SEEK_SET);
     fprintf(fp,BIGINT_FORMAT,ntimestep);
     for (i = 0; i < nvalues; i++) fprintf(fp," %g",vector_total[i]/norm);
+    if (stddevflag)
+      for (i = 0; i < nvalues; i++) fprintf(fp," %g",stddev(i));
     fprintf(fp,"\n");
     fflush(fp);
     if (overwrite) {
@@ -660,6 +768,7 @@ void FixAveTime::invoke_vector(bigint ntimestep)
   // compute/fix/variable may invoke computes so wrap with clear/add
 
   modify->clearstep_compute();
+  modify->reduce_computes(nvalues,computes,compute_invoked);
 
   for (j = 0; j < nvalues; j++) {
     m = value2index[j];
@@ -708,6 +817,9 @@ void FixAveTime::invoke_vector(bigint ntimestep)
     if (offcol[j]) {
       for (i = 0; i < nrows; i++)
         array[i][j] = column[i];
+    } else if (stable) {
+      for (i = 0; i < nrows; i++)
+        array[i][j] += (column[i] - array[i][j])/(irepeat+1);
     } else {
       for (i = 0; i < nrows; i++)
         array[i][j] += column[i];
@@ -731,13 +843,16 @@ void FixAveTime::invoke_vector(bigint ntimestep)
   // average the final result for the Nfreq timestep
 
   double repeat = nrepeat;
-  for (i = 0; i < nrows; i++)
-    for (j = 0; j < nvalues; j++)
-      if (offcol[j] == 0) array[i][j] /= repeat;
+  if (!stable)
+    for (i = 0; i < nrows; i++)
+      for (j = 0; j < nvalues; j++)
+        if (offcol[j] == 0) array[i][j] /= repeat;
 
   // if ave = ONE, only single Nfreq timestep value is needed
   // if ave = RUNNING, combine with all previous Nfreq timestep values
   // if ave = WINDOW, combine with nwindow most recent Nfreq timestep values
+  // if ave = EXP, exponential average with weight 1/M for newest value
+  // if stable, RUNNING uses compensated sums and WINDOW re-sums its values
 
   if (ave == ONE) {
     for (i = 0; i < nrows; i++)
@@ -745,15 +860,26 @@ void FixAveTime::invoke_vector(bigint ntimestep)
     norm = 1;
 
   } else if (ave == RUNNING) {
-    for (i = 0; i < nrows; i++)
-      for (j = 0; j < nvalues; j++) array_total[i][j] += array[i][j];
+    if (stable)
+      for (i = 0; i < nrows; i++)
+        for (j = 0; j < nvalues; j++) {
+          double y = array[i][j] - array_comp[i][j];
+          double t = array_total[i][j] + y;
+          array_comp[i][j] = (t - array_total[i][j]) - y;
+          array_total[i][j] = t;
+        }
+    else
+      for (i = 0; i < nrows; i++)
+        for (j = 0; j < nvalues; j++) array_total[i][j] += array[i][j];
     norm++;
 
   } else if (ave == WINDOW) {
     for (i = 0; i < nrows; i++)
       for (j = 0; j < nvalues; j++) {
-        array_total[i][j] += array[i][j];
-        if (window_limit) array_total[i][j] -= array_list[iwindow][i][j];
+        if (!stable) {
+          array_total[i][j] += array[i][j];
+          if (window_limit) array_total[i][j] -= array_list[iwindow][i][j];
+        }
         array_list[iwindow][i][j] = array[i][j];
       }
 
@@ -764,6 +890,19 @@ void FixAveTime::invoke_vector(bigint ntimestep)
     }
     if (window_limit) norm = nwindow;
     else norm = iwindow;
+
+    if (stable)
+      for (i = 0; i < nrows; i++)
+        for (j = 0; j < nvalues; j++)
+          array_total[i][j] =
+            pairwise(&array_list[0][i][j],norm,nrows*nvalues);
+
+  } else if (ave == EXP) {
+    if (iwindow < nwindow) iwindow++;
+    for (i = 0; i < nrows; i++)
+      for (j = 0; j < nvalues; j++)
+        array_total[i][j] += (array[i][j] - array_total[i][j])/iwindow;
+    norm = 1;
   }
 
   // insure any columns with offcol set are effectively set to last value
@@ -803,7 +942,10 @@ double FixAveTime::compute_scalar()
 double FixAveTime::compute_vector(int i)
 {
   if (norm) {
-    if (mode == SCALAR) return vector_total[i]/norm;
+    if (mode == SCALAR) {
+      if (i >= nvalues) return stddev(i-nvalues);
+      return vector_total[i]/norm;
+    }
     if (mode == VECTOR) return array_total[i][0];
   }
   return 0.0;
@@ -819,6 +961,34 @@ double FixAveTime::compute_array(int i, int j)
   return 0.0;
 }
 
+/* ----------------------------------------------------------------------
+   return standard deviation of samples that were averaged for value I
+------------------------------------------------------------------------- */
+
+double FixAveTime::stddev(int i)
+{
+  double nsample = (double) norm*nrepeat;
+  if (offcol[i] || nsample < 2.0) return 0.0;
+  return sqrt(m2_total[i]/(nsample-1.0));
+}
+
+/* ----------------------------------------------------------------------
+   pairwise sum of N values that are stride apart
+   rounding error grows as log(N) instead of N for a sequential sum
+------------------------------------------------------------------------- */
+
+double FixAveTime::pairwise(double *values, int n, int stride)
+{
+  if (n <= 8) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) sum += values[i*stride];
+    return sum;
+  }
+  int half = n/2;
+  return pairwise(values,half,stride) +
+    pairwise(&values[half*stride],n-half,stride);
+}
+
 /* ----------------------------------------------------------------------
    parse optional args
 ------------------------------------------------------------------------- */
@@ -834,6 +1004,8 @@ void FixAveTime::options(int narg, char **arg)
   noff = 0;
   offlist = NULL;
   overwrite = 0;
+  stable = 0;
+  stddevflag = 0;
   title1 = NULL;
   title2 = NULL;
   title3 = NULL;
@@ -858,14 +1030,15 @@ void FixAveTime::options(int narg, char **arg)
       if (strcmp(arg[iarg+1],"one") == 0) ave = ONE;
       else if (strcmp(arg[iarg+1],"running") == 0) ave = RUNNING;
       else if (strcmp(arg[iarg+1],"window") == 0) ave = WINDOW;
+      else if (strcmp(arg[iarg+1],"exp") == 0) ave = EXP;
       else error->all(FLERR,"Illegal fix ave/time command");
-      if (ave == WINDOW) {
+      if (ave == WINDOW || ave == EXP) {
         if (iarg+3 > narg) error->all(FLERR,"Illegal fix ave/time command");
         nwindow = force->inumeric(FLERR,arg[iarg+2]);
         if (nwindow <= 0) error->all(FLERR,"Illegal fix ave/time command");
       }
       iarg += 2;
-      if (ave == WINDOW) iarg++;
+      if (ave == WINDOW || ave == EXP) iarg++;
     } else if (strcmp(arg[iarg],"start") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal fix ave/time command");
       startstep = force->inumeric(FLERR,arg[iarg+1]);
@@ -884,6 +1057,18 @@ void FixAveTime::options(int narg, char **arg)
     } else if (strcmp(arg[iarg],"overwrite") == 0) {
       overwrite = 1;
       iarg += 1;
+    } else if (strcmp(arg[iarg],"stable") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix ave/time command");
+      if (strcmp(arg[iarg+1],"yes") == 0) stable = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) stable = 0;
+      else error->all(FLERR,"Illegal fix ave/time command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"stddev") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix ave/time command");
+      if (strcmp(arg[iarg+1],"yes") == 0) stddevflag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) stddevflag = 0;
+      else error->all(FLERR,"Illegal fix ave/time command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"title1") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal fix ave/spatial command");
       delete [] title1;
@@ -907,6 +1092,10 @@ void FixAveTime::options(int narg, char **arg)
       iarg += 2;
     } else error->all(FLERR,"Illegal fix ave/time command");
   }
+
+  // stddev uses Welford's method for the samples, so is always stable
+
+  if (stddevflag) stable = 1;
 }
 
 /* ----------------------------------------------------------------------
@@ -919,6 +1108,9 @@ void FixAveTime::allocate_values(int n)
   memory->grow(argindex,n,"ave/time:argindex");
   memory->grow(value2index,n,"ave/time:value2index");
   memory->grow(offcol,n,"ave/time:offcol");
+  memory->grow(compute_invoked,n,"ave/time:compute_invoked");
+  computes = (Compute **)
+    memory->srealloc(computes,n*sizeof(Compute *),"ave/time:computes");
   ids = (char **) memory->srealloc(ids,n*sizeof(char *),"ave/time:ids");
 }
 
@@ -44,11 +44,14 @@ class FixAveTime : public Fix {
   bigint nvalid;
   int *which,*argindex,*value2index,*offcol;
   char **ids;
+  class Compute **computes;    // compute for each value, NULL if not compute
+  int *compute_invoked;        // INVOKED_SCALAR/VECTOR/ARRAY for each compute
   FILE *fp;
   int nrows;
 
   int ave,nwindow,startstep,mode;
   int noff,overwrite;
+  int stable,stddevflag;
   int *offlist;
   char *title1,*title2,*title3;
   long filepos;
@@ -57,15 +60,22 @@ class FixAveTime : public Fix {
   double *vector;
   double *vector_total;
   double **vector_list;
+  double *vector_comp;         // Kahan compensation of running totals
+  double *vector_m2;           // sum of squared deviations of samples
+  double *m2_total;
+  double **m2_list;
   double *column;
   double **array;
   double **array_total;
   double ***array_list;
+  double **array_comp;
 
   void invoke_scalar(bigint);
   void invoke_vector(bigint);
   void options(int, char **);
   void allocate_values(int);
+  double stddev(int);
+  double pairwise(double *, int, int);
   bigint nextvalid();
 };
 
@@ -147,6 +157,15 @@ E: Fix ave/time variable is not equal-style variable
 
 Self-explanatory.
 
+E: Fix ave/time stddev requires mode scalar
+
+Standard deviations can only be computed for scalar input values.
+
+E: Fix ave/time stddev cannot be used with ave exp
+
+Standard deviations are only computed for ave one, running, or
+window.
+
 E: Fix ave/time cannot use variable with vector mode
 
 Variables produce scalar values.
@@ -306,6 +306,17 @@ double FixBalance::compute_vector(int i)
   return imbprev;
 }
 
+/* ----------------------------------------------------------------------
+   rebalancing interval, can be changed during a run by fix tune/neigh
+------------------------------------------------------------------------- */
+
+void *FixBalance::extract(const char *str, int &dim)
+{
+  dim = 0;
+  if (strcmp(str,"nevery") == 0) return &nevery;
+  return NULL;
+}
+
 /* ----------------------------------------------------------------------
    return # of bytes of allocated memory
 ------------------------------------------------------------------------- */
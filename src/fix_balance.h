@@ -38,6 +38,7 @@ class FixBalance : public Fix {
   double compute_scalar();
   double compute_vector(int);
   double memory_usage();
+  void *extract(const char *, int &);
 
  private:
   int nevery,lbstyle,nitermax,outflag;
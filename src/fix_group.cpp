@@ -185,19 +185,29 @@ void FixGroup::set_group()
     modify->addstep_compute(update->ntimestep + nevery);
   }
   
+  // test all atoms against region at once
+
+  double **x = atom->x;
+  int *rflag = NULL;
+
+  if (regionflag) {
+    region->prematch();
+    memory->create(rflag,nlocal,"fix/group:rflag");
+    region->match_many(x,nlocal,rflag);
+  }
+
   // set mask for each atom
   // only in group if in parent group, in region, variable is non-zero
   // if compute, fix, etc needs updated masks of ghost atoms,
   // it must do forward_comm() to update them
 
-  double **x = atom->x;
   int *mask = atom->mask;
   int inflag;
 
   for (int i = 0; i < nlocal; i++) {
     if (mask[i] & groupbit) {
       inflag = 1;
-      if (regionflag && !region->match(x[i][0],x[i][1],x[i][2])) inflag = 0;
+      if (regionflag && !rflag[i]) inflag = 0;
       if (varflag && var[i] == 0.0) inflag = 0;
     } else inflag = 0;
 
@@ -206,4 +216,5 @@ void FixGroup::set_group()
   }
 
   if (varflag) memory->destroy(var);
+  if (regionflag) memory->destroy(rflag);
 }
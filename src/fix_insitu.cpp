@@ -0,0 +1,206 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "stdio.h"
+#include "string.h"
+#include "stdlib.h"
+#include "fix_insitu.h"
+#include "atom.h"
+#include "update.h"
+#include "force.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace LAMMPS_NS;
+using namespace FixConst;
+
+/* ---------------------------------------------------------------------- */
+
+FixInsitu::FixInsitu(LAMMPS *lmp, int narg, char **arg) :
+  Fix(lmp, narg, arg)
+{
+  if (narg < 5) error->all(FLERR,"Illegal fix insitu command");
+
+  nevery = force->inumeric(FLERR,arg[3]);
+  if (nevery <= 0) error->all(FLERR,"Illegal fix insitu command");
+
+  // stages to make callbacks from, up to fields keyword
+
+  stagemask = 0;
+  int iarg = 4;
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"fields") == 0) break;
+    if (strcmp(arg[iarg],"pre_exchange") == 0) stagemask |= PRE_EXCHANGE;
+    else if (strcmp(arg[iarg],"pre_neighbor") == 0) stagemask |= PRE_NEIGHBOR;
+    else if (strcmp(arg[iarg],"post_integrate") == 0)
+      stagemask |= POST_INTEGRATE;
+    else if (strcmp(arg[iarg],"pre_force") == 0) stagemask |= PRE_FORCE;
+    else if (strcmp(arg[iarg],"post_force") == 0) stagemask |= POST_FORCE;
+    else if (strcmp(arg[iarg],"end_of_step") == 0) stagemask |= END_OF_STEP;
+    else error->all(FLERR,"Illegal fix insitu command");
+    iarg++;
+  }
+  if (stagemask == 0) error->all(FLERR,"Illegal fix insitu command");
+
+  // pre_exchange and pre_neighbor are only reached on reneighboring steps,
+  //   so force reneighboring every nevery steps for them
+
+  if (stagemask & (PRE_EXCHANGE | PRE_NEIGHBOR)) force_reneighbor = 1;
+
+  // requested per-atom fields
+
+  int nfield = 0;
+  char **names = NULL;
+  if (iarg < narg) {
+    iarg++;
+    nfield = narg - iarg;
+    if (nfield == 0) error->all(FLERR,"Illegal fix insitu command");
+    names = new char*[nfield];
+    for (int m = 0; m < nfield; m++) {
+      int n = strlen(arg[iarg+m]) + 1;
+      names[m] = new char[n];
+      strcpy(names[m],arg[iarg+m]);
+    }
+  }
+
+  data.nfield = nfield;
+  data.names = names;
+  data.groupbit = groupbit;
+  memory->create(data.types,nfield,"insitu:types");
+  memory->create(data.counts,nfield,"insitu:counts");
+  data.ptrs = new void*[nfield];
+
+  callback = NULL;
+  ptr_caller = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+FixInsitu::~FixInsitu()
+{
+  for (int m = 0; m < data.nfield; m++) delete [] data.names[m];
+  delete [] data.names;
+  memory->destroy(data.types);
+  memory->destroy(data.counts);
+  delete [] data.ptrs;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int FixInsitu::setmask()
+{
+  return stagemask;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixInsitu::init()
+{
+  if (callback == NULL)
+    error->all(FLERR,"Fix insitu callback function not set");
+
+  char str[128];
+  int type,count;
+  for (int m = 0; m < data.nfield; m++)
+    if (atom->extract_local(data.names[m],type,count) == NULL) {
+      sprintf(str,"Fix insitu field %s is not defined by atom style",
+              data.names[m]);
+      error->all(FLERR,str);
+    }
+
+  // next_reneighbor = next time to force reneighboring
+
+  if (force_reneighbor)
+    next_reneighbor = (update->ntimestep/nevery)*nevery + nevery;
+}
+
+/* ----------------------------------------------------------------------
+   pre_exchange and pre_neighbor are only called on reneighboring steps,
+     which are forced on multiples of nevery, but may occur in between
+------------------------------------------------------------------------- */
+
+void FixInsitu::pre_exchange()
+{
+  if (update->ntimestep % nevery) return;
+  next_reneighbor = (update->ntimestep/nevery)*nevery + nevery;
+  invoke("pre_exchange");
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixInsitu::pre_neighbor()
+{
+  if (update->ntimestep % nevery) return;
+  next_reneighbor = (update->ntimestep/nevery)*nevery + nevery;
+  invoke("pre_neighbor");
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixInsitu::post_integrate()
+{
+  if (update->ntimestep % nevery) return;
+  invoke("post_integrate");
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixInsitu::pre_force(int vflag)
+{
+  if (update->ntimestep % nevery) return;
+  invoke("pre_force");
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixInsitu::post_force(int vflag)
+{
+  if (update->ntimestep % nevery) return;
+  invoke("post_force");
+}
+
+/* ----------------------------------------------------------------------
+   Modify only calls end_of_step() on multiples of nevery
+------------------------------------------------------------------------- */
+
+void FixInsitu::end_of_step()
+{
+  invoke("end_of_step");
+}
+
+/* ----------------------------------------------------------------------
+   refresh field pointers, since per-atom arrays may have been
+     reallocated since the last call, then invoke the callback
+------------------------------------------------------------------------- */
+
+void FixInsitu::invoke(const char *stage)
+{
+  data.ntimestep = update->ntimestep;
+  data.stage = stage;
+  data.nlocal = atom->nlocal;
+  data.mask = atom->mask;
+
+  for (int m = 0; m < data.nfield; m++)
+    data.ptrs[m] = atom->extract_local(data.names[m],data.types[m],
+                                       data.counts[m]);
+
+  (this->callback)(ptr_caller,&data);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixInsitu::set_callback(FnPtr caller_callback, void *caller_ptr)
+{
+  callback = caller_callback;
+  ptr_caller = caller_ptr;
+}
@@ -0,0 +1,90 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef FIX_CLASS
+
+FixStyle(insitu,FixInsitu)
+
+#else
+
+#ifndef LMP_FIX_INSITU_H
+#define LMP_FIX_INSITU_H
+
+#include "fix.h"
+
+namespace LAMMPS_NS {
+
+class FixInsitu : public Fix {
+ public:
+
+  // per-atom fields handed to the callback, pointers are set on each call
+
+  struct Data {
+    bigint ntimestep;      // current timestep
+    const char *stage;     // name of stage the callback is made from
+    int nlocal;            // # of atoms owned by this proc
+    int *mask;             // per-atom group mask of owned atoms
+    int groupbit;          // bit of fix group in mask
+    int nfield;            // # of requested fields
+    char **names;          // name of each field
+    int *types;            // 0 = int, 1 = double, 2 = 64-bit int values
+    int *counts;           // # of values per atom of each field
+    void **ptrs;           // 1st value of each field, stride = count
+  };
+
+  FixInsitu(class LAMMPS *, int, char **);
+  ~FixInsitu();
+  int setmask();
+  void init();
+  void pre_exchange();
+  void pre_neighbor();
+  void post_integrate();
+  void pre_force(int);
+  void post_force(int);
+  void end_of_step();
+
+  typedef void (*FnPtr)(void *, Data *);
+  void set_callback(FnPtr, void *);
+
+ private:
+  int stagemask;
+  FnPtr callback;
+  void *ptr_caller;
+  Data data;
+
+  void invoke(const char *);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal ... command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running LAMMPS to see the offending line.
+
+E: Fix insitu field %s is not defined by atom style
+
+The requested per-atom field does not exist for the atom style being
+used, or is not a per-atom field that can be accessed by this fix.
+
+E: Fix insitu callback function not set
+
+This must be done by an external program in order to use this fix.
+
+*/
@@ -0,0 +1,317 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "mpi.h"
+#include "math.h"
+#include "stdio.h"
+#include "fix_kspace_mts.h"
+#include "atom.h"
+#include "force.h"
+#include "kspace.h"
+#include "update.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace LAMMPS_NS;
+using namespace FixConst;
+
+/* ---------------------------------------------------------------------- */
+
+FixKSpaceMTS::FixKSpaceMTS(LAMMPS *lmp, int narg, char **arg) :
+  Fix(lmp, narg, arg)
+{
+  if (narg != 3) error->all(FLERR,"Illegal fix KSPACE_MTS command");
+
+  MPI_Comm_rank(world,&me);
+
+  vector_flag = 1;
+  size_vector = 3;
+  global_freq = 1;
+  extvector = 0;
+  create_attribute = 1;
+
+  // per-atom KSpace forces migrate with atoms
+
+  fk = NULL;
+  grow_arrays(atom->nmax);
+  atom->add_callback(0);
+
+  int nlocal = atom->nlocal;
+  for (int i = 0; i < nlocal; i++) set_arrays(i);
+
+  fsave = NULL;
+  maxsave = 0;
+
+  every = 1;
+  extrapolate = KSpace::IMPULSE;
+  next_eval = last_eval = prev_eval = 0;
+  nhistory = 0;
+  neval = nerror = 0;
+  error_last = error_sum = 0.0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+FixKSpaceMTS::~FixKSpaceMTS()
+{
+  atom->delete_callback(id,0);
+  memory->destroy(fk);
+  memory->destroy(fsave);
+}
+
+/* ---------------------------------------------------------------------- */
+
+int FixKSpaceMTS::setmask()
+{
+  int mask = 0;
+  mask |= POST_RUN;
+  return mask;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixKSpaceMTS::init()
+{
+  if (!force->kspace)
+    error->all(FLERR,"KSpace every > 1 requires a KSpace style");
+
+  every = force->kspace->every;
+  extrapolate = force->kspace->extrapolate;
+
+  neval = nerror = 0;
+  error_last = error_sum = 0.0;
+}
+
+/* ----------------------------------------------------------------------
+   called by the integrator in place of KSpace::compute()
+   KSpace is evaluated on setup and every Nevery steps
+   in between, the stored forces are added according to the extrapolation
+------------------------------------------------------------------------- */
+
+void FixKSpaceMTS::compute(int eflag, int vflag)
+{
+  if (update->setupflag || update->ntimestep >= next_eval) {
+    evaluate(eflag,vflag);
+    return;
+  }
+
+  // energy or per-atom virial requested on an in-between step:
+  // evaluate KSpace only for its tallies, so output is exact and
+  // the trajectory does not depend on how often output is done
+
+  if (eflag || vflag/4) report(eflag,vflag);
+
+  if (extrapolate == KSpace::IMPULSE) return;
+
+  double frac = 0.0;
+  if (extrapolate == KSpace::LINEAR && nhistory > 1)
+    frac = (double) (update->ntimestep - last_eval) / (last_eval - prev_eval);
+
+  double **f = atom->f;
+  int nlocal = atom->nlocal;
+
+  for (int i = 0; i < nlocal; i++) {
+    f[i][0] += fk[i][0] + frac*(fk[i][0]-fk[i][3]);
+    f[i][1] += fk[i][1] + frac*(fk[i][1]-fk[i][4]);
+    f[i][2] += fk[i][2] + frac*(fk[i][2]-fk[i][5]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   full KSpace evaluation, new force = change of f by KSpace::compute()
+   global virial is always tallied, so a barostat sees the virial of the
+   last evaluation on in-between steps
+   relative force error = rms difference of new force to the force
+   the extrapolation would have applied on this step, over rms new force
+------------------------------------------------------------------------- */
+
+void FixKSpaceMTS::evaluate(int eflag, int vflag)
+{
+  double **f = atom->f;
+  int nlocal = atom->nlocal;
+  int i,k;
+
+  if (nlocal > maxsave) {
+    maxsave = atom->nmax;
+    memory->destroy(fsave);
+    memory->create(fsave,maxsave,3,"kspace/mts:fsave");
+  }
+
+  for (i = 0; i < nlocal; i++) {
+    fsave[i][0] = f[i][0];
+    fsave[i][1] = f[i][1];
+    fsave[i][2] = f[i][2];
+  }
+
+  if (vflag % 4 == 0) vflag |= 1;
+  force->kspace->compute(eflag,vflag);
+
+  int history = (!update->setupflag && nhistory > 0);
+  double frac = 0.0;
+  if (history && extrapolate == KSpace::LINEAR && nhistory > 1)
+    frac = (double) (update->ntimestep - last_eval) / (last_eval - prev_eval);
+
+  double fnew,delta;
+  double sum[2] = {0.0,0.0};
+
+  for (i = 0; i < nlocal; i++)
+    for (k = 0; k < 3; k++) {
+      fnew = f[i][k] - fsave[i][k];
+      if (history) {
+        delta = fnew - (fk[i][k] + frac*(fk[i][k]-fk[i][k+3]));
+        sum[0] += delta*delta;
+        sum[1] += fnew*fnew;
+      }
+      fk[i][k+3] = fk[i][k];
+      fk[i][k] = fnew;
+      if (extrapolate == KSpace::IMPULSE) f[i][k] += (every-1)*fnew;
+    }
+
+  if (history) {
+    double sumall[2];
+    MPI_Allreduce(sum,sumall,2,MPI_DOUBLE,MPI_SUM,world);
+    if (sumall[1] > 0.0) error_last = sqrt(sumall[0]/sumall[1]);
+    else error_last = 0.0;
+    error_sum += error_last;
+    nerror++;
+  }
+
+  // stored forces of a previous run are not used for extrapolation
+
+  if (update->setupflag) nhistory = 1;
+  else if (nhistory < 2) nhistory++;
+
+  prev_eval = last_eval;
+  last_eval = update->ntimestep;
+  next_eval = last_eval + every;
+  neval++;
+}
+
+/* ----------------------------------------------------------------------
+   KSpace evaluation for energy and virial tallies only, forces are restored
+------------------------------------------------------------------------- */
+
+void FixKSpaceMTS::report(int eflag, int vflag)
+{
+  double **f = atom->f;
+  int nlocal = atom->nlocal;
+  int i;
+
+  if (nlocal > maxsave) {
+    maxsave = atom->nmax;
+    memory->destroy(fsave);
+    memory->create(fsave,maxsave,3,"kspace/mts:fsave");
+  }
+
+  for (i = 0; i < nlocal; i++) {
+    fsave[i][0] = f[i][0];
+    fsave[i][1] = f[i][1];
+    fsave[i][2] = f[i][2];
+  }
+
+  force->kspace->compute(eflag,vflag);
+
+  for (i = 0; i < nlocal; i++) {
+    f[i][0] = fsave[i][0];
+    f[i][1] = fsave[i][1];
+    f[i][2] = fsave[i][2];
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixKSpaceMTS::post_run()
+{
+  if (me || neval == 0) return;
+
+  const char *style[3] = {"impulse","constant","linear"};
+  double ave = 0.0;
+  if (nerror) ave = error_sum/nerror;
+
+  char str[256];
+  sprintf(str,"KSpace every %d steps (%s): " BIGINT_FORMAT
+          " evaluations, relative force error last %g average %g\n",
+          every,style[extrapolate],neval,error_last,ave);
+  if (screen) fputs(str,screen);
+  if (logfile) fputs(str,logfile);
+}
+
+/* ----------------------------------------------------------------------
+   # of evaluations, relative force error of last one, run average
+------------------------------------------------------------------------- */
+
+double FixKSpaceMTS::compute_vector(int n)
+{
+  if (n == 0) return (double) neval;
+  if (n == 1) return error_last;
+  if (nerror) return error_sum/nerror;
+  return 0.0;
+}
+
+/* ----------------------------------------------------------------------
+   memory usage of local atom-based arrays
+------------------------------------------------------------------------- */
+
+double FixKSpaceMTS::memory_usage()
+{
+  double bytes = atom->nmax*6 * sizeof(double);
+  bytes += maxsave*3 * sizeof(double);
+  return bytes;
+}
+
+/* ----------------------------------------------------------------------
+   allocate atom-based array
+------------------------------------------------------------------------- */
+
+void FixKSpaceMTS::grow_arrays(int nmax)
+{
+  memory->grow(fk,nmax,6,"kspace/mts:fk");
+}
+
+/* ----------------------------------------------------------------------
+   copy values within local atom-based array
+------------------------------------------------------------------------- */
+
+void FixKSpaceMTS::copy_arrays(int i, int j, int delflag)
+{
+  for (int m = 0; m < 6; m++) fk[j][m] = fk[i][m];
+}
+
+/* ----------------------------------------------------------------------
+   new atoms have no KSpace force until the next evaluation
+------------------------------------------------------------------------- */
+
+void FixKSpaceMTS::set_arrays(int i)
+{
+  for (int m = 0; m < 6; m++) fk[i][m] = 0.0;
+}
+
+/* ----------------------------------------------------------------------
+   pack values in local atom-based array for exchange with another proc
+------------------------------------------------------------------------- */
+
+int FixKSpaceMTS::pack_exchange(int i, double *buf)
+{
+  for (int m = 0; m < 6; m++) buf[m] = fk[i][m];
+  return 6;
+}
+
+/* ----------------------------------------------------------------------
+   unpack values in local atom-based array from exchange with another proc
+------------------------------------------------------------------------- */
+
+int FixKSpaceMTS::unpack_exchange(int nlocal, double *buf)
+{
+  for (int m = 0; m < 6; m++) fk[nlocal][m] = buf[m];
+  return 6;
+}
@@ -0,0 +1,86 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef FIX_CLASS
+
+FixStyle(KSPACE_MTS,FixKSpaceMTS)
+
+#else
+
+#ifndef LMP_FIX_KSPACE_MTS_H
+#define LMP_FIX_KSPACE_MTS_H
+
+#include "fix.h"
+
+namespace LAMMPS_NS {
+
+class FixKSpaceMTS : public Fix {
+ public:
+  FixKSpaceMTS(class LAMMPS *, int, char **);
+  ~FixKSpaceMTS();
+  int setmask();
+  void init();
+  void post_run();
+  double compute_vector(int);
+  double memory_usage();
+
+  void compute(int, int);
+
+  void grow_arrays(int);
+  void copy_arrays(int, int, int);
+  void set_arrays(int);
+  int pack_exchange(int, double *);
+  int unpack_exchange(int, double *);
+
+ private:
+  int me;
+  int every;                    // KSpace is evaluated every this many steps
+  int extrapolate;              // KSpace::IMPULSE, CONSTANT, LINEAR
+
+  double **fk;                  // per-atom KSpace force of last evaluation
+                                // in 0-2, of the one before in 3-5
+  double **fsave;               // force of this proc before KSpace call
+  int maxsave;
+
+  bigint next_eval;             // timestep of next KSpace evaluation
+  bigint last_eval,prev_eval;   // timesteps of the stored forces
+  int nhistory;                 // # of stored forces valid for this run
+
+  bigint neval;                 // # of evaluations in this run
+  bigint nerror;                // # of evaluations with an error estimate
+  double error_last;            // relative force error of last evaluation
+  double error_sum;             // sum of relative errors for run average
+
+  void evaluate(int, int);
+  void report(int, int);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal ... command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running LAMMPS to see the offending line.
+
+E: KSpace every > 1 requires a KSpace style
+
+This internal fix is created by run style verlet only when the
+kspace_modify every setting is larger than 1.
+
+*/
@@ -0,0 +1,249 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "mpi.h"
+#include "stdio.h"
+#include "string.h"
+#include "fix_trace.h"
+#include "atom.h"
+#include "comm.h"
+#include "domain.h"
+#include "force.h"
+#include "modify.h"
+#include "neighbor.h"
+#include "neigh_list.h"
+#include "neigh_request.h"
+#include "update.h"
+#include "timer.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace LAMMPS_NS;
+using namespace FixConst;
+
+enum{LAYOUT_UNIFORM,LAYOUT_NONUNIFORM,LAYOUT_TILED};    // several files
+
+// per-proc values of one record, sub-domain bounds are fractions of box
+
+enum{NLOCAL,NGHOST,NNEIGH,NINSERT,PAIR,COMM,WAIT,LO,HI=LO+3,NVALUE=HI+3};
+
+#define VERSION 1
+
+/* ---------------------------------------------------------------------- */
+
+FixTrace::FixTrace(LAMMPS *lmp, int narg, char **arg) :
+  Fix(lmp, narg, arg)
+{
+  if (narg != 5) error->all(FLERR,"Illegal fix trace command");
+
+  nevery = force->inumeric(FLERR,arg[3]);
+  if (nevery <= 0) error->all(FLERR,"Illegal fix trace command");
+
+  MPI_Comm_rank(world,&me);
+  MPI_Comm_size(world,&nprocs);
+
+  fp = NULL;
+  if (me == 0) {
+    fp = fopen(arg[4],"wb");
+    if (fp == NULL) {
+      char str[128];
+      sprintf(str,"Cannot open fix trace file %s",arg[4]);
+      error->one(FLERR,str);
+    }
+  }
+  headerflag = 0;
+
+  memory->create(values,NVALUE,"trace:values");
+  all = NULL;
+  ibuf = NULL;
+  bbuf = NULL;
+  fbuf = NULL;
+  if (me == 0) {
+    memory->create(all,nprocs*NVALUE,"trace:all");
+    memory->create(ibuf,3*nprocs,"trace:ibuf");
+    bbuf = (int64_t *) memory->smalloc(nprocs*sizeof(int64_t),"trace:bbuf");
+    memory->create(fbuf,3*nprocs,"trace:fbuf");
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+FixTrace::~FixTrace()
+{
+  if (fp) fclose(fp);
+
+  memory->destroy(values);
+  memory->destroy(all);
+  memory->destroy(ibuf);
+  memory->sfree(bbuf);
+  memory->destroy(fbuf);
+}
+
+/* ---------------------------------------------------------------------- */
+
+int FixTrace::setmask()
+{
+  int mask = 0;
+  mask |= END_OF_STEP;
+  return mask;
+}
+
+/* ----------------------------------------------------------------------
+   timer is reset after setup, so intervals of a run start from 0
+------------------------------------------------------------------------- */
+
+void FixTrace::setup(int vflag)
+{
+  if (!headerflag) write_header();
+
+  pair_last = comm_last = 0.0;
+  wait_last = comm->wait_time;
+  insert_last = count_inserted();
+}
+
+/* ----------------------------------------------------------------------
+   write one record, values are for the interval since the last one
+------------------------------------------------------------------------- */
+
+void FixTrace::end_of_step()
+{
+  values[NLOCAL] = atom->nlocal;
+  values[NGHOST] = atom->nghost;
+  values[NNEIGH] = count_neighbors();
+
+  bigint ninsert = count_inserted();
+  values[NINSERT] = ninsert - insert_last;
+  insert_last = ninsert;
+
+  values[PAIR] = timer->array[TIME_PAIR] - pair_last;
+  values[COMM] = timer->array[TIME_COMM] - comm_last;
+  values[WAIT] = comm->wait_time - wait_last;
+  pair_last = timer->array[TIME_PAIR];
+  comm_last = timer->array[TIME_COMM];
+  wait_last = comm->wait_time;
+
+  double *lo,*hi,*boxlo,*prd;
+  if (domain->triclinic) {
+    lo = domain->sublo_lamda;
+    hi = domain->subhi_lamda;
+    for (int k = 0; k < 3; k++) {
+      values[LO+k] = lo[k];
+      values[HI+k] = hi[k];
+    }
+  } else {
+    lo = domain->sublo;
+    hi = domain->subhi;
+    boxlo = domain->boxlo;
+    prd = domain->prd;
+    for (int k = 0; k < 3; k++) {
+      values[LO+k] = (lo[k]-boxlo[k])/prd[k];
+      values[HI+k] = (hi[k]-boxlo[k])/prd[k];
+    }
+  }
+
+  MPI_Gather(values,NVALUE,MPI_DOUBLE,all,NVALUE,MPI_DOUBLE,0,world);
+  if (me) return;
+
+  // record = step, then one column of all procs for each field
+  // so each field can be read as one array
+
+  int64_t step = update->ntimestep;
+  fwrite(&step,sizeof(int64_t),1,fp);
+
+  write_int(NLOCAL);
+  write_int(NGHOST);
+  for (int i = 0; i < nprocs; i++) bbuf[i] = all[i*NVALUE+NNEIGH];
+  fwrite(bbuf,sizeof(int64_t),nprocs,fp);
+  write_int(NINSERT);
+  write_float(PAIR,1);
+  write_float(COMM,1);
+  write_float(WAIT,1);
+  write_float(LO,3);
+  write_float(HI,3);
+
+  fflush(fp);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixTrace::write_int(int field)
+{
+  for (int i = 0; i < nprocs; i++) ibuf[i] = all[i*NVALUE+field];
+  fwrite(ibuf,sizeof(int),nprocs,fp);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixTrace::write_float(int field, int n)
+{
+  for (int i = 0; i < nprocs; i++)
+    for (int k = 0; k < n; k++) fbuf[n*i+k] = all[i*NVALUE+field+k];
+  fwrite(fbuf,sizeof(float),n*nprocs,fp);
+}
+
+/* ----------------------------------------------------------------------
+   header = magic, version, nprocs, dimension, nevery, tiled flag,
+            proc grid, location of each proc in grid (-1 if tiled)
+------------------------------------------------------------------------- */
+
+void FixTrace::write_header()
+{
+  int tiled = (comm->layout == LAYOUT_TILED);
+  int myloc[3];
+  for (int k = 0; k < 3; k++) myloc[k] = tiled ? -1 : comm->myloc[k];
+  MPI_Gather(myloc,3,MPI_INT,ibuf,3,MPI_INT,0,world);
+  headerflag = 1;
+  if (me) return;
+
+  fwrite("LMPTRACE",sizeof(char),8,fp);
+  int header[8] = {VERSION,nprocs,domain->dimension,nevery,tiled,
+                   comm->procgrid[0],comm->procgrid[1],comm->procgrid[2]};
+  fwrite(header,sizeof(int),8,fp);
+  fwrite(ibuf,sizeof(int),3*nprocs,fp);
+}
+
+/* ----------------------------------------------------------------------
+   # of neighbors of owned atoms in the first perpetual pair list
+   that is built from scratch, i.e. not a skip or copy of another list
+   requests of the current run are old_requests once Neighbor::init() is done
+------------------------------------------------------------------------- */
+
+bigint FixTrace::count_neighbors()
+{
+  for (int m = 0; m < neighbor->old_nrequest; m++) {
+    NeighRequest *rq = neighbor->old_requests[m];
+    NeighList *list = neighbor->lists[m];
+    if (list == NULL || !rq->pair || rq->occasional) continue;
+    if (rq->skip || rq->copy || rq->half_from_full) continue;
+    bigint count = 0;
+    for (int ii = 0; ii < list->inum; ii++)
+      count += list->numneigh[list->ilist[ii]];
+    return count;
+  }
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   # of atoms this proc inserted, summed over fixes that provide it
+------------------------------------------------------------------------- */
+
+bigint FixTrace::count_inserted()
+{
+  bigint count = 0;
+  int dim;
+  for (int i = 0; i < modify->nfix; i++) {
+    int *ptr = (int *) modify->fix[i]->extract("ninserted",dim);
+    if (ptr && dim == 0) count += *ptr;
+  }
+  return count;
+}
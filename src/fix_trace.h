@@ -0,0 +1,75 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef FIX_CLASS
+
+FixStyle(trace,FixTrace)
+
+#else
+
+#ifndef LMP_FIX_TRACE_H
+#define LMP_FIX_TRACE_H
+
+#include "stdio.h"
+#include "fix.h"
+
+namespace LAMMPS_NS {
+
+class FixTrace : public Fix {
+ public:
+  FixTrace(class LAMMPS *, int, char **);
+  ~FixTrace();
+  int setmask();
+  void setup(int);
+  void end_of_step();
+
+ private:
+  int me,nprocs;
+  FILE *fp;
+  int headerflag;               // 1 if file header has been written
+
+  double pair_last,comm_last,wait_last;  // totals at previous record
+  bigint insert_last;
+
+  double *values;               // values of this proc for one record
+  double *all;                  // values of all procs on proc 0
+  int *ibuf;                    // conversion buffers for writing on proc 0
+  int64_t *bbuf;
+  float *fbuf;
+
+  void write_header();
+  void write_int(int);
+  void write_float(int, int);
+  bigint count_neighbors();
+  bigint count_inserted();
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal ... command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running LAMMPS to see the offending line.
+
+E: Cannot open fix trace file %s
+
+The specified file cannot be opened.  Check that the path and name are
+correct.
+
+*/
@@ -0,0 +1,394 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "mpi.h"
+#include "math.h"
+#include "ctype.h"
+#include "string.h"
+#include "fix_tune_neigh.h"
+#include "atom.h"
+#include "comm.h"
+#include "force.h"
+#include "kspace.h"
+#include "modify.h"
+#include "neighbor.h"
+#include "update.h"
+#include "timer.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace LAMMPS_NS;
+using namespace FixConst;
+
+enum{SKIN,BINSIZE,SORT,BALANCE,NPARAM};
+enum{NSQ,BIN,MULTI};     // also in neighbor.cpp
+
+static const char *pname[NPARAM] = {"skin","binsize","sort","balance"};
+
+/* ---------------------------------------------------------------------- */
+
+FixTuneNeigh::FixTuneNeigh(LAMMPS *lmp, int narg, char **arg) :
+  Fix(lmp, narg, arg)
+{
+  if (narg < 6) error->all(FLERR,"Illegal fix tune/neigh command");
+
+  MPI_Comm_rank(world,&me);
+
+  nwindow = force->inumeric(FLERR,arg[3]);
+  if (nwindow <= 0) error->all(FLERR,"Illegal fix tune/neigh command");
+
+  vector_flag = 1;
+  size_vector = NPARAM;
+  global_freq = 1;
+  extvector = 0;
+
+  // each keyword is followed by one or more numeric candidate values
+
+  retune = 0.1;
+  for (int p = 0; p < NPARAM; p++) {
+    ncand[p] = 0;
+    cand[p] = tcand[p] = NULL;
+    dcand[p] = NULL;
+    current[p] = 0.0;
+  }
+
+  int iarg = 4;
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"retune") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix tune/neigh command");
+      retune = force->numeric(FLERR,arg[iarg+1]);
+      if (retune < 0.0) error->all(FLERR,"Illegal fix tune/neigh command");
+      iarg += 2;
+      continue;
+    }
+
+    int p;
+    for (p = 0; p < NPARAM; p++)
+      if (strcmp(arg[iarg],pname[p]) == 0) break;
+    if (p == NPARAM || ncand[p])
+      error->all(FLERR,"Illegal fix tune/neigh command");
+
+    int n = 0;
+    while (iarg+1+n < narg && !isalpha(arg[iarg+1+n][0])) n++;
+    if (n == 0) error->all(FLERR,"Illegal fix tune/neigh command");
+
+    ncand[p] = n;
+    cand[p] = new double[n];
+    tcand[p] = new double[n];
+    dcand[p] = new bigint[n];
+    for (int i = 0; i < n; i++) {
+      cand[p][i] = force->numeric(FLERR,arg[iarg+1+i]);
+      if (p == SKIN && cand[p][i] <= 0.0)
+        error->all(FLERR,"Fix tune/neigh skin must be > 0.0");
+      if (p == BINSIZE && cand[p][i] < 0.0)
+        error->all(FLERR,"Illegal fix tune/neigh command");
+      if ((p == SORT || p == BALANCE) &&
+          (cand[p][i] < 1.0 || cand[p][i] != static_cast<int> (cand[p][i])))
+        error->all(FLERR,"Illegal fix tune/neigh command");
+    }
+    iarg += n+1;
+  }
+
+  iparam = 0;
+  while (iparam < NPARAM && ncand[iparam] == 0) iparam++;
+  if (iparam == NPARAM) error->all(FLERR,"Illegal fix tune/neigh command");
+
+  // first candidate is applied on the reneighboring of the next step
+  // end_of_step() checks every Nwindow steps whether to retune
+
+  tuning = 1;
+  icand = -1;
+  measuring = 0;
+  force_reneighbor = 1;
+  next_reneighbor = update->ntimestep + 1;
+  nevery = nwindow;
+
+  nevery_balance = NULL;
+  fix_balance = NULL;
+
+  ntypes = atom->ntypes;
+  memory->create(ntuned,ntypes+1,"tune/neigh:ntuned");
+  memory->create(nnow,ntypes+1,"tune/neigh:nnow");
+  memory->create(nlocal_type,ntypes+1,"tune/neigh:nlocal_type");
+  for (int t = 0; t <= ntypes; t++) ntuned[t] = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+FixTuneNeigh::~FixTuneNeigh()
+{
+  for (int p = 0; p < NPARAM; p++) {
+    delete [] cand[p];
+    delete [] tcand[p];
+    delete [] dcand[p];
+  }
+  memory->destroy(ntuned);
+  memory->destroy(nnow);
+  memory->destroy(nlocal_type);
+}
+
+/* ---------------------------------------------------------------------- */
+
+int FixTuneNeigh::setmask()
+{
+  int mask = 0;
+  mask |= PRE_EXCHANGE;
+  mask |= END_OF_STEP;
+  return mask;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixTuneNeigh::init()
+{
+  if (ncand[BINSIZE] && neighbor->style == NSQ)
+    error->all(FLERR,"Fix tune/neigh binsize requires neighbor style bin");
+  if (ncand[SORT] && atom->sortfreq == 0)
+    error->all(FLERR,"Fix tune/neigh sort requires atom sorting to be enabled");
+
+  if (ncand[BALANCE]) {
+    int dim;
+    nevery_balance = NULL;
+    for (int i = 0; i < modify->nfix; i++)
+      if (strcmp(modify->fix[i]->style,"balance") == 0) {
+        fix_balance = modify->fix[i];
+        nevery_balance = (int *) fix_balance->extract("nevery",dim);
+      }
+    if (nevery_balance == NULL || *nevery_balance == 0)
+      error->all(FLERR,"Fix tune/neigh balance requires "
+                 "a fix balance with Nevery > 0");
+  }
+}
+
+/* ----------------------------------------------------------------------
+   settings in use may have been changed by input commands between runs
+   bin size is stored as a multiple of the neighbor cutoff, 0 = default
+------------------------------------------------------------------------- */
+
+void FixTuneNeigh::setup(int vflag)
+{
+  current[SKIN] = neighbor->skin;
+  if (neighbor->binsizeflag && neighbor->cutneighmax > 0.0)
+    current[BINSIZE] = neighbor->binsize_user/neighbor->cutneighmax;
+  else current[BINSIZE] = 0.0;
+  current[SORT] = atom->sortfreq;
+  current[BALANCE] = nevery_balance ? *nevery_balance : 0;
+
+  // timer is reset after setup, so restart timing of current candidate
+
+  if (tuning) {
+    measuring = 0;
+    next_reneighbor = update->ntimestep + 1;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   end the timing window of one candidate and start the next one
+   only called on steps this fix forces reneighboring on,
+     so the new settings are in place before atoms migrate and lists build
+------------------------------------------------------------------------- */
+
+void FixTuneNeigh::pre_exchange()
+{
+  if (!tuning || update->ntimestep != next_reneighbor) return;
+
+  // wall time per step of the slowest proc, which all procs agree on
+
+  if (measuring) {
+    double time = timer->elapsed(TIME_LOOP) - tstart;
+    double timeall;
+    MPI_Allreduce(&time,&timeall,1,MPI_DOUBLE,MPI_MAX,world);
+    tcand[iparam][icand] = timeall/(update->ntimestep-stepstart);
+    dcand[iparam][icand] = neighbor->ndanger - dangerstart;
+
+    if (me == 0) {
+      if (screen)
+        fprintf(screen,"Tune/neigh %s %g: %g secs/step, "
+                BIGINT_FORMAT " dangerous builds\n",pname[iparam],
+                cand[iparam][icand],tcand[iparam][icand],dcand[iparam][icand]);
+      if (logfile)
+        fprintf(logfile,"Tune/neigh %s %g: %g secs/step, "
+                BIGINT_FORMAT " dangerous builds\n",pname[iparam],
+                cand[iparam][icand],tcand[iparam][icand],dcand[iparam][icand]);
+    }
+    icand++;
+  } else if (icand < 0) icand = 0;
+
+  next_candidate();
+}
+
+/* ----------------------------------------------------------------------
+   retune if # of atoms or fraction of atoms of any type has changed
+------------------------------------------------------------------------- */
+
+void FixTuneNeigh::end_of_step()
+{
+  if (tuning || retune == 0.0) return;
+  if (!changed()) return;
+
+  if (me == 0) {
+    if (screen) fprintf(screen,"Tune/neigh: atom counts changed, retuning\n");
+    if (logfile) fprintf(logfile,"Tune/neigh: atom counts changed, retuning\n");
+  }
+
+  tuning = 1;
+  iparam = 0;
+  while (ncand[iparam] == 0) iparam++;
+  icand = -1;
+  measuring = 0;
+  next_reneighbor = update->ntimestep + 1;
+}
+
+/* ----------------------------------------------------------------------
+   apply next candidate, or pick best value when all of a parameter
+     have been timed and move on to next parameter
+   parameters are tuned one at a time in the order skin, binsize,
+     sort, balance, each with the best values of the preceding ones
+------------------------------------------------------------------------- */
+
+void FixTuneNeigh::next_candidate()
+{
+  while (icand == ncand[iparam]) {
+    choose(iparam);
+    iparam++;
+    while (iparam < NPARAM && ncand[iparam] == 0) iparam++;
+    if (iparam == NPARAM) {
+      tuning = 0;
+      measuring = 0;
+      next_reneighbor = -1;
+      count_types(ntuned);
+      return;
+    }
+    icand = 0;
+  }
+
+  apply(iparam,cand[iparam][icand]);
+
+  measuring = 1;
+  tstart = timer->elapsed(TIME_LOOP);
+  stepstart = update->ntimestep;
+  dangerstart = neighbor->ndanger;
+  next_reneighbor = update->ntimestep + nwindow;
+}
+
+/* ----------------------------------------------------------------------
+   apply fastest value of parameter p among those with fewest dangerous
+     builds, which should be none
+------------------------------------------------------------------------- */
+
+void FixTuneNeigh::choose(int p)
+{
+  int best = 0;
+  for (int i = 1; i < ncand[p]; i++)
+    if (dcand[p][i] < dcand[p][best] ||
+        (dcand[p][i] == dcand[p][best] && tcand[p][i] < tcand[p][best]))
+      best = i;
+
+  apply(p,cand[p][best]);
+
+  if (me == 0) {
+    if (dcand[p][best]) {
+      char str[128];
+      sprintf(str,"Fix tune/neigh found no safe value for %s, keeping %g",
+              pname[p],cand[p][best]);
+      error->warning(FLERR,str);
+    }
+    if (screen)
+      fprintf(screen,"Tune/neigh %s set to %g\n",pname[p],cand[p][best]);
+    if (logfile)
+      fprintf(logfile,"Tune/neigh %s set to %g\n",pname[p],cand[p][best]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   change one parameter, takes effect on the reneighboring of this step
+   a new skin changes ghost cutoff and bins, bin size stays relative
+   KSpace ghost grid extents are set from the skin, so reset its grid
+     as fix balance does
+------------------------------------------------------------------------- */
+
+void FixTuneNeigh::apply(int p, double value)
+{
+  current[p] = value;
+
+  if (p == SKIN) {
+    neighbor->reset_skin(value);
+    if (current[BINSIZE] > 0.0)
+      neighbor->binsize_user = current[BINSIZE]*neighbor->cutneighmax;
+    comm->setup();
+    if (neighbor->style != NSQ) neighbor->setup_bins();
+    if (force->kspace) force->kspace->setup_grid();
+
+  } else if (p == BINSIZE) {
+    if (value == 0.0) neighbor->binsizeflag = 0;
+    else {
+      neighbor->binsizeflag = 1;
+      neighbor->binsize_user = value*neighbor->cutneighmax;
+    }
+    neighbor->setup_bins();
+
+  } else if (p == SORT) {
+    int n = static_cast<int> (value);
+    atom->sortfreq = n;
+    atom->nextsort = (update->ntimestep/n)*n + n;
+
+  } else if (p == BALANCE) {
+    int n = static_cast<int> (value);
+    *nevery_balance = n;
+    fix_balance->next_reneighbor = (update->ntimestep/n)*n + n;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   global # of atoms in n[0] and # of atoms of each type in n[1:ntypes]
+------------------------------------------------------------------------- */
+
+void FixTuneNeigh::count_types(bigint *n)
+{
+  int *type = atom->type;
+  int nlocal = atom->nlocal;
+
+  for (int t = 0; t <= ntypes; t++) nlocal_type[t] = 0;
+  nlocal_type[0] = nlocal;
+  for (int i = 0; i < nlocal; i++) nlocal_type[type[i]]++;
+
+  MPI_Allreduce(nlocal_type,n,ntypes+1,MPI_LMP_BIGINT,MPI_SUM,world);
+}
+
+/* ----------------------------------------------------------------------
+   return 1 if relative change of total # of atoms or change of the
+     fraction of any type since last tuning exceeds retune threshold
+------------------------------------------------------------------------- */
+
+int FixTuneNeigh::changed()
+{
+  count_types(nnow);
+  if (ntuned[0] == 0 || nnow[0] == 0) return 0;
+
+  if (fabs((double) (nnow[0]-ntuned[0])) > retune*ntuned[0]) return 1;
+  for (int t = 1; t <= ntypes; t++) {
+    double fnow = (double) nnow[t]/nnow[0];
+    double ftuned = (double) ntuned[t]/ntuned[0];
+    if (fabs(fnow-ftuned) > retune) return 1;
+  }
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   current value of each parameter
+------------------------------------------------------------------------- */
+
+double FixTuneNeigh::compute_vector(int i)
+{
+  return current[i];
+}
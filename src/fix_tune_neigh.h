@@ -0,0 +1,107 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef FIX_CLASS
+
+FixStyle(tune/neigh,FixTuneNeigh)
+
+#else
+
+#ifndef LMP_FIX_TUNE_NEIGH_H
+#define LMP_FIX_TUNE_NEIGH_H
+
+#include "fix.h"
+
+namespace LAMMPS_NS {
+
+class FixTuneNeigh : public Fix {
+ public:
+  FixTuneNeigh(class LAMMPS *, int, char **);
+  ~FixTuneNeigh();
+  int setmask();
+  void init();
+  void setup(int);
+  void pre_exchange();
+  void end_of_step();
+  double compute_vector(int);
+
+ private:
+  int me;
+  int nwindow;                  // # of steps each candidate is timed for
+  double retune;                // relative change of atom counts to retune
+
+  int ncand[4];                 // candidate values of each parameter
+  double *cand[4];
+  double *tcand[4];             // time per step of each candidate
+  bigint *dcand[4];             // dangerous builds while timing each one
+  double current[4];            // value in use for each parameter
+
+  int tuning;                   // 1 while trying candidates
+  int iparam;                   // parameter being tuned
+  int icand;                    // candidate being timed, -1 before first
+  int measuring;                // 1 if timing window of icand is open
+  double tstart;                // loop time at start of window
+  bigint stepstart;             // timestep at start of window
+  bigint dangerstart;           // dangerous builds at start of window
+
+  int *nevery_balance;          // rebalance interval of fix balance
+  class Fix *fix_balance;
+
+  int ntypes;                   // atom counts when last tuned
+  bigint *ntuned,*nnow,*nlocal_type;
+
+  void next_candidate();
+  void choose(int);
+  void apply(int, double);
+  void count_types(bigint *);
+  int changed();
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal ... command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running LAMMPS to see the offending line.
+
+E: Fix tune/neigh skin must be > 0.0
+
+Self-explanatory.
+
+E: Fix tune/neigh binsize requires neighbor style bin
+
+Only the bin neighbor style uses a bin size that can be tuned.
+
+E: Fix tune/neigh sort requires atom sorting to be enabled
+
+Sorting must be enabled via the atom_modify sort command, so that the
+integrator checks the sort interval during a run.
+
+E: Fix tune/neigh balance requires a fix balance with Nevery > 0
+
+The rebalancing interval can only be tuned if a fix balance command
+is defined that rebalances periodically.
+
+W: Fix tune/neigh found no safe value for %s, keeping %g
+
+Every candidate value of the parameter caused dangerous neighbor list
+builds, so the original setting is kept.  Consider adding larger skin
+values to the candidates.
+
+*/
@@ -186,9 +186,12 @@ void Group::assign(int narg, char **arg)
     domain->regions[iregion]->init();
     domain->regions[iregion]->prematch();
 
+    int *rflag;
+    memory->create(rflag,nlocal,"group:rflag");
+    domain->regions[iregion]->match_many(x,nlocal,rflag);
     for (i = 0; i < nlocal; i++)
-      if (domain->regions[iregion]->match(x[i][0],x[i][1],x[i][2]))
-        mask[i] |= bit;
+      if (rflag[i]) mask[i] |= bit;
+    memory->destroy(rflag);
 
   // style = type, molecule, id
   // add to group if atom matches type/molecule/id or condition
@@ -114,6 +114,13 @@ Image::Image(LAMMPS *lmp, int nmap_caller) : Pointers(lmp)
   backLightColor[2] = 0.9;
 
   random = NULL;
+
+  depthBuffer = surfaceBuffer = NULL;
+  depthcopy = surfacecopy = NULL;
+  imageBuffer = rgbcopy = writeBuffer = NULL;
+  tilelo = tilehi = tilecounts = tiledispls = NULL;
+  requests = NULL;
+  statuses = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -133,6 +140,12 @@ Image::~Image()
   memory->destroy(depthcopy);
   memory->destroy(surfacecopy);
   memory->destroy(rgbcopy);
+  memory->destroy(tilelo);
+  memory->destroy(tilehi);
+  memory->destroy(tilecounts);
+  memory->destroy(tiledispls);
+  delete [] requests;
+  delete [] statuses;
 
   if (random) delete random;
 }
@@ -151,6 +164,42 @@ void Image::buffers()
   memory->create(depthcopy,npixels,"image:depthcopy");
   memory->create(surfacecopy,2*npixels,"image:surfacecopy");
   memory->create(rgbcopy,3*npixels,"image:rgbcopy");
+
+  // row tiles owned by each proc after binary-swap compositing
+  // only first nswap = largest power-of-2 <= nprocs procs own a tile
+
+  nswap = 1;
+  while (2*nswap <= nprocs) nswap *= 2;
+
+  memory->create(tilelo,nprocs,"image:tilelo");
+  memory->create(tilehi,nprocs,"image:tilehi");
+  memory->create(tilecounts,nprocs,"image:tilecounts");
+  memory->create(tiledispls,nprocs,"image:tiledispls");
+  // one request per swap partner, or 3 for a single rgb/depth/surface swap
+
+  int nrequest = MAX(nprocs,3);
+  requests = new MPI_Request[nrequest];
+  statuses = new MPI_Status[nrequest];
+
+  int lo,hi,mid;
+  for (int iproc = 0; iproc < nprocs; iproc++) {
+    lo = hi = 0;
+    if (iproc < nswap) {
+      hi = height;
+      for (int mask = nswap/2; mask; mask /= 2) {
+        mid = lo + (hi-lo)/2;
+        if (iproc & mask) lo = mid;
+        else hi = mid;
+      }
+    }
+    tilelo[iproc] = lo;
+    tilehi[iproc] = hi;
+    tilecounts[iproc] = (hi-lo)*width*3;
+    tiledispls[iproc] = lo*width*3;
+  }
+
+  rowlo = tilelo[me];
+  rowhi = tilehi[me];
 }
 
 /* ----------------------------------------------------------------------
@@ -288,67 +337,146 @@ void Image::clear()
 /* ----------------------------------------------------------------------
    merge image from each processor into one composite image
    done pixel by pixel, respecting depth buffer
-   hi procs send to lo procs, cascading down logarithmically
+   procs beyond largest power-of-2 fold their image into a lower proc,
+   then binary-swap: at each stage partners exchange half their current
+   row range, so each proc ends up owning a fully composited tile of rows
+   SSAO is applied per tile, then tiles are gathered to proc 0
 ------------------------------------------------------------------------- */
 
 void Image::merge()
 {
-  MPI_Request requests[3];
-  MPI_Status statuses[3];
+  int i,n,nbytes,nrecv;
+
+  // fold procs >= nswap into lower procs
+
+  if (me < nswap && me+nswap < nprocs) {
+    nrecv = 0;
+    MPI_Irecv(rgbcopy,npixels*3,MPI_BYTE,me+nswap,0,world,&requests[nrecv++]);
+    MPI_Irecv(depthcopy,npixels,MPI_DOUBLE,me+nswap,0,world,
+              &requests[nrecv++]);
+    if (ssao)
+      MPI_Irecv(surfacecopy,npixels*2,MPI_DOUBLE,me+nswap,0,world,
+                &requests[nrecv++]);
+    MPI_Waitall(nrecv,requests,statuses);
+    composite(0,npixels,1);
+  } else if (me >= nswap) {
+    MPI_Send(imageBuffer,npixels*3,MPI_BYTE,me-nswap,0,world);
+    MPI_Send(depthBuffer,npixels,MPI_DOUBLE,me-nswap,0,world);
+    if (ssao) MPI_Send(surfaceBuffer,npixels*2,MPI_DOUBLE,me-nswap,0,world);
+  }
 
-  int nhalf = 1;
-  while (nhalf < nprocs) nhalf *= 2;
-  nhalf /= 2;
+  // binary-swap among first nswap procs
+  // lower partner keeps lower half of rows, upper partner keeps upper half
+
+  if (me < nswap) {
+    int lo = 0;
+    int hi = height;
+    int mid,partner,keeplo,keephi,sendlo,sendhi;
+
+    for (int mask = nswap/2; mask; mask /= 2) {
+      partner = me ^ mask;
+      mid = lo + (hi-lo)/2;
+      if (me & mask) {
+        keeplo = mid; keephi = hi;
+        sendlo = lo; sendhi = mid;
+      } else {
+        keeplo = lo; keephi = mid;
+        sendlo = mid; sendhi = hi;
+      }
 
-  while (nhalf) {
-    if (me < nhalf && me+nhalf < nprocs) {
-      MPI_Irecv(rgbcopy,npixels*3,MPI_BYTE,me+nhalf,0,world,&requests[0]);
-      MPI_Irecv(depthcopy,npixels,MPI_DOUBLE,me+nhalf,0,world,&requests[1]);
+      i = keeplo*width;
+      n = (keephi-keeplo)*width;
+      nrecv = 0;
+      MPI_Irecv(&rgbcopy[i*3],n*3,MPI_BYTE,partner,0,world,&requests[nrecv++]);
+      MPI_Irecv(&depthcopy[i],n,MPI_DOUBLE,partner,0,world,
+                &requests[nrecv++]);
       if (ssao)
-        MPI_Irecv(surfacecopy,npixels*2,MPI_DOUBLE,
-                  me+nhalf,0,world,&requests[2]);
-      if (ssao) MPI_Waitall(3,requests,statuses);
-      else MPI_Waitall(2,requests,statuses);
-
-      for (int i = 0; i < npixels; i++) {
-        if (depthBuffer[i] < 0 || (depthcopy[i] >= 0 &&
-                                   depthcopy[i] < depthBuffer[i])) {
-          depthBuffer[i] = depthcopy[i];
-          imageBuffer[i*3+0] = rgbcopy[i*3+0];
-          imageBuffer[i*3+1] = rgbcopy[i*3+1];
-          imageBuffer[i*3+2] = rgbcopy[i*3+2];
-          if (ssao) {
-            surfaceBuffer[i*2+0] = surfacecopy[i*2+0];
-            surfaceBuffer[i*2+1] = surfacecopy[i*2+1];
-          }
-        }
-      }
+        MPI_Irecv(&surfacecopy[i*2],n*2,MPI_DOUBLE,partner,0,world,
+                  &requests[nrecv++]);
 
-    } else if (me >= nhalf && me < 2*nhalf) {
-      MPI_Send(imageBuffer,npixels*3,MPI_BYTE,me-nhalf,0,world);
-      MPI_Send(depthBuffer,npixels,MPI_DOUBLE,me-nhalf,0,world);
-      if (ssao) MPI_Send(surfaceBuffer,npixels*2,MPI_DOUBLE,me-nhalf,0,world);
-    }
+      i = sendlo*width;
+      n = (sendhi-sendlo)*width;
+      MPI_Send(&imageBuffer[i*3],n*3,MPI_BYTE,partner,0,world);
+      MPI_Send(&depthBuffer[i],n,MPI_DOUBLE,partner,0,world);
+      if (ssao) MPI_Send(&surfaceBuffer[i*2],n*2,MPI_DOUBLE,partner,0,world);
+
+      MPI_Waitall(nrecv,requests,statuses);
 
-    nhalf /= 2;
+      // on equal depth, lower proc wins as in a tree reduction onto proc 0
+
+      composite(keeplo*width,keephi*width,(me & mask) ? 0 : 1);
+      lo = keeplo;
+      hi = keephi;
+    }
   }
 
   // extra SSAO enhancement
-  // bcast full image to all procs
-  // each works on subset of pixels
-  // gather result back to proc 0
+  // each proc needs depth of rows within SSAO radius of its own tile
+  // exchange those halo rows with the owning procs
 
   if (ssao) {
-    MPI_Bcast(imageBuffer,npixels*3,MPI_BYTE,0,world);
-    MPI_Bcast(surfaceBuffer,npixels*2,MPI_DOUBLE,0,world);
-    MPI_Bcast(depthBuffer,npixels,MPI_DOUBLE,0,world);
+    double pixelWidth = (tanPerPixel > 0) ? tanPerPixel : -tanPerPixel / zoom;
+    int halo = static_cast<int> (SSAORadius / pixelWidth + 0.5) + 2;
+
+    int needlo,needhi,otherlo,otherhi;
+    int mylo = MAX(rowlo-halo,0);
+    int myhi = MIN(rowhi+halo,height);
+
+    nrecv = 0;
+    if (me < nswap) {
+      for (int iproc = 0; iproc < nswap; iproc++) {
+        if (iproc == me) continue;
+        needlo = MAX(mylo,tilelo[iproc]);
+        needhi = MIN(myhi,tilehi[iproc]);
+        if (needlo >= needhi) continue;
+        MPI_Irecv(&depthBuffer[needlo*width],(needhi-needlo)*width,
+                  MPI_DOUBLE,iproc,0,world,&requests[nrecv++]);
+      }
+      for (int iproc = 0; iproc < nswap; iproc++) {
+        if (iproc == me) continue;
+        otherlo = MAX(tilelo[iproc]-halo,0);
+        otherhi = MIN(tilehi[iproc]+halo,height);
+        needlo = MAX(otherlo,rowlo);
+        needhi = MIN(otherhi,rowhi);
+        if (needlo >= needhi) continue;
+        MPI_Send(&depthBuffer[needlo*width],(needhi-needlo)*width,
+                 MPI_DOUBLE,iproc,0,world);
+      }
+      MPI_Waitall(nrecv,requests,statuses);
+    }
+
     compute_SSAO();
-    int pixelPart = height/nprocs * width*3;
-    MPI_Gather(imageBuffer+me*pixelPart,pixelPart,MPI_BYTE,
-               rgbcopy,pixelPart,MPI_BYTE,0,world);
-    writeBuffer = rgbcopy;
-  } else {
-    writeBuffer = imageBuffer;
+  }
+
+  // gather tiles of composited image to proc 0
+
+  nbytes = (rowhi-rowlo)*width*3;
+  MPI_Gatherv(&imageBuffer[rowlo*width*3],nbytes,MPI_BYTE,
+              rgbcopy,tilecounts,tiledispls,MPI_BYTE,0,world);
+  writeBuffer = rgbcopy;
+}
+
+/* ----------------------------------------------------------------------
+   composite copy buffers into image buffers for pixels ilo to ihi-1
+   lowflag = 1 if this proc's pixel wins on equal depth, else copy wins
+------------------------------------------------------------------------- */
+
+void Image::composite(int ilo, int ihi, int lowflag)
+{
+  for (int i = ilo; i < ihi; i++) {
+    if (depthcopy[i] < 0) continue;
+    if (depthBuffer[i] >= 0) {
+      if (lowflag && depthcopy[i] >= depthBuffer[i]) continue;
+      if (!lowflag && depthcopy[i] > depthBuffer[i]) continue;
+    }
+    depthBuffer[i] = depthcopy[i];
+    imageBuffer[i*3+0] = rgbcopy[i*3+0];
+    imageBuffer[i*3+1] = rgbcopy[i*3+1];
+    imageBuffer[i*3+2] = rgbcopy[i*3+2];
+    if (ssao) {
+      surfaceBuffer[i*2+0] = surfacecopy[i*2+0];
+      surfaceBuffer[i*2+1] = surfacecopy[i*2+1];
+    }
   }
 }
 
@@ -883,9 +1011,8 @@ void Image::compute_SSAO()
   int pixelRadius = (int) trunc (SSAORadius / pixelWidth + 0.5);
 
   int x,y,s;
-  int hPart = height / nprocs;
-  int index = me * hPart * width;
-  for (y = me * hPart; y < (me + 1) * hPart; y ++) {
+  int index = rowlo * width;
+  for (y = rowlo; y < rowhi; y ++) {
     for (x = 0; x < width; x ++, index ++) {
       double cdepth = depthBuffer[index];
       if (cdepth < 0) { continue; }
@@ -1088,6 +1215,20 @@ void Image::write_PPM(FILE *fp)
     fwrite(&writeBuffer[y*width*3],3,width,fp);
 }
 
+/* ----------------------------------------------------------------------
+   copy pixel data of a PPM image without header into buf
+   buf must hold 3*width*height bytes
+------------------------------------------------------------------------- */
+
+void Image::pack_PPM(unsigned char *buf)
+{
+  int y;
+  for (y = height-1; y >= 0; y--) {
+    memcpy(buf,&writeBuffer[y*width*3],3*width);
+    buf += 3*width;
+  }
+}
+
 /* ----------------------------------------------------------------------
    return static/dynamic status of color map index
 ------------------------------------------------------------------------- */
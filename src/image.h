@@ -43,6 +43,7 @@ class Image : protected Pointers {
   void write_JPG(FILE *);
   void write_PNG(FILE *);
   void write_PPM(FILE *);
+  void pack_PPM(unsigned char *);
   void view_params(double, double, double, double, double, double);
 
   void draw_sphere(double *, double *, double);
@@ -74,6 +75,15 @@ class Image : protected Pointers {
   double *depthcopy,*surfacecopy;
   unsigned char *imageBuffer,*rgbcopy,*writeBuffer;
 
+  // binary-swap compositing tiles
+
+  int nswap;                    // # of procs that own a tile
+  int rowlo,rowhi;              // rows of image this proc owns
+  int *tilelo,*tilehi;          // rows owned by each proc
+  int *tilecounts,*tiledispls;  // per-proc bytes and offsets for gather
+  MPI_Request *requests;
+  MPI_Status *statuses;
+
   // constant view params
 
   double FOV;
@@ -119,6 +129,7 @@ class Image : protected Pointers {
   // internal methods
 
   void draw_pixel(int, int, double, double *, double*);
+  void composite(int, int, int);
   void compute_SSAO();
 
   // inline functions
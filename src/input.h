@@ -123,6 +123,7 @@ class Input : protected Pointers {
   void thermo();
   void thermo_modify();
   void thermo_style();
+  void timer_command();
   void timestep();
   void uncompute();
   void undump();
@@ -18,6 +18,7 @@
 #include "comm.h"
 #include "force.h"
 #include "pair.h"
+#include "modify.h"
 #include "memory.h"
 #include "atom_masks.h"
 #include "error.h"
@@ -47,6 +48,8 @@ KSpace::KSpace(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
   minorder = 2;
   overlap_allowed = 1;
   fftbench = 0;
+  every = 1;
+  extrapolate = IMPULSE;
 
   // default to using MPI collectives for FFT/remap only on IBM BlueGene
 
@@ -501,6 +504,31 @@ void KSpace::modify_params(int narg, char **arg)
       else if (strcmp(arg[iarg+1],"no") == 0) fftbench = 0;
       else error->all(FLERR,"Illegal kspace_modify command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"every") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
+      every = force->inumeric(FLERR,arg[iarg+1]);
+      if (every <= 0) error->all(FLERR,"Kspace_modify every must be > 0");
+
+      // fix storing the forces between evaluations is created here,
+      // so that output commands can reference it before the first run
+
+      int ifix = modify->find_fix("KSPACE_MTS");
+      if (every > 1 && ifix < 0) {
+        char **fixarg = new char*[3];
+        fixarg[0] = (char *) "KSPACE_MTS";
+        fixarg[1] = (char *) "all";
+        fixarg[2] = (char *) "KSPACE_MTS";
+        modify->add_fix(3,fixarg);
+        delete [] fixarg;
+      } else if (every == 1 && ifix >= 0) modify->delete_fix("KSPACE_MTS");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"extrapolate") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
+      if (strcmp(arg[iarg+1],"impulse") == 0) extrapolate = IMPULSE;
+      else if (strcmp(arg[iarg+1],"constant") == 0) extrapolate = CONSTANT;
+      else if (strcmp(arg[iarg+1],"linear") == 0) extrapolate = LINEAR;
+      else error->all(FLERR,"Illegal kspace_modify command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"collective") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
       if (strcmp(arg[iarg+1],"yes") == 0) collective_flag = 1;
@@ -81,6 +81,9 @@ class KSpace : protected Pointers {
   unsigned int datamask_read,datamask_modify;
 
   int compute_flag;               // 0 if skip compute()
+  int every;                      // evaluate every this many steps
+  enum{IMPULSE,CONSTANT,LINEAR};  // extrapolate options
+  int extrapolate;                // force between evaluations, see kspace.cpp
   int fftbench;                   // 0 if skip FFT timing
   int collective_flag;            // 1 if use MPI collectives for FFT/remap
   int stagger_flag;               // 1 if using staggered PPPM grids
@@ -236,4 +239,8 @@ E: Kspace_modify eigtol must be smaller than one
 
 Self-explanatory.
 
+E: Kspace_modify every must be > 0
+
+Self-explanatory.
+
 */
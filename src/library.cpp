@@ -140,6 +140,7 @@ void *lammps_extract_global(void *ptr, char *name)
   if (strcmp(name,"yz") == 0) return (void *) &lmp->domain->yz;
   if (strcmp(name,"natoms") == 0) return (void *) &lmp->atom->natoms;
   if (strcmp(name,"nlocal") == 0) return (void *) &lmp->atom->nlocal;
+  if (strcmp(name,"nmax") == 0) return (void *) &lmp->atom->nmax;
   return NULL;
 }
 
@@ -425,7 +426,7 @@ void lammps_gather_atoms(void *ptr, char *name,
       for (i = 0; i < nlocal; i++) {
         offset = count*(tag[i]-1);
         for (j = 0; j < count; j++)
-          copy[offset++] = array[i][0];
+          copy[offset++] = array[i][j];
       }
 
     MPI_Allreduce(copy,data,count*natoms,MPI_INT,MPI_SUM,lmp->world);
@@ -535,3 +536,350 @@ void lammps_scatter_atoms(void *ptr, char *name,
     }
   }
 }
+
+/* ----------------------------------------------------------------------
+   gather the named atom-based entity onto processor 0 only
+   same arguments and data layout as lammps_gather_atoms()
+   data only needs to be allocated on processor 0, ignored on others
+   only procs with atoms send them, so total communication is
+     natoms*count values instead of an Allreduce of that length
+------------------------------------------------------------------------- */
+
+void lammps_gather_atoms_root(void *ptr, char *name,
+                              int type, int count, void *data)
+{
+  LAMMPS *lmp = (LAMMPS *) ptr;
+
+  // error if tags are not defined or not consecutive
+
+  int flag = 0;
+  if (lmp->atom->tag_enable == 0 || lmp->atom->tag_consecutive() == 0) flag = 1;
+  if (lmp->atom->natoms > MAXSMALLINT) flag = 1;
+  if (flag) {
+    if (lmp->comm->me == 0)
+      lmp->error->warning(FLERR,"Library error in lammps_gather_atoms_root");
+    return;
+  }
+
+  int natoms = static_cast<int> (lmp->atom->natoms);
+  int me = lmp->comm->me;
+  int nprocs = lmp->comm->nprocs;
+
+  int i,j,k,offset;
+  void *vptr = lmp->atom->extract(name);
+  tagint *tag = lmp->atom->tag;
+  int nlocal = lmp->atom->nlocal;
+
+  // gather per-proc atom counts and atom IDs onto proc 0
+
+  int *recvcounts = NULL;
+  int *displs = NULL;
+  if (me == 0) {
+    lmp->memory->create(recvcounts,nprocs,"lib/gather:recvcounts");
+    lmp->memory->create(displs,nprocs,"lib/gather:displs");
+  }
+
+  MPI_Gather(&nlocal,1,MPI_INT,recvcounts,1,MPI_INT,0,lmp->world);
+
+  int ntotal = 0;
+  if (me == 0)
+    for (i = 0; i < nprocs; i++) {
+      displs[i] = ntotal;
+      ntotal += recvcounts[i];
+    }
+
+  tagint *tags = NULL;
+  if (me == 0) lmp->memory->create(tags,ntotal,"lib/gather:tags");
+  MPI_Gatherv(tag,nlocal,MPI_LMP_TAGINT,tags,recvcounts,displs,
+              MPI_LMP_TAGINT,0,lmp->world);
+
+  if (me == 0)
+    for (i = 0; i < nprocs; i++) {
+      recvcounts[i] *= count;
+      displs[i] *= count;
+    }
+
+  // gather values in per-proc order, then proc 0 orders them by atom ID
+  // per-atom vectors are sent in place, arrays are packed first
+
+  if (type == 0) {
+    int *vector = NULL;
+    int **array = NULL;
+    if (count == 1) vector = (int *) vptr;
+    else array = (int **) vptr;
+
+    int *sendbuf = vector;
+    if (count > 1) {
+      lmp->memory->create(sendbuf,count*nlocal,"lib/gather:sendbuf");
+      offset = 0;
+      for (i = 0; i < nlocal; i++)
+        for (j = 0; j < count; j++)
+          sendbuf[offset++] = array[i][j];
+    }
+
+    int *copy = NULL;
+    if (me == 0) lmp->memory->create(copy,count*ntotal,"lib/gather:copy");
+    MPI_Gatherv(sendbuf,count*nlocal,MPI_INT,copy,recvcounts,displs,
+                MPI_INT,0,lmp->world);
+
+    if (me == 0) {
+      int *dptr = (int *) data;
+      for (i = 0; i < count*natoms; i++) dptr[i] = 0;
+      for (k = 0; k < ntotal; k++) {
+        if (tags[k] < 1 || tags[k] > natoms) continue;
+        offset = count*(tags[k]-1);
+        for (j = 0; j < count; j++)
+          dptr[offset+j] = copy[count*k+j];
+      }
+    }
+
+    if (count > 1) lmp->memory->destroy(sendbuf);
+    lmp->memory->destroy(copy);
+
+  } else {
+    double *vector = NULL;
+    double **array = NULL;
+    if (count == 1) vector = (double *) vptr;
+    else array = (double **) vptr;
+
+    double *sendbuf = vector;
+    if (count > 1) {
+      lmp->memory->create(sendbuf,count*nlocal,"lib/gather:sendbuf");
+      offset = 0;
+      for (i = 0; i < nlocal; i++)
+        for (j = 0; j < count; j++)
+          sendbuf[offset++] = array[i][j];
+    }
+
+    double *copy = NULL;
+    if (me == 0) lmp->memory->create(copy,count*ntotal,"lib/gather:copy");
+    MPI_Gatherv(sendbuf,count*nlocal,MPI_DOUBLE,copy,recvcounts,displs,
+                MPI_DOUBLE,0,lmp->world);
+
+    if (me == 0) {
+      double *dptr = (double *) data;
+      for (i = 0; i < count*natoms; i++) dptr[i] = 0.0;
+      for (k = 0; k < ntotal; k++) {
+        if (tags[k] < 1 || tags[k] > natoms) continue;
+        offset = count*(tags[k]-1);
+        for (j = 0; j < count; j++)
+          dptr[offset+j] = copy[count*k+j];
+      }
+    }
+
+    if (count > 1) lmp->memory->destroy(sendbuf);
+    lmp->memory->destroy(copy);
+  }
+
+  lmp->memory->destroy(recvcounts);
+  lmp->memory->destroy(displs);
+  lmp->memory->destroy(tags);
+}
+
+/* ----------------------------------------------------------------------
+   gather the named atom-based entity for a subset of atoms
+   name,type,count = same as for lammps_gather_atoms()
+   ndata = # of atoms in subset
+   ids = IDs of the atoms in subset, same on all procs
+   return values in data on all procs, ordered by count, then by
+     position in ids, e.g. x[ids[0]][0],x[ids[0]][1],x[ids[0]][2],...
+   data must be pre-allocated by caller to length ndata*count
+   communication scales with ndata, not with total # of atoms
+   atom IDs not found are returned as zeroes
+------------------------------------------------------------------------- */
+
+void lammps_gather_atoms_subset(void *ptr, char *name,
+                                int type, int count,
+                                int ndata, int *ids, void *data)
+{
+  LAMMPS *lmp = (LAMMPS *) ptr;
+
+  // error if tags are not defined or no atom map
+
+  int flag = 0;
+  if (lmp->atom->tag_enable == 0) flag = 1;
+  if (lmp->atom->map_style == 0) flag = 1;
+  if (flag) {
+    if (lmp->comm->me == 0)
+      lmp->error->warning(FLERR,"Library error in lammps_gather_atoms_subset");
+    return;
+  }
+
+  int i,j,m,offset;
+  void *vptr = lmp->atom->extract(name);
+  int nlocal = lmp->atom->nlocal;
+
+  // each owning proc inserts its atoms' values into copy
+  // MPI_Allreduce with MPI_SUM to merge into data
+
+  if (type == 0) {
+    int *vector = NULL;
+    int **array = NULL;
+    if (count == 1) vector = (int *) vptr;
+    else array = (int **) vptr;
+
+    int *copy;
+    lmp->memory->create(copy,count*ndata,"lib/gather:copy");
+    for (i = 0; i < count*ndata; i++) copy[i] = 0;
+
+    for (i = 0; i < ndata; i++) {
+      m = lmp->atom->map(ids[i]);
+      if (m < 0 || m >= nlocal) continue;
+      if (count == 1) copy[i] = vector[m];
+      else {
+        offset = count*i;
+        for (j = 0; j < count; j++)
+          copy[offset++] = array[m][j];
+      }
+    }
+
+    MPI_Allreduce(copy,data,count*ndata,MPI_INT,MPI_SUM,lmp->world);
+    lmp->memory->destroy(copy);
+
+  } else {
+    double *vector = NULL;
+    double **array = NULL;
+    if (count == 1) vector = (double *) vptr;
+    else array = (double **) vptr;
+
+    double *copy;
+    lmp->memory->create(copy,count*ndata,"lib/gather:copy");
+    for (i = 0; i < count*ndata; i++) copy[i] = 0.0;
+
+    for (i = 0; i < ndata; i++) {
+      m = lmp->atom->map(ids[i]);
+      if (m < 0 || m >= nlocal) continue;
+      if (count == 1) copy[i] = vector[m];
+      else {
+        offset = count*i;
+        for (j = 0; j < count; j++)
+          copy[offset++] = array[m][j];
+      }
+    }
+
+    MPI_Allreduce(copy,data,count*ndata,MPI_DOUBLE,MPI_SUM,lmp->world);
+    lmp->memory->destroy(copy);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   scatter the named atom-based entity for a subset of atoms
+   name,type,count = same as for lammps_scatter_atoms()
+   ndata,ids = same as for lammps_gather_atoms_subset()
+   data = values ordered by count, then by position in ids,
+     same on all procs
+------------------------------------------------------------------------- */
+
+void lammps_scatter_atoms_subset(void *ptr, char *name,
+                                 int type, int count,
+                                 int ndata, int *ids, void *data)
+{
+  LAMMPS *lmp = (LAMMPS *) ptr;
+
+  // error if tags are not defined or no atom map
+
+  int flag = 0;
+  if (lmp->atom->tag_enable == 0) flag = 1;
+  if (lmp->atom->map_style == 0) flag = 1;
+  if (flag) {
+    if (lmp->comm->me == 0)
+      lmp->error->warning(FLERR,"Library error in lammps_scatter_atoms_subset");
+    return;
+  }
+
+  int i,j,m,offset;
+  void *vptr = lmp->atom->extract(name);
+
+  if (type == 0) {
+    int *vector = NULL;
+    int **array = NULL;
+    if (count == 1) vector = (int *) vptr;
+    else array = (int **) vptr;
+    int *dptr = (int *) data;
+
+    for (i = 0; i < ndata; i++) {
+      if ((m = lmp->atom->map(ids[i])) < 0) continue;
+      if (count == 1) vector[m] = dptr[i];
+      else {
+        offset = count*i;
+        for (j = 0; j < count; j++)
+          array[m][j] = dptr[offset++];
+      }
+    }
+  } else {
+    double *vector = NULL;
+    double **array = NULL;
+    if (count == 1) vector = (double *) vptr;
+    else array = (double **) vptr;
+    double *dptr = (double *) data;
+
+    for (i = 0; i < ndata; i++) {
+      if ((m = lmp->atom->map(ids[i])) < 0) continue;
+      if (count == 1) vector[m] = dptr[i];
+      else {
+        offset = count*i;
+        for (j = 0; j < count; j++)
+          array[m][j] = dptr[offset++];
+      }
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   direct access to a per-atom quantity of atoms owned by this proc
+   name = desired quantity, e.g. x or rho or colorgradient
+   return type = 0 for int, 1 for double, 2 for 64-bit int values
+   return count = # of values per atom
+   return data = pointer to 1st value, values of owned atom i are
+     data[count*i] to data[count*i+count-1], NULL if name not recognized
+   return # of owned atoms on this proc
+   no data is copied or communicated, data can be read or changed
+     in place until LAMMPS runs again and may reallocate or
+     reorder its atoms
+------------------------------------------------------------------------- */
+
+int lammps_extract_atom_owned(void *ptr, char *name,
+                              int *type, int *count, void **data)
+{
+  LAMMPS *lmp = (LAMMPS *) ptr;
+  *data = lmp->atom->extract_local(name,*type,*count);
+  return lmp->atom->nlocal;
+}
+
+/* ----------------------------------------------------------------------
+   direct access to per-atom values of a compute for atoms owned by this proc
+   id = compute ID
+   return count = # of values per atom, 1 for vector_atom
+   return data = pointer to 1st value, values of owned atom i are
+     data[count*i] to data[count*i+count-1], NULL if compute does not
+     exist or does not produce per-atom values
+   IMPORTANT: if the compute is not current it will be invoked,
+     as for lammps_extract_compute(), so caller must insure that it is OK
+   return # of owned atoms on this proc
+------------------------------------------------------------------------- */
+
+int lammps_extract_compute_owned(void *ptr, char *id, int *count, void **data)
+{
+  LAMMPS *lmp = (LAMMPS *) ptr;
+
+  *count = 1;
+  *data = NULL;
+
+  int icompute = lmp->modify->find_compute(id);
+  if (icompute < 0) return lmp->atom->nlocal;
+  Compute *compute = lmp->modify->compute[icompute];
+  if (!compute->peratom_flag) return lmp->atom->nlocal;
+
+  if (compute->invoked_peratom != lmp->update->ntimestep)
+    compute->compute_peratom();
+
+  // 2d per-atom arrays are allocated contiguously by Memory::create()
+
+  if (compute->size_peratom_cols == 0) *data = (void *) compute->vector_atom;
+  else {
+    *count = compute->size_peratom_cols;
+    if (compute->array_atom) *data = (void *) &compute->array_atom[0][0];
+  }
+
+  return lmp->atom->nlocal;
+}
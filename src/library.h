@@ -40,6 +40,11 @@ void *lammps_extract_variable(void *, char *, char *);
 int lammps_get_natoms(void *);
 void lammps_gather_atoms(void *, char *, int, int, void *);
 void lammps_scatter_atoms(void *, char *, int, int, void *);
+void lammps_gather_atoms_root(void *, char *, int, int, void *);
+void lammps_gather_atoms_subset(void *, char *, int, int, int, int *, void *);
+void lammps_scatter_atoms_subset(void *, char *, int, int, int, int *, void *);
+int lammps_extract_atom_owned(void *, char *, int *, int *, void **);
+int lammps_extract_compute_owned(void *, char *, int *, void **);
 
 #ifdef __cplusplus
 }
@@ -58,4 +63,21 @@ This library function cannot be used if atom IDs are not defined or
 are not consecutively numbered, or if no atom map is defined.  See the
 atom_modify command for details about atom maps.
 
+W: Library error in lammps_gather_atoms_root
+
+This library function cannot be used if atom IDs are not defined
+or are not consecutively numbered.
+
+W: Library error in lammps_gather_atoms_subset
+
+This library function cannot be used if atom IDs are not defined or if
+no atom map is defined.  See the atom_modify command for details about
+atom maps.
+
+W: Library error in lammps_scatter_atoms_subset
+
+This library function cannot be used if atom IDs are not defined or if
+no atom map is defined.  See the atom_modify command for details about
+atom maps.
+
 */
@@ -23,6 +23,7 @@
 #include "group.h"
 #include "update.h"
 #include "domain.h"
+#include "timer.h"
 #include "memory.h"
 #include "error.h"
 
@@ -33,6 +34,9 @@ using namespace FixConst;
 #define BIG 1.0e20
 #define NEXCEPT 5       // change when add to exceptions in add_fix()
 
+#define INVOKED_SCALAR 1
+#define INVOKED_VECTOR 2
+
 /* ---------------------------------------------------------------------- */
 
 Modify::Modify(LAMMPS *lmp) : Pointers(lmp)
@@ -62,8 +66,19 @@ Modify::Modify(LAMMPS *lmp) : Pointers(lmp)
 
   end_of_step_every = NULL;
 
+  fix_region = NULL;
+  region_initial_integrate = region_post_integrate = -1;
+  region_pre_exchange = region_pre_neighbor = -1;
+  region_pre_force = region_post_force = -1;
+  region_final_integrate = region_end_of_step = -1;
+
   list_timeflag = NULL;
 
+  maxreduce = maxreduce_values = 0;
+  reduce_list = NULL;
+  reduce_which = NULL;
+  reduce_one = reduce_all = NULL;
+
   nfix_restart_global = 0;
   id_restart_global = style_restart_global = state_restart_global = NULL;
   nfix_restart_peratom = 0;
@@ -134,6 +149,12 @@ Modify::~Modify()
 
   delete [] end_of_step_every;
   delete [] list_timeflag;
+  memory->destroy(fix_region);
+
+  memory->sfree(reduce_list);
+  memory->destroy(reduce_which);
+  memory->destroy(reduce_one);
+  memory->destroy(reduce_all);
 
   restart_deallocate();
 
@@ -182,6 +203,26 @@ void Modify::init()
   list_init(MIN_POST_FORCE,n_min_post_force,list_min_post_force);
   list_init(MIN_ENERGY,n_min_energy,list_min_energy);
 
+  // timer regions for each stage and each fix within it
+
+  region_initial_integrate = timer->region_create("initial_integrate");
+  region_post_integrate = timer->region_create("post_integrate");
+  region_pre_exchange = timer->region_create("pre_exchange");
+  region_pre_neighbor = timer->region_create("pre_neighbor");
+  region_pre_force = timer->region_create("pre_force");
+  region_post_force = timer->region_create("post_force");
+  region_final_integrate = timer->region_create("final_integrate");
+  region_end_of_step = timer->region_create("end_of_step");
+
+  memory->destroy(fix_region);
+  memory->create(fix_region,nfix,"modify:fix_region");
+  for (i = 0; i < nfix; i++) {
+    char *name = new char[strlen(fix[i]->id)+strlen(fix[i]->style)+6];
+    sprintf(name,"fix %s %s",fix[i]->id,fix[i]->style);
+    fix_region[i] = timer->region_create(name);
+    delete [] name;
+  }
+
   // init each fix
   // not sure if now needs to come before compute init
   // used to b/c temperature computes called fix->dof() in their init,
@@ -332,8 +373,13 @@ void Modify::setup_pre_force(int vflag)
 
 void Modify::initial_integrate(int vflag)
 {
-  for (int i = 0; i < n_initial_integrate; i++)
+  timer->region_start(region_initial_integrate);
+  for (int i = 0; i < n_initial_integrate; i++) {
+    timer->region_start(fix_region[list_initial_integrate[i]]);
     fix[list_initial_integrate[i]]->initial_integrate(vflag);
+    timer->region_stop(fix_region[list_initial_integrate[i]]);
+  }
+  timer->region_stop(region_initial_integrate);
 }
 
 /* ----------------------------------------------------------------------
@@ -342,8 +388,13 @@ void Modify::initial_integrate(int vflag)
 
 void Modify::post_integrate()
 {
-  for (int i = 0; i < n_post_integrate; i++)
+  timer->region_start(region_post_integrate);
+  for (int i = 0; i < n_post_integrate; i++) {
+    timer->region_start(fix_region[list_post_integrate[i]]);
     fix[list_post_integrate[i]]->post_integrate();
+    timer->region_stop(fix_region[list_post_integrate[i]]);
+  }
+  timer->region_stop(region_post_integrate);
 }
 
 /* ----------------------------------------------------------------------
@@ -352,8 +403,13 @@ void Modify::post_integrate()
 
 void Modify::pre_exchange()
 {
-  for (int i = 0; i < n_pre_exchange; i++)
+  timer->region_start(region_pre_exchange);
+  for (int i = 0; i < n_pre_exchange; i++) {
+    timer->region_start(fix_region[list_pre_exchange[i]]);
     fix[list_pre_exchange[i]]->pre_exchange();
+    timer->region_stop(fix_region[list_pre_exchange[i]]);
+  }
+  timer->region_stop(region_pre_exchange);
 }
 
 /* ----------------------------------------------------------------------
@@ -362,8 +418,13 @@ void Modify::pre_exchange()
 
 void Modify::pre_neighbor()
 {
-  for (int i = 0; i < n_pre_neighbor; i++)
+  timer->region_start(region_pre_neighbor);
+  for (int i = 0; i < n_pre_neighbor; i++) {
+    timer->region_start(fix_region[list_pre_neighbor[i]]);
     fix[list_pre_neighbor[i]]->pre_neighbor();
+    timer->region_stop(fix_region[list_pre_neighbor[i]]);
+  }
+  timer->region_stop(region_pre_neighbor);
 }
 
 /* ----------------------------------------------------------------------
@@ -372,8 +433,13 @@ void Modify::pre_neighbor()
 
 void Modify::pre_force(int vflag)
 {
-  for (int i = 0; i < n_pre_force; i++)
+  timer->region_start(region_pre_force);
+  for (int i = 0; i < n_pre_force; i++) {
+    timer->region_start(fix_region[list_pre_force[i]]);
     fix[list_pre_force[i]]->pre_force(vflag);
+    timer->region_stop(fix_region[list_pre_force[i]]);
+  }
+  timer->region_stop(region_pre_force);
 }
 
 /* ----------------------------------------------------------------------
@@ -382,8 +448,13 @@ void Modify::pre_force(int vflag)
 
 void Modify::post_force(int vflag)
 {
-  for (int i = 0; i < n_post_force; i++)
+  timer->region_start(region_post_force);
+  for (int i = 0; i < n_post_force; i++) {
+    timer->region_start(fix_region[list_post_force[i]]);
     fix[list_post_force[i]]->post_force(vflag);
+    timer->region_stop(fix_region[list_post_force[i]]);
+  }
+  timer->region_stop(region_post_force);
 }
 
 /* ----------------------------------------------------------------------
@@ -392,8 +463,13 @@ void Modify::post_force(int vflag)
 
 void Modify::final_integrate()
 {
-  for (int i = 0; i < n_final_integrate; i++)
+  timer->region_start(region_final_integrate);
+  for (int i = 0; i < n_final_integrate; i++) {
+    timer->region_start(fix_region[list_final_integrate[i]]);
     fix[list_final_integrate[i]]->final_integrate();
+    timer->region_stop(fix_region[list_final_integrate[i]]);
+  }
+  timer->region_stop(region_final_integrate);
 }
 
 /* ----------------------------------------------------------------------
@@ -403,9 +479,14 @@ void Modify::final_integrate()
 
 void Modify::end_of_step()
 {
+  timer->region_start(region_end_of_step);
   for (int i = 0; i < n_end_of_step; i++)
-    if (update->ntimestep % end_of_step_every[i] == 0)
+    if (update->ntimestep % end_of_step_every[i] == 0) {
+      timer->region_start(fix_region[list_end_of_step[i]]);
       fix[list_end_of_step[i]]->end_of_step();
+      timer->region_stop(fix_region[list_end_of_step[i]]);
+    }
+  timer->region_stop(region_end_of_step);
 }
 
 /* ----------------------------------------------------------------------
@@ -1015,6 +1096,80 @@ void Modify::addstep_compute(bigint newstep)
       compute[list_timeflag[icompute]]->addstep(newstep);
 }
 
+/* ----------------------------------------------------------------------
+   invoke a list of computes with their global sums batched together
+   clist = N computes, which = INVOKED_SCALAR or INVOKED_VECTOR for each
+   NULL entries in clist and other which values are skipped
+   only computes with reduceflag set and not yet invoked this step
+     are handled, each packs its local sums via pack_reduce()
+   a single MPI_Allreduce() replaces one per compute,
+     then each compute sets its result via unpack_reduce()
+   handled computes have invoked_flag set, so caller skips them
+   nextra values of caller's extra vector are summed in the same
+     MPI_Allreduce(), extra is overwritten with the global sums
+   called by output classes before they invoke computes one at a time
+------------------------------------------------------------------------- */
+
+void Modify::reduce_computes(int n, Compute **clist, int *which,
+                             int nextra, double *extra)
+{
+  int i,m;
+
+  if (n > maxreduce) {
+    maxreduce = n;
+    memory->sfree(reduce_list);
+    memory->destroy(reduce_which);
+    reduce_list = (Compute **)
+      memory->smalloc(maxreduce*sizeof(Compute *),"modify:reduce_list");
+    memory->create(reduce_which,maxreduce,"modify:reduce_which");
+  }
+
+  // select computes, a compute listed twice is only selected once
+  // size_reduce() = 0 means compute cannot batch its sums on this step
+
+  int nlist = 0;
+  int nvalues = 0;
+
+  for (i = 0; i < n; i++) {
+    if (clist[i] == NULL || !clist[i]->reduceflag) continue;
+    if (which[i] != INVOKED_SCALAR && which[i] != INVOKED_VECTOR) continue;
+    if (clist[i]->invoked_flag & which[i]) continue;
+    m = clist[i]->size_reduce(which[i]);
+    if (m == 0) continue;
+    clist[i]->invoked_flag |= which[i];
+    reduce_list[nlist] = clist[i];
+    reduce_which[nlist++] = which[i];
+    nvalues += m;
+  }
+
+  if (nlist == 0 && nextra == 0) return;
+
+  nvalues += nextra;
+  if (nvalues > maxreduce_values) {
+    maxreduce_values = nvalues;
+    memory->destroy(reduce_one);
+    memory->destroy(reduce_all);
+    memory->create(reduce_one,maxreduce_values,"modify:reduce_one");
+    memory->create(reduce_all,maxreduce_values,"modify:reduce_all");
+  }
+
+  m = 0;
+  for (i = 0; i < nlist; i++) {
+    reduce_list[i]->pack_reduce(reduce_which[i],&reduce_one[m]);
+    m += reduce_list[i]->size_reduce(reduce_which[i]);
+  }
+  for (i = 0; i < nextra; i++) reduce_one[m++] = extra[i];
+
+  MPI_Allreduce(reduce_one,reduce_all,nvalues,MPI_DOUBLE,MPI_SUM,world);
+
+  m = 0;
+  for (i = 0; i < nlist; i++) {
+    reduce_list[i]->unpack_reduce(reduce_which[i],&reduce_all[m]);
+    m += reduce_list[i]->size_reduce(reduce_which[i]);
+  }
+  for (i = 0; i < nextra; i++) extra[i] = reduce_all[m++];
+}
+
 /* ----------------------------------------------------------------------
    loop over all computes
    schedule next invocation for those that store invocation times
@@ -96,6 +96,7 @@ class Modify : protected Pointers {
   void clearstep_compute();
   void addstep_compute(bigint);
   void addstep_compute_all(bigint);
+  void reduce_computes(int, class Compute **, int *, int = 0, double * = NULL);
 
   void write_restart(FILE *);
   int read_restart(FILE *);
@@ -120,9 +121,20 @@ class Modify : protected Pointers {
 
   int *end_of_step_every;
 
+  int *fix_region;           // timer region of each fix for profiling
+  int region_initial_integrate,region_post_integrate;  // timer regions
+  int region_pre_exchange,region_pre_neighbor;         // of fix hooks
+  int region_pre_force,region_post_force;
+  int region_final_integrate,region_end_of_step;
+
   int n_timeflag;            // list of computes that store time invocation
   int *list_timeflag;
 
+  int maxreduce,maxreduce_values;     // batched sums in reduce_computes()
+  class Compute **reduce_list;
+  int *reduce_which;
+  double *reduce_one,*reduce_all;
+
   char **id_restart_global;           // stored fix global info
   char **style_restart_global;        // from read-in restart file
   char **state_restart_global;
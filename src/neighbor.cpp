@@ -37,6 +37,7 @@
 #include "respa.h"
 #include "output.h"
 #include "citeme.h"
+#include "timer.h"
 #include "memory.h"
 #include "error.h"
 
@@ -52,6 +53,8 @@ using namespace LAMMPS_NS;
 
 enum{NSQ,BIN,MULTI};     // also in neigh_list.cpp
 
+static void top2_merge(void *, void *, int *, MPI_Datatype *);
+
 static const char cite_neigh_multi[] =
   "neighbor multi command:\n\n"
   "@Article{Intveld08,\n"
@@ -82,6 +85,9 @@ Neighbor::Neighbor(LAMMPS *lmp) : Pointers(lmp)
   oneatom = 2000;
   binsizeflag = 0;
   build_once = 0;
+  validate = 0;
+  validate_pending = 0;
+  region_build = region_bin = region_list = region_topo = -1;
   cluster_check = 0;
   binatomflag = 1;
 
@@ -140,6 +146,12 @@ Neighbor::Neighbor(LAMMPS *lmp) : Pointers(lmp)
   old_nrequest = 0;
   old_requests = NULL;
 
+  // create MPI data and function types for AllReduce of 2 largest values
+
+  MPI_Type_contiguous(2,MPI_DOUBLE,&top2_type);
+  MPI_Type_commit(&top2_type);
+  MPI_Op_create(top2_merge,1,&top2_op);
+
   // bond lists
 
   maxbond = 0;
@@ -156,6 +168,9 @@ Neighbor::Neighbor(LAMMPS *lmp) : Pointers(lmp)
 
 Neighbor::~Neighbor()
 {
+  MPI_Type_free(&top2_type);
+  MPI_Op_free(&top2_op);
+
   memory->destroy(cutneighsq);
   memory->destroy(cutneighghostsq);
   delete [] cuttype;
@@ -205,10 +220,17 @@ void Neighbor::init()
   int i,j,m,n;
 
   ncalls = ndanger = 0;
+  nvalidate = nmissed = 0;
+  validate_pending = 0;
   dimension = domain->dimension;
   triclinic = domain->triclinic;
   newton_pair = force->newton_pair;
 
+  region_build = timer->region_create("neigh");
+  region_bin = timer->region_create("bin");
+  region_list = timer->region_create("pair_lists");
+  region_topo = timer->region_create("topology");
+
   // error check
 
   if (delay > 0 && (delay % every) != 0)
@@ -230,19 +252,19 @@ void Neighbor::init()
     bboxhi = domain->boxhi_bound;
   }
 
-  // set neighbor cutoffs (force cutoff + skin)
-  // trigger determines when atoms migrate and neighbor lists are rebuilt
-  //   needs to be non-zero for migration distance check
-  //   even if pair = NULL and no neighbor lists are used
-  // cutneigh = force cutoff + skin if cutforce > 0, else cutneigh = 0
-  // cutneighghost = pair cutghost if it requests it, else same as cutneigh
-
-  triggersq = 0.25*skin*skin;
   boxcheck = 0;
   if (domain->box_change && (domain->xperiodic || domain->yperiodic ||
                              (dimension == 3 && domain->zperiodic)))
       boxcheck = 1;
 
+  // KSpace ghost grids and fix srd assume no atom moves more than
+  //   1/2 the skin between builds, so check each atom against that too
+
+  atomcheck = 0;
+  if (force->kspace) atomcheck = 1;
+  for (i = 0; i < modify->nfix; i++)
+    if (strcmp(modify->fix[i]->style,"srd") == 0) atomcheck = 1;
+
   n = atom->ntypes;
   if (cutneighsq == NULL) {
     if (lmp->kokkos) init_cutneighsq_kokkos(n);
@@ -252,32 +274,9 @@ void Neighbor::init()
     cuttypesq = new double[n+1];
   }
 
-  double cutoff,delta,cut;
-  cutneighmin = BIG;
-  cutneighmax = 0.0;
-
-  for (i = 1; i <= n; i++) {
-    cuttype[i] = cuttypesq[i] = 0.0;
-    for (j = 1; j <= n; j++) {
-      if (force->pair) cutoff = sqrt(force->pair->cutsq[i][j]);
-      else cutoff = 0.0;
-      if (cutoff > 0.0) delta = skin;
-      else delta = 0.0;
-      cut = cutoff + delta;
-
-      cutneighsq[i][j] = cut*cut;
-      cuttype[i] = MAX(cuttype[i],cut);
-      cuttypesq[i] = MAX(cuttypesq[i],cut*cut);
-      cutneighmin = MIN(cutneighmin,cut);
-      cutneighmax = MAX(cutneighmax,cut);
+  // set neighbor cutoffs and trigger from force cutoffs and skin
 
-      if (force->pair && force->pair->ghostneigh) {
-        cut = force->pair->cutghost[i][j] + skin;
-        cutneighghostsq[i][j] = cut*cut;
-      } else cutneighghostsq[i][j] = cut*cut;
-    }
-  }
-  cutneighmaxsq = cutneighmax * cutneighmax;
+  init_cutneigh();
 
   // check other classes that can induce reneighboring in decide()
   // don't check if build_once is set
@@ -334,22 +333,6 @@ void Neighbor::init()
   if (special_flag[2] == 2) maxwt = 3;
   if (special_flag[3] == 2) maxwt = 4;
 
-  // rRESPA cutoffs
-
-  int respa = 0;
-  if (update->whichflag == 1 && strstr(update->integrate_style,"respa")) {
-    if (((Respa *) update->integrate)->level_inner >= 0) respa = 1;
-    if (((Respa *) update->integrate)->level_middle >= 0) respa = 2;
-  }
-
-  if (respa) {
-    double *cut_respa = ((Respa *) update->integrate)->cutoff;
-    cut_inner_sq = (cut_respa[1] + skin) * (cut_respa[1] + skin);
-    cut_middle_sq = (cut_respa[3] + skin) * (cut_respa[3] + skin);
-    cut_middle_inside_sq = (cut_respa[0] - skin) * (cut_respa[0] - skin);
-    if (cut_respa[0]-skin < 0) cut_middle_inside_sq = 0.0;
-  }
-
   // ------------------------------------------------------------------
   // xhold, bins, exclusion lists
 
@@ -909,6 +892,78 @@ void Neighbor::init()
   nbondlist = nanglelist = ndihedrallist = nimproperlist = 0;
 }
 
+/* ----------------------------------------------------------------------
+   set neighbor cutoffs (force cutoff + skin)
+   trigger determines when atoms migrate and neighbor lists are rebuilt
+     needs to be non-zero for migration distance check
+     even if pair = NULL and no neighbor lists are used
+   cutneigh = force cutoff + skin if cutforce > 0, else cutneigh = 0
+   cutneighghost = pair cutghost if it requests it, else same as cutneigh
+------------------------------------------------------------------------- */
+
+void Neighbor::init_cutneigh()
+{
+  int i,j;
+  double cutoff,delta,cut;
+
+  triggersq = 0.25*skin*skin;
+
+  int n = atom->ntypes;
+  cutneighmin = BIG;
+  cutneighmax = 0.0;
+
+  for (i = 1; i <= n; i++) {
+    cuttype[i] = cuttypesq[i] = 0.0;
+    for (j = 1; j <= n; j++) {
+      if (force->pair) cutoff = sqrt(force->pair->cutsq[i][j]);
+      else cutoff = 0.0;
+      if (cutoff > 0.0) delta = skin;
+      else delta = 0.0;
+      cut = cutoff + delta;
+
+      cutneighsq[i][j] = cut*cut;
+      cuttype[i] = MAX(cuttype[i],cut);
+      cuttypesq[i] = MAX(cuttypesq[i],cut*cut);
+      cutneighmin = MIN(cutneighmin,cut);
+      cutneighmax = MAX(cutneighmax,cut);
+
+      if (force->pair && force->pair->ghostneigh) {
+        cut = force->pair->cutghost[i][j] + skin;
+        cutneighghostsq[i][j] = cut*cut;
+      } else cutneighghostsq[i][j] = cut*cut;
+    }
+  }
+  cutneighmaxsq = cutneighmax * cutneighmax;
+
+  // rRESPA cutoffs
+
+  int respa = 0;
+  if (update->whichflag == 1 && strstr(update->integrate_style,"respa")) {
+    if (((Respa *) update->integrate)->level_inner >= 0) respa = 1;
+    if (((Respa *) update->integrate)->level_middle >= 0) respa = 2;
+  }
+
+  if (respa) {
+    double *cut_respa = ((Respa *) update->integrate)->cutoff;
+    cut_inner_sq = (cut_respa[1] + skin) * (cut_respa[1] + skin);
+    cut_middle_sq = (cut_respa[3] + skin) * (cut_respa[3] + skin);
+    cut_middle_inside_sq = (cut_respa[0] - skin) * (cut_respa[0] - skin);
+    if (cut_respa[0]-skin < 0) cut_middle_inside_sq = 0.0;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   change skin distance during a run, e.g. by fix tune/neigh
+   caller must also reset comm cutoffs and bins via comm->setup()
+     and setup_bins() before the next build
+------------------------------------------------------------------------- */
+
+void Neighbor::reset_skin(double newskin)
+{
+  skin = newskin;
+  init_cutneigh();
+}
+
 /* ---------------------------------------------------------------------- */
 
 int Neighbor::request(void *requestor)
@@ -1342,17 +1397,27 @@ int Neighbor::decide()
   if (ago >= delay && ago % every == 0) {
     if (build_once) return 0;
     if (dist_check == 0) return 1;
-    return check_distance();
-  } else return 0;
+    if (check_distance()) return 1;
+  }
+
+  if (validate && update->ntimestep % validate == 0 && !build_once)
+    return validate_start();
+  return 0;
 }
 
 /* ----------------------------------------------------------------------
-   if any atom moved trigger distance (half of neighbor skin) return 1
+   return 1 if any pair of atoms may have closed the neighbor skin
+     since the last build, i.e. the lists may be missing a pair
+   the distance of 2 atoms changes by at most the sum of their displacements,
+     so check the 2 largest displacements of any atoms against the skin
+   this is exact for the pair that moves most and less conservative than
+     checking each atom against 1/2 the skin, e.g. if few atoms move fast
+   if atomcheck is set, also return 1 if any atom moved more than 1/2 the
+     trigger distance, as before the pair bound was used
    shrink trigger distance if box size has changed
    conservative shrink procedure:
      compute distance each of 8 corners of box has moved since last reneighbor
      reduce skin distance by sum of 2 largest of the 8 values
-     new trigger = 1/2 of reduced skin distance
    for orthogonal box, only need 2 lo/hi corners
    for triclinic, need all 8 corners since deformations can displace all 8
 ------------------------------------------------------------------------- */
@@ -1360,7 +1425,7 @@ int Neighbor::decide()
 int Neighbor::check_distance()
 {
   double delx,dely,delz,rsq;
-  double delta,deltasq,delta1,delta2;
+  double delta,delta1,delta2,trigger;
 
   if (boxcheck) {
     if (triclinic == 0) {
@@ -1372,8 +1437,7 @@ int Neighbor::check_distance()
       dely = bboxhi[1] - boxhi_hold[1];
       delz = bboxhi[2] - boxhi_hold[2];
       delta2 = sqrt(delx*delx + dely*dely + delz*delz);
-      delta = 0.5 * (skin - (delta1+delta2));
-      deltasq = delta*delta;
+      trigger = skin - (delta1+delta2);
     } else {
       domain->box_corners();
       delta1 = delta2 = 0.0;
@@ -1385,30 +1449,138 @@ int Neighbor::check_distance()
         if (delta > delta1) delta1 = delta;
         else if (delta > delta2) delta2 = delta;
       }
-      delta = 0.5 * (skin - (delta1+delta2));
-      deltasq = delta*delta;
+      trigger = skin - (delta1+delta2);
     }
-  } else deltasq = triggersq;
+  } else trigger = skin;
 
   double **x = atom->x;
   int nlocal = atom->nlocal;
   if (includegroup) nlocal = atom->nfirst;
 
-  int flag = 0;
+  // top = squares of 2 largest displacements of my atoms
+
+  double top[2];
+  top[0] = top[1] = 0.0;
   for (int i = 0; i < nlocal; i++) {
     delx = x[i][0] - xhold[i][0];
     dely = x[i][1] - xhold[i][1];
     delz = x[i][2] - xhold[i][2];
     rsq = delx*delx + dely*dely + delz*delz;
-    if (rsq > deltasq) flag = 1;
+    if (rsq > top[1]) {
+      if (rsq > top[0]) {
+        top[1] = top[0];
+        top[0] = rsq;
+      } else top[1] = rsq;
+    }
   }
+  top[0] = sqrt(top[0]);
+  top[1] = sqrt(top[1]);
 
-  int flagall;
-  MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_MAX,world);
+  double topall[2];
+  MPI_Allreduce(top,topall,1,top2_type,top2_op,world);
+
+  int flagall = 0;
+  if (topall[0] + topall[1] > trigger) flagall = 1;
+  if (atomcheck && 2.0*topall[0] > trigger) flagall = 1;
   if (flagall && ago == MAX(every,delay)) ndanger++;
   return flagall;
 }
 
+/* ----------------------------------------------------------------------
+   start a validation build on a step the lists would not be rebuilt on
+   count pairs within force cutoff in the old lists at current coords,
+     after acquiring current ghost coords, since decide() precedes comm
+   validate_finish() counts them again in the new lists
+------------------------------------------------------------------------- */
+
+int Neighbor::validate_start()
+{
+  comm->forward_comm();
+  validate_before = count_pairs();
+  validate_pending = 1;
+  return 1;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Neighbor::validate_finish()
+{
+  validate_pending = 0;
+  nvalidate++;
+
+  bigint nafter = count_pairs();
+  if (nafter <= validate_before) return;
+
+  nmissed += nafter - validate_before;
+  if (me == 0) {
+    char str[128];
+    sprintf(str,"Neighbor lists missed " BIGINT_FORMAT
+            " pairs on step " BIGINT_FORMAT,
+            nafter-validate_before,update->ntimestep);
+    error->warning(FLERR,str);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   global # of pairs within force cutoff in the first perpetual pair list
+     that is built from scratch
+   weight pairs so each is counted once regardless of which procs own
+     its atoms: full list stores each pair twice, half list with newton off
+     stores pairs with a ghost atom on both procs
+------------------------------------------------------------------------- */
+
+bigint Neighbor::count_pairs()
+{
+  if (!force->pair) return 0;
+
+  int m;
+  for (m = 0; m < old_nrequest; m++) {
+    NeighRequest *rq = old_requests[m];
+    if (lists[m] == NULL || !rq->pair || rq->occasional) continue;
+    if (rq->skip || rq->copy || rq->half_from_full) continue;
+    break;
+  }
+  if (m == old_nrequest) return 0;
+
+  NeighList *list = lists[m];
+  int full = old_requests[m]->full;
+  int newton = newton_pair;
+  if (old_requests[m]->newton == 1) newton = 1;
+  else if (old_requests[m]->newton == 2) newton = 0;
+
+  double **x = atom->x;
+  int *type = atom->type;
+  int nlocal = atom->nlocal;
+  double **cutsq = force->pair->cutsq;
+
+  int i,j,ii,jj,jnum;
+  int *jlist;
+  double delx,dely,delz;
+
+  // count twice the # of pairs to keep the weights integer
+
+  bigint count = 0;
+  for (ii = 0; ii < list->inum; ii++) {
+    i = list->ilist[ii];
+    jlist = list->firstneigh[i];
+    jnum = list->numneigh[i];
+    for (jj = 0; jj < jnum; jj++) {
+      j = jlist[jj] & NEIGHMASK;
+      delx = x[i][0] - x[j][0];
+      dely = x[i][1] - x[j][1];
+      delz = x[i][2] - x[j][2];
+      if (delx*delx + dely*dely + delz*delz >= cutsq[type[i]][type[j]])
+        continue;
+      if (full || (!newton && j >= nlocal)) count += 1;
+      else count += 2;
+    }
+  }
+
+  bigint all;
+  MPI_Allreduce(&count,&all,1,MPI_LMP_BIGINT,MPI_SUM,world);
+  return all/2;
+}
+
 /* ----------------------------------------------------------------------
    build perpetuals neighbor lists
    called at setup and every few timesteps during run or minimization
@@ -1419,6 +1591,8 @@ void Neighbor::build(int topoflag)
 {
   int i;
 
+  timer->region_start(region_build);
+
   ago = 0;
   ncalls++;
   lastcall = update->ntimestep;
@@ -1489,13 +1663,23 @@ void Neighbor::build(int topoflag)
   // only for pairwise lists with buildflag set
   // blist is for standard neigh lists, otherwise is a Kokkos list
 
+  timer->region_start(region_list);
   for (i = 0; i < nblist; i++) {
     if (lists[blist[i]])
       (this->*pair_build[blist[i]])(lists[blist[i]]);
     else build_kokkos(i);
   }
+  timer->region_stop(region_list);
+
+  if (atom->molecular && topoflag) {
+    timer->region_start(region_topo);
+    build_topology();
+    timer->region_stop(region_topo);
+  }
 
-  if (atom->molecular && topoflag) build_topology();
+  timer->region_stop(region_build);
+
+  if (validate_pending) validate_finish();
 }
 
 /* ----------------------------------------------------------------------
@@ -1810,6 +1994,11 @@ void Neighbor::modify_params(int narg, char **arg)
       else if (strcmp(arg[iarg+1],"no") == 0) dist_check = 0;
       else error->all(FLERR,"Illegal neigh_modify command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"validate") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal neigh_modify command");
+      validate = force->inumeric(FLERR,arg[iarg+1]);
+      if (validate < 0) error->all(FLERR,"Illegal neigh_modify command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"once") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal neigh_modify command");
       if (strcmp(arg[iarg+1],"yes") == 0) build_once = 1;
@@ -1912,6 +2101,8 @@ void Neighbor::bin_atoms()
 {
   int i,ibin;
 
+  timer->region_start(region_bin);
+
   for (i = 0; i < mbins; i++) binhead[i] = -1;
 
   // bin in reverse order so linked list will be in forward order
@@ -1944,6 +2135,8 @@ void Neighbor::bin_atoms()
       binhead[ibin] = i;
     }
   }
+
+  timer->region_stop(region_bin);
 }
 
 /* ----------------------------------------------------------------------
@@ -2086,3 +2279,21 @@ int Neighbor::exclude_setting()
 {
   return exclude;
 }
+
+/* ----------------------------------------------------------------------
+   merge 2 largest values of one proc (in) with those of another (inout)
+   for each of len pairs, each pair is sorted, largest first
+------------------------------------------------------------------------- */
+
+static void top2_merge(void *in, void *inout, int *len, MPI_Datatype *dptr)
+{
+  double *a = (double *) in;
+  double *b = (double *) inout;
+
+  for (int m = 0; m < *len; m++, a += 2, b += 2) {
+    if (a[0] >= b[0]) {
+      b[1] = MAX(b[0],a[1]);
+      b[0] = a[0];
+    } else b[1] = MAX(b[1],a[0]);
+  }
+}
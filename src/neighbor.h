@@ -43,6 +43,11 @@ class Neighbor : protected Pointers {
 
   bigint ncalls;                   // # of times build has been called
   bigint ndanger;                  // # of dangerous builds
+  int validate;                    // rebuild to check lists every this
+                                   //   many steps, 0 = never
+  bigint nvalidate;                // # of validation builds
+  bigint nmissed;                  // # of pairs missed by lists before
+                                   //   validation builds
   bigint lastcall;                 // timestep of last neighbor::build() call
 
   int nrequest;                    // requests for pairwise neighbor lists
@@ -81,6 +86,7 @@ class Neighbor : protected Pointers {
   void build_one(class NeighList *list, int preflag=0);  // create a single neighbor list
   void set(int, char **);           // set neighbor style and skin distance
   void modify_params(int, char**);  // modify parameters that control builds
+  void reset_skin(double);          // change skin distance during a run
   bigint memory_usage();
   int exclude_setting();
 
@@ -101,18 +107,27 @@ class Neighbor : protected Pointers {
   double cutneighmaxsq;            // cutneighmax squared
   double *cuttypesq;               // cuttype squared
 
-  double triggersq;                // trigger = build when atom moves this dist
+  double triggersq;                // (1/2 skin)^2, per-atom trigger of
+                                   //   USER-CUDA neighbor builds
+  MPI_Datatype top2_type;          // 2 largest displacements of any atoms
+  MPI_Op top2_op;                  //   and their AllReduce op
+  int validate_pending;            // 1 if next build is a validation build
+  bigint validate_before;          // pairs in cutoff found by old lists
   int cluster_check;               // 1 if check bond/angle/etc satisfies minimg
 
   double **xhold;                      // atom coords at last neighbor build
   int maxhold;                         // size of xhold array
   int boxcheck;                        // 1 if need to store box size
+  int atomcheck;                       // 1 if no atom may move > 1/2 skin
   double boxlo_hold[3],boxhi_hold[3];  // box size at last neighbor build
   double corners_hold[8][3];           // box corners at last neighbor build
 
   int binatomflag;                 // bin atoms or not when build neigh list
                                    // turned off by build_one()
 
+  int region_build,region_bin;     // timer regions for profiling
+  int region_list,region_topo;
+
   int nbinx,nbiny,nbinz;           // # of global bins
   int *bins;                       // ptr to next atom in each bin
   int maxbin;                      // size of bins array
@@ -170,6 +185,10 @@ class Neighbor : protected Pointers {
 
   void bin_atoms();                     // bin all atoms
   double bin_distance(int, int, int);   // distance between binx
+  void init_cutneigh();                 // set cutoffs from force cut + skin
+  int validate_start();
+  void validate_finish();
+  bigint count_pairs();                 // pairs within force cutoff in lists
   int coord2bin(double *);              // mapping atom coord to a bin
   int coord2bin(double *, int &, int &, int&); // ditto
 
@@ -422,4 +441,12 @@ E: Neigh_modify exclude molecule requires atom attribute molecule
 
 Self-explanatory.
 
+W: Neighbor lists missed %ld pairs on step %ld
+
+A validation build requested by the neigh_modify validate option found
+pairs within the force cutoff that were not in the neighbor lists used
+up to this step.  Forces on those atoms were wrong.  Check the lists
+more often with the neigh_modify every and delay options, or increase
+the skin distance.
+
 */
@@ -23,6 +23,7 @@
 #include "neigh_request.h"
 #include "update.h"
 #include "comm.h"
+#include "timer.h"
 #include "memory.h"
 #include "error.h"
 
@@ -38,6 +39,7 @@ PairHybrid::PairHybrid(LAMMPS *lmp) : Pair(lmp)
   multiple = NULL;
 
   outerflag = 0;
+  region = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -51,6 +53,7 @@ PairHybrid::~PairHybrid()
   delete [] styles;
   delete [] keywords;
   delete [] multiple;
+  delete [] region;
 
   delete [] svector;
 
@@ -104,9 +107,11 @@ void PairHybrid::compute(int eflag, int vflag)
     // outerflag is set and sub-style has a compute_outer() method
 
     if (styles[m]->compute_flag == 0) continue;
+    timer->region_start(region[m]);
     if (outerflag && styles[m]->respa_enable) 
       styles[m]->compute_outer(eflag,vflag_substyle);
     else styles[m]->compute(eflag,vflag_substyle);
+    timer->region_stop(region[m]);
 
     if (eflag_global) {
       eng_vdwl += styles[m]->eng_vdwl;
@@ -425,6 +430,19 @@ void PairHybrid::init_style()
 
   for (istyle = 0; istyle < nstyles; istyle++) styles[istyle]->init_style();
 
+  // timer region for each sub-style, instances of same style are numbered
+
+  delete [] region;
+  region = new int[nstyles];
+  for (istyle = 0; istyle < nstyles; istyle++) {
+    char *name = new char[strlen(keywords[istyle])+16];
+    if (multiple[istyle])
+      sprintf(name,"%s %d",keywords[istyle],multiple[istyle]);
+    else strcpy(name,keywords[istyle]);
+    region[istyle] = timer->region_create(name);
+    delete [] name;
+  }
+
   // create skip lists for each pair neigh request
   // any kind of list can have its skip flag set at this stage
 
@@ -55,6 +55,7 @@ class PairHybrid : public Pair {
 
  protected:
   int outerflag;                // toggle compute() when invoked by outer()
+  int *region;                  // timer region of each sub-style
 
   int **nmap;                   // # of sub-styles itype,jtype points to
   int ***map;                   // list of sub-styles itype,jtype points to
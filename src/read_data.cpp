@@ -37,6 +37,7 @@
 #include "dihedral.h"
 #include "improper.h"
 #include "special.h"
+#include "irregular.h"
 #include "error.h"
 #include "memory.h"
 
@@ -113,6 +114,8 @@ void ReadData::command(int narg, char **arg)
 
   addflag = mergeflag = 0;
   offset[0] = offset[1] = offset[2] = 0.0;
+  parallelflag = 0;
+  datafile = arg[0];
   nfix = 0;
   fix_index = NULL;
   fix_header = NULL;
@@ -133,6 +136,13 @@ void ReadData::command(int narg, char **arg)
       offset[1] = force->numeric(FLERR,arg[iarg+2]);
       offset[2] = force->numeric(FLERR,arg[iarg+3]);
       iarg += 4;
+    } else if (strcmp(arg[iarg],"parallel") == 0) {
+      if (iarg+2 > narg)
+        error->all(FLERR,"Illegal read_data command");
+      if (strcmp(arg[iarg+1],"yes") == 0) parallelflag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) parallelflag = 0;
+      else error->all(FLERR,"Illegal read_data command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"fix") == 0) {
       if (iarg+4 > narg)
         error->all(FLERR,"Illegal read_data command");
@@ -172,6 +182,12 @@ void ReadData::command(int narg, char **arg)
   if (domain->dimension == 2 && domain->zperiodic == 0)
     error->all(FLERR,"Cannot run 2d simulation with nonperiodic Z dimension");
 
+  if (parallelflag) {
+    int n = strlen(arg[0]);
+    if (n > 3 && strcmp(&arg[0][n-3],".gz") == 0)
+      error->all(FLERR,"Cannot read_data parallel from a gzipped file");
+  }
+
   // perform 1-pass read if no molecular topoogy in file
   // perform 2-pass read if molecular topology,
   //   first pass calculates max topology/atom
@@ -790,12 +806,15 @@ void ReadData::atoms()
   bigint nread = 0;
   bigint natoms = atom->natoms;
 
-  while (nread < natoms) {
-    nchunk = MIN(natoms-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_atoms(nchunk,buffer);
-    nread += nchunk;
+  if (parallelflag) atoms_parallel();
+  else {
+    while (nread < natoms) {
+      nchunk = MIN(natoms-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_atoms(nchunk,buffer);
+      nread += nchunk;
+    }
   }
 
   // check that all atoms were assigned correctly
@@ -823,6 +842,135 @@ void ReadData::atoms()
   }
 }
 
+/* ----------------------------------------------------------------------
+   read Atoms section with every proc reading a portion of the file
+   proc 0 knows where the section starts, the rest of the file is split
+     into equal byte ranges, one per proc
+   a proc owns every line that starts inside its byte range
+   lines are counted per proc, a prefix sum gives the global line index
+     of each proc's first line, lines beyond natoms are not atoms
+   atoms are parsed without regard to sub-domain, then migrated to
+     their owning procs via irregular communication
+   on return, proc 0 file pointer is positioned after the Atoms section
+------------------------------------------------------------------------- */
+
+void ReadData::atoms_parallel()
+{
+  int nprocs = comm->nprocs;
+  bigint natoms = atom->natoms;
+
+  // all procs open the file, proc 0 bcasts where Atoms lines begin
+
+  bigint start,filesize;
+  if (me == 0) start = ftell(fp);
+  MPI_Bcast(&start,1,MPI_LMP_BIGINT,0,world);
+
+  FILE *fpmine = fopen(datafile,"r");
+  int flag = 0;
+  if (fpmine == NULL) flag = 1;
+  int flagall;
+  MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_SUM,world);
+  if (flagall) error->all(FLERR,"Cannot open data file for parallel read");
+
+  fseek(fpmine,0,SEEK_END);
+  filesize = ftell(fpmine);
+
+  bigint lo = start + (filesize-start) * me / nprocs;
+  bigint hi = start + (filesize-start) * (me+1) / nprocs;
+
+  // count line starts in [lo,hi)
+  // position q is a line start if q = start or byte q-1 is a newline
+  // so scan bytes [lo-1,hi-1), except proc 0 counts the first line directly
+
+  bigint nmine = 0;
+  bigint pos = lo;
+  if (me == 0 && lo < hi) {
+    nmine = 1;
+    pos = lo + 1;
+  }
+
+  int nbuf = CHUNK*MAXLINE;
+  fseek(fpmine,pos-1,SEEK_SET);
+  while (pos < hi) {
+    int n = MIN(hi-pos,nbuf);
+    n = fread(buffer,1,n,fpmine);
+    if (n <= 0) break;
+    for (int i = 0; i < n; i++)
+      if (buffer[i] == '\n') nmine++;
+    pos += n;
+  }
+
+  // global index of my first line
+  // proc holding line natoms knows where the Atoms section ends
+
+  bigint first;
+  MPI_Scan(&nmine,&first,1,MPI_LMP_BIGINT,MPI_SUM,world);
+  first -= nmine;
+
+  bigint nlines;
+  MPI_Allreduce(&nmine,&nlines,1,MPI_LMP_BIGINT,MPI_SUM,world);
+  if (nlines < natoms) error->all(FLERR,"Unexpected end of data file");
+
+  bigint nread = 0;
+  if (first < natoms) nread = MIN(nmine,natoms-first);
+
+  // position at my first line start
+  // skip partial line if byte lo-1 is not a newline
+
+  if (me == 0) fseek(fpmine,lo,SEEK_SET);
+  else if (nmine) {
+    fseek(fpmine,lo-1,SEEK_SET);
+    if (fgetc(fpmine) != '\n') {
+      char *eof;
+      do {
+        eof = fgets(line,MAXLINE,fpmine);
+      } while (eof && line[strlen(line)-1] != '\n');
+    }
+  }
+
+  // read and parse my lines in chunks
+  // keep all atoms, they are migrated below
+
+  bigint endpos = filesize;
+  int nchunk,m;
+
+  while (nread > 0) {
+    nchunk = MIN(nread,CHUNK);
+    m = 0;
+    for (int i = 0; i < nchunk; i++) {
+      if (!fgets(&buffer[m],MAXLINE,fpmine))
+        error->one(FLERR,"Unexpected end of data file");
+      m += strlen(&buffer[m]);
+    }
+    if (buffer[m-1] != '\n') strcpy(&buffer[m++],"\n");
+    atom->data_atoms(nchunk,buffer,1);
+    nread -= nchunk;
+  }
+
+  if (first <= natoms && first+nmine > natoms) endpos = ftell(fpmine);
+  fclose(fpmine);
+
+  bigint endall;
+  MPI_Allreduce(&endpos,&endall,1,MPI_LMP_BIGINT,MPI_MIN,world);
+  if (me == 0) fseek(fp,endall,SEEK_SET);
+
+  // migrate atoms to owning procs
+  // data_atoms() already remapped them into the periodic box
+  // migrate_atoms() clears and resets the map, so it must exist beforehand
+
+  if (nprocs > 1) {
+    if (atom->map_style) {
+      atom->map_init();
+      atom->map_set();
+    }
+    if (domain->triclinic) domain->x2lamda(atom->nlocal);
+    Irregular *irregular = new Irregular(lmp);
+    irregular->migrate_atoms(1);
+    delete irregular;
+    if (domain->triclinic) domain->lamda2x(atom->nlocal);
+  }
+}
+
 /* ----------------------------------------------------------------------
    read all velocities
    to find atoms, must build atom map if not a molecular system
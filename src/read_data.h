@@ -41,6 +41,8 @@ class ReadData : protected Pointers {
 
   int addflag,mergeflag;
   double offset[3];
+  int parallelflag;     // 1 if each proc reads its own part of Atoms section
+  char *datafile;
   int nfix;         
   int *fix_index;
   char **fix_header;
@@ -65,6 +67,7 @@ class ReadData : protected Pointers {
   int style_match(const char *, const char *);
 
   void atoms();
+  void atoms_parallel();
   void velocities();
 
   void bonds(int);
@@ -418,6 +421,17 @@ E: Too many lines in one body in data file - boost MAXBODY
 MAXBODY is a setting at the top of the src/read_data.cpp file.
 Set it larger and re-compile the code.
 
+E: Cannot read_data parallel from a gzipped file
+
+The parallel option requires each processor to seek to its own
+portion of the data file, which is not possible for a compressed
+file.  Uncompress the file first.
+
+E: Cannot open data file for parallel read
+
+One or more processors could not open the data file.  The file must
+be visible to all processors when the parallel option is used.
+
 E: Cannot open gzipped file
 
 LAMMPS was compiled without support for reading and writing gzipped
@@ -35,6 +35,10 @@
 
 using namespace LAMMPS_NS;
 
+// allocate space for static class variable
+
+ReadDump *ReadDump::rdptr;
+
 #define CHUNK 1024
 #define EPSILON 1.0e-6
 
@@ -244,6 +248,7 @@ bigint ReadDump::seek(bigint nrequest, int exact)
   }
 
   MPI_Bcast(&ntimestep,1,MPI_LMP_BIGINT,0,world);
+  MPI_Bcast(&currentfile,1,MPI_INT,0,world);
   return ntimestep;
 }
 
@@ -294,6 +299,7 @@ bigint ReadDump::next(bigint ncurrent, bigint nlast, int nevery, int nskip)
   }
 
   MPI_Bcast(&ntimestep,1,MPI_LMP_BIGINT,0,world);
+  MPI_Bcast(&currentfile,1,MPI_INT,0,world);
   return ntimestep;
 }
 
@@ -458,17 +464,21 @@ void ReadDump::atoms()
   memory->create(ucflag_all,CHUNK,"read_dump:ucflag");
 
   // read, broadcast, and process atoms from snapshot in chunks
+  // if reader supports it, each proc reads a slice of snapshot instead
 
   addproc = -1;
 
-  int nchunk;
-  bigint nread = 0;
-  while (nread < nsnapatoms) {
-    nchunk = MIN(nsnapatoms-nread,CHUNK);
-    if (me == 0) reader->read_atoms(nchunk,nfield,fields);
-    MPI_Bcast(&fields[0][0],nchunk*nfield,MPI_DOUBLE,0,world);
-    process_atoms(nchunk);
-    nread += nchunk;
+  if (reader->parallel) atoms_parallel();
+  else {
+    int nchunk;
+    bigint nread = 0;
+    while (nread < nsnapatoms) {
+      nchunk = MIN(nsnapatoms-nread,CHUNK);
+      if (me == 0) reader->read_atoms(nchunk,nfield,fields);
+      MPI_Bcast(&fields[0][0],nchunk*nfield,MPI_DOUBLE,0,world);
+      process_atoms(nchunk);
+      nread += nchunk;
+    }
   }
 
   // if addflag set, add tags to new atoms if possible
@@ -556,6 +566,78 @@ void ReadDump::atoms()
   atom->tag_check();
 }
 
+/* ----------------------------------------------------------------------
+   each proc reads a contiguous slice of snapshot atoms from the file
+   slices are passed around ring of procs, each proc processes all of them
+   last value of each atom counts procs that matched it to an owned atom
+   in add mode, each proc creates unmatched atoms of its own slice
+------------------------------------------------------------------------- */
+
+void ReadDump::atoms_parallel()
+{
+  int nper = nfield + 1;
+
+  bigint nslice = reader->setup_slice(files[currentfile]);
+  if (nslice*nper*sizeof(double) > MAXSMALLINT)
+    error->one(FLERR,"Too many atoms per processor for read_dump");
+
+  double *slice;
+  memory->create(slice,MAX(nslice,1)*nper,"read_dump:slice");
+  reader->read_slice(nfield,nper,slice);
+  for (int i = 0; i < nslice; i++) slice[i*nper + nfield] = 0.0;
+
+  rdptr = this;
+  comm->ring(nslice,nper*sizeof(double),slice,5,process_ring,slice);
+
+  if (addflag) {
+    int nlocal_previous = atom->nlocal;
+
+    for (int i = 0; i < nslice; i++) {
+      if (slice[i*nper + nfield] > 0.0) continue;
+      for (int m = 0; m < nfield; m++) fields[0][m] = slice[i*nper + m];
+      add_atom(0);
+    }
+
+    int nlocal = atom->nlocal;
+    for (int m = 0; m < modify->nfix; m++) {
+      Fix *fix = modify->fix[m];
+      if (fix->create_attribute)
+        for (int i = nlocal_previous; i < nlocal; i++)
+          fix->set_arrays(i);
+    }
+  }
+
+  memory->destroy(slice);
+}
+
+/* ----------------------------------------------------------------------
+   callback from comm->ring()
+   cbuf = N snapshot atoms, each with nfield values + match count
+------------------------------------------------------------------------- */
+
+void ReadDump::process_ring(int n, char *cbuf)
+{
+  ReadDump *rd = rdptr;
+  double *buf = (double *) cbuf;
+  int nfield = rd->nfield;
+  int nper = nfield + 1;
+  double **fields = rd->fields;
+
+  int i,m,nchunk;
+
+  while (n) {
+    nchunk = MIN(n,CHUNK);
+    for (i = 0; i < nchunk; i++)
+      for (m = 0; m < nfield; m++)
+        fields[i][m] = buf[i*nper + m];
+    rd->replace_atoms(nchunk);
+    for (i = 0; i < nchunk; i++)
+      buf[i*nper + nfield] += rd->ucflag[i];
+    buf += nchunk*nper;
+    n -= nchunk;
+  }
+}
+
 /* ----------------------------------------------------------------------
    process arg list for dump file fields and optional keywords
 ------------------------------------------------------------------------- */
@@ -724,7 +806,51 @@ int ReadDump::whichtype(char *str)
 
 void ReadDump::process_atoms(int n)
 {
-  int i,m,ifield,itype;
+  replace_atoms(n);
+
+  // create any atoms in chunk that no processor owned
+  // add atoms in round-robin sequence on processors
+  // cannot do it geometrically b/c dump coords may not be in simulation box
+
+  if (!addflag) return;
+
+  MPI_Allreduce(ucflag,ucflag_all,n,MPI_INT,MPI_SUM,world);
+
+  int nlocal_previous = atom->nlocal;
+
+  for (int i = 0; i < n; i++) {
+    if (ucflag_all[i]) continue;
+
+    // each processor adds every Pth atom
+
+    addproc++;
+    if (addproc == nprocs) addproc = 0;
+    if (addproc != me) continue;
+
+    add_atom(i);
+  }
+
+  // invoke set_arrays() for fixes that need initialization of new atoms
+  // same as in CreateAtoms
+
+  int nlocal = atom->nlocal;
+  for (int m = 0; m < modify->nfix; m++) {
+    Fix *fix = modify->fix[m];
+    if (fix->create_attribute)
+      for (int i = nlocal_previous; i < nlocal; i++)
+        fix->set_arrays(i);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   match each of N atoms in fields to owned atoms
+   set ucflag for each matched atom
+   if in replace mode, overwrite atom info with fields from dump file
+------------------------------------------------------------------------- */
+
+void ReadDump::replace_atoms(int n)
+{
+  int i,m,ifield;
   int xbox,ybox,zbox;
   tagint tag;
 
@@ -807,105 +933,83 @@ void ReadDump::process_atoms(int n)
         (((imageint) (zbox + IMGMAX) & IMGMASK) << IMG2BITS);
     }
   }
+}
 
-  // create any atoms in chunk that no processor owned
-  // add atoms in round-robin sequence on processors
-  // cannot do it geometrically b/c dump coords may not be in simulation box
-
-  if (!addflag) return;
-
-  MPI_Allreduce(ucflag,ucflag_all,n,MPI_INT,MPI_SUM,world);
+/* ----------------------------------------------------------------------
+   create a new owned atom from snapshot atom I in fields
+------------------------------------------------------------------------- */
 
-  int nlocal_previous = atom->nlocal;
+void ReadDump::add_atom(int i)
+{
+  int m,ifield,itype;
+  int xbox,ybox,zbox;
   double one[3];
 
-  for (i = 0; i < n; i++) {
-    if (ucflag_all[i]) continue;
+  // create type and coord fields from dump file
+  // coord = 0.0 unless corresponding dump file field was specified
 
-    // each processor adds every Pth atom
+  one[0] = one[1] = one[2] = 0.0;
+  for (ifield = 1; ifield < nfield; ifield++) {
+    switch (fieldtype[ifield]) {
+    case TYPE:
+      itype = static_cast<int> (fields[i][ifield]);
+      break;
+    case X:
+      one[0] = xfield(i,ifield);
+      break;
+    case Y:
+      one[1] = yfield(i,ifield);
+      break;
+    case Z:
+      one[2] = zfield(i,ifield);
+      break;
+    }
+  }
 
-    addproc++;
-    if (addproc == nprocs) addproc = 0;
-    if (addproc != me) continue;
+  // create the atom on this proc
 
-    // create type and coord fields from dump file
-    // coord = 0.0 unless corresponding dump file field was specified
-
-    one[0] = one[1] = one[2] = 0.0;
-    for (ifield = 1; ifield < nfield; ifield++) {
-      switch (fieldtype[ifield]) {
-      case TYPE:
-        itype = static_cast<int> (fields[i][ifield]);
-        break;
-      case X:
-        one[0] = xfield(i,ifield);
-        break;
-      case Y:
-        one[1] = yfield(i,ifield);
-        break;
-      case Z:
-        one[2] = zfield(i,ifield);
-        break;
-      }
-    }
+  m = atom->nlocal;
+  atom->avec->create_atom(itype,one);
+  nadd++;
 
-    // create the atom on proc that owns it
-    // reset v,image ptrs in case they are reallocated
-
-    m = atom->nlocal;
-    atom->avec->create_atom(itype,one);
-    nadd++;
-
-    v = atom->v;
-    q = atom->q;
-    image = atom->image;
-
-    // set atom attributes from other dump file fields
-
-    xbox = ybox = zbox = 0;
-
-    for (ifield = 1; ifield < nfield; ifield++) {
-      switch (fieldtype[ifield]) {
-      case VX:
-        v[m][0] = fields[i][ifield];
-        break;
-      case VY:
-        v[m][1] = fields[i][ifield];
-        break;
-      case VZ:
-        v[m][2] = fields[i][ifield];
-        break;
-      case Q:
-        q[m] = fields[i][ifield];
-        break;
-      case IX:
-        xbox = static_cast<int> (fields[i][ifield]);
-        break;
-      case IY:
-        ybox = static_cast<int> (fields[i][ifield]);
-        break;
-      case IZ:
-        zbox = static_cast<int> (fields[i][ifield]);
-        break;
-      }
+  double **v = atom->v;
+  double *q = atom->q;
+  imageint *image = atom->image;
 
-      // replace image flag in case changed by ix,iy,iz fields
+  // set atom attributes from other dump file fields
 
-      image[m] = ((imageint) (xbox + IMGMAX) & IMGMASK) | 
-        (((imageint) (ybox + IMGMAX) & IMGMASK) << IMGBITS) | 
-        (((imageint) (zbox + IMGMAX) & IMGMASK) << IMG2BITS);
+  xbox = ybox = zbox = 0;
+
+  for (ifield = 1; ifield < nfield; ifield++) {
+    switch (fieldtype[ifield]) {
+    case VX:
+      v[m][0] = fields[i][ifield];
+      break;
+    case VY:
+      v[m][1] = fields[i][ifield];
+      break;
+    case VZ:
+      v[m][2] = fields[i][ifield];
+      break;
+    case Q:
+      q[m] = fields[i][ifield];
+      break;
+    case IX:
+      xbox = static_cast<int> (fields[i][ifield]);
+      break;
+    case IY:
+      ybox = static_cast<int> (fields[i][ifield]);
+      break;
+    case IZ:
+      zbox = static_cast<int> (fields[i][ifield]);
+      break;
     }
-  }
 
-  // invoke set_arrays() for fixes that need initialization of new atoms
-  // same as in CreateAtoms
+    // replace image flag in case changed by ix,iy,iz fields
 
-  nlocal = atom->nlocal;
-  for (m = 0; m < modify->nfix; m++) {
-    Fix *fix = modify->fix[m];
-    if (fix->create_attribute)
-      for (i = nlocal_previous; i < nlocal; i++)
-        fix->set_arrays(i);
+    image[m] = ((imageint) (xbox + IMGMAX) & IMGMASK) | 
+      (((imageint) (ybox + IMGMAX) & IMGMASK) << IMGBITS) | 
+      (((imageint) (zbox + IMGMAX) & IMGMASK) << IMG2BITS);
   }
 }
 
@@ -84,8 +84,14 @@ private:
 
   int whichtype(char *);
   void process_atoms(int);
+  void replace_atoms(int);
+  void add_atom(int);
+  void atoms_parallel();
   void delete_atoms();
 
+  static ReadDump *rdptr;  // ptr to ReadDump class for callback
+  static void process_ring(int, char *);
+
   double xfield(int, int);
   double yfield(int, int);
   double zfield(int, int);
@@ -103,6 +109,10 @@ E: Read_dump command before simulation box is defined
 The read_dump command cannot be used before a read_data, read_restart,
 or create_box command.
 
+E: Too many atoms per processor for read_dump
+
+A processor's slice of the snapshot is too large to be communicated.
+
 E: Illegal ... command
 
 Self-explanatory.  Check the input script syntax and compare to the
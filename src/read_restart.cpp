@@ -36,6 +36,7 @@
 #include "special.h"
 #include "universe.h"
 #include "mpiio.h"
+#include "compress.h"
 #include "memory.h"
 #include "error.h"
 
@@ -61,13 +62,18 @@ enum{VERSION,SMALLINT,TAGINT,BIGINT,
      SPECIAL_LJ,SPECIAL_COUL,
      MASS,PAIR,BOND,ANGLE,DIHEDRAL,IMPROPER,
      MULTIPROC,MPIIO,PROCSPERFILE,PERPROC,
-     IMAGEINT};
+     IMAGEINT,COMPRESS};
 
 #define LB_FACTOR 1.1
 
 /* ---------------------------------------------------------------------- */
 
-ReadRestart::ReadRestart(LAMMPS *lmp) : Pointers(lmp) {}
+ReadRestart::ReadRestart(LAMMPS *lmp) : Pointers(lmp)
+{
+  zip = NULL;
+  maxzbuf = 0;
+  zbuf = NULL;
+}
 
 /* ---------------------------------------------------------------------- */
 
@@ -239,7 +245,8 @@ void ReadRestart::command(int narg, char **arg)
         memory->destroy(buf);
         memory->create(buf,maxbuf,"read_restart:buf");
       }
-      read_double_vec(n,buf);
+      if (zip) read_compressed_vec(n,buf);
+      else read_double_vec(n,buf);
 
       m = 0;
       while (m < n) {
@@ -303,7 +310,7 @@ void ReadRestart::command(int narg, char **arg)
           memory->destroy(buf);
           memory->create(buf,maxbuf,"read_restart:buf");
         }
-        fread(buf,sizeof(double),n,fp);
+        fread_double_vec(n,buf);
 
         m = 0;
         while (m < n) m += avec->unpack_restart(&buf[m]);
@@ -385,7 +392,7 @@ void ReadRestart::command(int narg, char **arg)
           memory->destroy(buf);
           memory->create(buf,maxbuf,"read_restart:buf");
         }
-        fread(buf,sizeof(double),n,fp);
+        fread_double_vec(n,buf);
 
         if (i % nclusterprocs) {
           iproc = me + (i % nclusterprocs);
@@ -420,6 +427,8 @@ void ReadRestart::command(int narg, char **arg)
 
   delete [] file;
   memory->destroy(buf);
+  memory->destroy(zbuf);
+  delete zip;
 
   // for multiproc or MPI-IO files:
   // perform irregular comm to migrate atoms to correct procs
@@ -1012,6 +1021,10 @@ void ReadRestart::file_layout()
         memory->destroy(nproc_chunk_sizes);
         memory->destroy(nproc_chunk_offsets);
       }
+
+    } else if (flag == COMPRESS) {
+      int codec = read_int();
+      zip = new Compress(lmp,codec);
     }
 
     flag = read_int();
@@ -1150,3 +1163,44 @@ void ReadRestart::read_double_vec(int n, double *vec)
   if (me == 0) fread(vec,sizeof(double),n,fp);
   MPI_Bcast(vec,n,MPI_DOUBLE,0,world);
 }
+
+/* ----------------------------------------------------------------------
+   read a compressed vector of N doubles from restart file and bcast it
+   compressed bytes are bcast, each proc decompresses them
+------------------------------------------------------------------------- */
+
+void ReadRestart::read_compressed_vec(int n, double *vec)
+{
+  int nbytes = read_int();
+  if (nbytes > maxzbuf) {
+    maxzbuf = nbytes;
+    memory->destroy(zbuf);
+    memory->create(zbuf,maxzbuf,"read_restart:zbuf");
+  }
+  if (me == 0) fread(zbuf,sizeof(char),nbytes,fp);
+  MPI_Bcast(zbuf,nbytes,MPI_CHAR,0,world);
+  zip->decompress(zbuf,nbytes,(char *) vec,n*sizeof(double));
+}
+
+/* ----------------------------------------------------------------------
+   read a vector of N doubles from this proc's restart file, no bcast
+   decompress it if restart file is compressed
+------------------------------------------------------------------------- */
+
+void ReadRestart::fread_double_vec(int n, double *vec)
+{
+  if (zip == NULL) {
+    fread(vec,sizeof(double),n,fp);
+    return;
+  }
+
+  int nbytes;
+  fread(&nbytes,sizeof(int),1,fp);
+  if (nbytes > maxzbuf) {
+    maxzbuf = nbytes;
+    memory->destroy(zbuf);
+    memory->create(zbuf,maxzbuf,"read_restart:zbuf");
+  }
+  fread(zbuf,sizeof(char),nbytes,fp);
+  zip->decompress(zbuf,nbytes,(char *) vec,n*sizeof(double));
+}
@@ -46,6 +46,10 @@ class ReadRestart : protected Pointers {
   bigint assignedChunkSize;
   MPI_Offset assignedChunkOffset,headerOffset;
 
+  class Compress *zip;         // decompression of per-proc chunks, if any
+  int maxzbuf;                 // size of zbuf
+  char *zbuf;                  // compressed per-proc chunk
+
   void file_search(char *, char *);
   void header(int);
   void type_arrays();
@@ -62,6 +66,8 @@ class ReadRestart : protected Pointers {
   char *read_string();
   void read_int_vec(int, int *);
   void read_double_vec(int, double *);
+  void read_compressed_vec(int, double *);
+  void fread_double_vec(int, double *);
 };
 
 }
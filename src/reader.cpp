@@ -23,6 +23,7 @@ using namespace LAMMPS_NS;
 Reader::Reader(LAMMPS *lmp) : Pointers(lmp)
 {
   fp = NULL;
+  parallel = 0;
 }
 
 /* ----------------------------------------------------------------------
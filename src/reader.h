@@ -36,6 +36,13 @@ class Reader : protected Pointers {
   virtual void open_file(const char *);
   virtual void close_file();
 
+  // optional interface for reading a snapshot in parallel
+  // setup_slice() is called by all procs after read_header() on proc 0
+
+  int parallel;            // 1 if all procs can read slices of a snapshot
+  virtual bigint setup_slice(const char *) {return 0;}
+  virtual void read_slice(int, int, double *) {}
+
  protected:
   FILE *fp;                // pointer to opened file or pipe
   int compressed;          // flag for dump file compression
@@ -0,0 +1,376 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "stdio.h"
+#include "string.h"
+#include "reader_binary.h"
+#include "memory.h"
+#include "error.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#endif
+
+using namespace LAMMPS_NS;
+
+#define MAXROW 1024         // max # of atoms read from file at once
+
+/* ---------------------------------------------------------------------- */
+
+ReaderBinary::ReaderBinary(LAMMPS *lmp) : ReaderNative(lmp)
+{
+  parallel = 1;
+
+  nlabels = 0;
+  labels = NULL;
+
+  nchunk = maxchunk = 0;
+  chunkoffset = NULL;
+  chunkcount = NULL;
+
+  fpslice = NULL;
+  slicefile = NULL;
+
+  maxrow = 0;
+  row = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+ReaderBinary::~ReaderBinary()
+{
+  for (int i = 0; i < nlabels; i++) delete [] labels[i];
+  delete [] labels;
+
+  memory->destroy(chunkoffset);
+  memory->destroy(chunkcount);
+  memory->destroy(row);
+
+  if (fpslice) fclose(fpslice);
+  delete [] slicefile;
+}
+
+/* ----------------------------------------------------------------------
+   binary dump files have no column labels
+   user specifies label of each per-atom column in file, e.g. id type xs ys zs
+------------------------------------------------------------------------- */
+
+void ReaderBinary::settings(int narg, char **arg)
+{
+  if (narg < 1) error->all(FLERR,"Illegal read_dump command");
+
+  nlabels = narg;
+  labels = new char*[nlabels];
+  for (int i = 0; i < nlabels; i++) {
+    int n = strlen(arg[i]) + 1;
+    labels[i] = new char[n];
+    strcpy(labels[i],arg[i]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   open binary file, compressed files are not supported
+------------------------------------------------------------------------- */
+
+void ReaderBinary::open_file(const char *file)
+{
+  if (fp != NULL) close_file();
+
+  compressed = 0;
+  fp = fopen(file,"rb");
+
+  if (fp == NULL) {
+    char str[128];
+    sprintf(str,"Cannot open file %s",file);
+    error->one(FLERR,str);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   read and return time stamp from dump file
+   if first read reaches end-of-file, return 1 so caller can open next file
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+int ReaderBinary::read_time(bigint &ntimestep)
+{
+  if (fread(&ntimestep,sizeof(bigint),1,fp) != 1) return 1;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   skip snapshot from timestamp onward
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+void ReaderBinary::skip()
+{
+  read_header_values();
+  read_chunk_table();
+}
+
+/* ----------------------------------------------------------------------
+   read remaining header info, see ReaderNative::read_header()
+   also scan per-proc chunks of per-atom data, leaving fp at next snapshot
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+bigint ReaderBinary::read_header(double box[3][3], int &triclinic_snap,
+                                 int fieldinfo, int nfield,
+                                 int *fieldtype, char **fieldlabel,
+                                 int scaleflag, int wrapflag, int &fieldflag,
+                                 int &xflag, int &yflag, int &zflag)
+{
+  read_header_values();
+
+  triclinic_snap = triclinic;
+  box[0][0] = bounds[0];
+  box[0][1] = bounds[1];
+  box[1][0] = bounds[2];
+  box[1][1] = bounds[3];
+  box[2][0] = bounds[4];
+  box[2][1] = bounds[5];
+  box[0][2] = bounds[6];
+  box[1][2] = bounds[7];
+  box[2][2] = bounds[8];
+
+  read_chunk_table();
+  nread = 0;
+
+  if (!fieldinfo) return natoms;
+
+  if (nlabels != size_one)
+    error->one(FLERR,"Binary dump file does not have the number of "
+               "columns specified");
+
+  nfieldread = nfield;
+  fieldflag = match_fields(nfield,fieldtype,fieldlabel,scaleflag,wrapflag,
+                           xflag,yflag,zflag,nlabels,labels);
+
+  return natoms;
+}
+
+/* ----------------------------------------------------------------------
+   read N atoms from snapshot in order
+   stores appropriate values in fields array
+   fp is left at start of next snapshot
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+void ReaderBinary::read_atoms(int n, int nfield, double **fields)
+{
+  int i,m,nrow;
+
+  while (n) {
+    nrow = MIN(n,MAXROW);
+    read_rows(fp,nread,nrow);
+    for (i = 0; i < nrow; i++)
+      for (m = 0; m < nfield; m++)
+        fields[i][m] = row[i*size_one + fieldindex[m]];
+    fields += nrow;
+    nread += nrow;
+    n -= nrow;
+  }
+
+  fseek(fp,frameend,SEEK_SET);
+}
+
+/* ----------------------------------------------------------------------
+   called by all procs after proc 0 has read the snapshot header
+   bcast chunk table and field mapping
+   assign each proc a contiguous slice of the snapshot atoms
+   open file on this proc if not already open
+   return # of atoms in my slice
+------------------------------------------------------------------------- */
+
+bigint ReaderBinary::setup_slice(const char *file)
+{
+  int me,nprocs;
+  MPI_Comm_rank(world,&me);
+  MPI_Comm_size(world,&nprocs);
+
+  MPI_Bcast(&natoms,1,MPI_LMP_BIGINT,0,world);
+  MPI_Bcast(&size_one,1,MPI_INT,0,world);
+  MPI_Bcast(&nchunk,1,MPI_INT,0,world);
+  MPI_Bcast(&frameend,1,MPI_LMP_BIGINT,0,world);
+  MPI_Bcast(&nfieldread,1,MPI_INT,0,world);
+
+  if (me) {
+    if (nchunk > maxchunk) {
+      maxchunk = nchunk;
+      memory->destroy(chunkoffset);
+      memory->destroy(chunkcount);
+      memory->create(chunkoffset,maxchunk,"read_dump:chunkoffset");
+      memory->create(chunkcount,maxchunk,"read_dump:chunkcount");
+    }
+    memory->destroy(fieldindex);
+    memory->create(fieldindex,nfieldread,"read_dump:fieldindex");
+  }
+
+  MPI_Bcast(chunkoffset,nchunk,MPI_LMP_BIGINT,0,world);
+  MPI_Bcast(chunkcount,nchunk,MPI_INT,0,world);
+  MPI_Bcast(fieldindex,nfieldread,MPI_INT,0,world);
+
+  slicelo = natoms*me/nprocs;
+  slicehi = natoms*(me+1)/nprocs;
+
+  if (slicefile == NULL || strcmp(file,slicefile) != 0) {
+    if (fpslice) fclose(fpslice);
+    delete [] slicefile;
+    int n = strlen(file) + 1;
+    slicefile = new char[n];
+    strcpy(slicefile,file);
+    fpslice = fopen(file,"rb");
+    if (fpslice == NULL) {
+      char str[128];
+      sprintf(str,"Cannot open file %s",file);
+      error->one(FLERR,str);
+    }
+  }
+
+  return slicehi - slicelo;
+}
+
+/* ----------------------------------------------------------------------
+   read my slice of snapshot atoms into buf
+   each atom is stored as nfield values with a stride of nper
+   then hint the OS to prefetch the same part of the next snapshot
+------------------------------------------------------------------------- */
+
+void ReaderBinary::read_slice(int nfield, int nper, double *buf)
+{
+  int i,m,nrow;
+
+  bigint n = slicehi - slicelo;
+  bigint iatom = slicelo;
+
+  while (n) {
+    nrow = MIN(n,MAXROW);
+    read_rows(fpslice,iatom,nrow);
+    for (i = 0; i < nrow; i++)
+      for (m = 0; m < nfield; m++)
+        buf[i*nper + m] = row[i*size_one + fieldindex[m]];
+    buf += nrow*nper;
+    iatom += nrow;
+    n -= nrow;
+  }
+
+  // assume next snapshot has same layout, offset from this one by its size
+
+  if (slicehi > slicelo) {
+    bigint nbytes = (slicehi-slicelo)*size_one*sizeof(double);
+    bigint framebytes = frameend - chunkoffset[0];
+    prefetch(chunkoffset[0] + framebytes +
+             slicelo*size_one*sizeof(double),nbytes);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   read remaining header values after timestep
+------------------------------------------------------------------------- */
+
+void ReaderBinary::read_header_values()
+{
+  int boundary[3][2];
+
+  int flag = 0;
+  if (fread(&natoms,sizeof(bigint),1,fp) != 1) flag = 1;
+  if (fread(&triclinic,sizeof(int),1,fp) != 1) flag = 1;
+  if (fread(&boundary[0][0],6*sizeof(int),1,fp) != 1) flag = 1;
+  if (fread(bounds,sizeof(double),6,fp) != 6) flag = 1;
+  bounds[6] = bounds[7] = bounds[8] = 0.0;
+  if (triclinic && fread(&bounds[6],sizeof(double),3,fp) != 3) flag = 1;
+  if (fread(&size_one,sizeof(int),1,fp) != 1) flag = 1;
+  if (fread(&nchunk,sizeof(int),1,fp) != 1) flag = 1;
+  if (flag) error->one(FLERR,"Unexpected end of dump file");
+}
+
+/* ----------------------------------------------------------------------
+   record file offset and atom count of each per-proc chunk of snapshot
+   skip over per-atom data, leaving fp at next snapshot
+------------------------------------------------------------------------- */
+
+void ReaderBinary::read_chunk_table()
+{
+  int n;
+
+  if (nchunk > maxchunk) {
+    maxchunk = nchunk;
+    memory->destroy(chunkoffset);
+    memory->destroy(chunkcount);
+    memory->create(chunkoffset,maxchunk,"read_dump:chunkoffset");
+    memory->create(chunkcount,maxchunk,"read_dump:chunkcount");
+  }
+
+  for (int i = 0; i < nchunk; i++) {
+    if (fread(&n,sizeof(int),1,fp) != 1)
+      error->one(FLERR,"Unexpected end of dump file");
+    chunkoffset[i] = ftell(fp);
+    chunkcount[i] = n/size_one;
+    fseek(fp,(long) n*sizeof(double),SEEK_CUR);
+  }
+
+  frameend = ftell(fp);
+}
+
+/* ----------------------------------------------------------------------
+   read N consecutive snapshot atoms starting at atom Ifirst into row
+   atoms may span several per-proc chunks
+------------------------------------------------------------------------- */
+
+void ReaderBinary::read_rows(FILE *fpread, bigint ifirst, int n)
+{
+  if (n*size_one > maxrow) {
+    maxrow = n*size_one;
+    memory->destroy(row);
+    memory->create(row,maxrow,"read_dump:row");
+  }
+
+  // find chunk containing ifirst
+
+  int ichunk = 0;
+  bigint chunklo = 0;
+  while (ichunk < nchunk && chunklo + chunkcount[ichunk] <= ifirst)
+    chunklo += chunkcount[ichunk++];
+
+  int m = 0;
+  int nthis;
+  bigint offset;
+
+  while (n) {
+    if (ichunk == nchunk) error->one(FLERR,"Unexpected end of dump file");
+    offset = chunkoffset[ichunk] + (ifirst-chunklo)*size_one*sizeof(double);
+    nthis = MIN(n,chunklo + chunkcount[ichunk] - ifirst);
+    fseek(fpread,(long) offset,SEEK_SET);
+    if (fread(&row[m],sizeof(double),nthis*size_one,fpread) !=
+        (size_t) nthis*size_one)
+      error->one(FLERR,"Unexpected end of dump file");
+    m += nthis*size_one;
+    ifirst += nthis;
+    n -= nthis;
+    chunklo += chunkcount[ichunk++];
+  }
+}
+
+/* ----------------------------------------------------------------------
+   ask OS to read Nbytes at offset into page cache in the background
+   so it is available when the next snapshot is read
+------------------------------------------------------------------------- */
+
+void ReaderBinary::prefetch(bigint offset, bigint nbytes)
+{
+#if defined(POSIX_FADV_WILLNEED)
+  posix_fadvise(fileno(fpslice),(off_t) offset,(off_t) nbytes,
+                POSIX_FADV_WILLNEED);
+#endif
+}
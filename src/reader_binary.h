@@ -0,0 +1,99 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef READER_CLASS
+
+ReaderStyle(binary,ReaderBinary)
+
+#else
+
+#ifndef LMP_READER_BINARY_H
+#define LMP_READER_BINARY_H
+
+#include "reader_native.h"
+
+namespace LAMMPS_NS {
+
+class ReaderBinary : public ReaderNative {
+ public:
+  ReaderBinary(class LAMMPS *);
+  ~ReaderBinary();
+
+  void settings(int, char **);
+  int read_time(bigint &);
+  void skip();
+  bigint read_header(double [3][3], int &, int, int, int *, char **,
+                     int, int, int &, int &, int &, int &);
+  void read_atoms(int, int, double **);
+  void open_file(const char *);
+
+  bigint setup_slice(const char *);
+  void read_slice(int, int, double *);
+
+ private:
+  int nlabels;             // # of per-atom columns specified by user
+  char **labels;           // column labels specified by user
+
+  bigint natoms;           // # of atoms in current snapshot
+  int triclinic;           // triclinic flag of current snapshot
+  double bounds[9];        // box bounds and tilt factors of snapshot
+  int size_one;            // # of per-atom values in snapshot
+  int nfieldread;          // # of fields being read
+
+  int nchunk,maxchunk;     // # of per-proc chunks in snapshot
+  bigint *chunkoffset;     // file offset of each chunk's per-atom data
+  int *chunkcount;         // # of atoms in each chunk
+  bigint frameend;         // file offset of end of snapshot
+  bigint nread;            // # of atoms read so far by read_atoms()
+
+  FILE *fpslice;           // file opened by each proc to read its slice
+  char *slicefile;         // name of that file
+  bigint slicelo,slicehi;  // range of snapshot atoms in my slice
+
+  int maxrow;
+  double *row;             // buffer for per-atom values read from file
+
+  void read_header_values();
+  void read_chunk_table();
+  void read_rows(FILE *, bigint, int);
+  void prefetch(bigint, bigint);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal read_dump command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running LAMMPS to see the offending line.
+
+E: Cannot open file %s
+
+The specified file cannot be opened.  Check that the path and name are
+correct.
+
+E: Unexpected end of dump file
+
+A read operation from the file failed.
+
+E: Binary dump file does not have the number of columns specified
+
+The number of column labels given to the binary reader must match
+the number of per-atom values stored in the dump file.
+
+*/
@@ -147,11 +147,65 @@ bigint ReaderNative::read_header(double box[3][3], int &triclinic,
     if (labels[m] == NULL) return 1;
   }
 
+  fieldflag = match_fields(nfield,fieldtype,fieldlabel,scaleflag,wrapflag,
+                           xflag,yflag,zflag,nwords,labels);
+
+  delete [] labels;
+
+  // create internal vector of word ptrs for future parsing of per-atom lines
+
+  words = new char*[nwords];
+
+  return natoms;
+}
+
+/* ----------------------------------------------------------------------
+   read N atom lines from dump file
+   stores appropriate values in fields array
+   return 0 if success, 1 if error
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+void ReaderNative::read_atoms(int n, int nfield, double **fields)
+{
+  int i,m;
+  char *eof;
+
+  for (i = 0; i < n; i++) {
+    eof = fgets(line,MAXLINE,fp);
+    if (eof == NULL) error->one(FLERR,"Unexpected end of dump file");
+
+    // tokenize the line
+
+    words[0] = strtok(line," \t\n\r\f");
+    for (m = 1; m < nwords; m++)
+      words[m] = strtok(NULL," \t\n\r\f");
+
+    // convert selected fields to floats
+
+    for (m = 0; m < nfield; m++)
+      fields[i][m] = atof(words[fieldindex[m]]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   match each of Nfield fields to one of Nlabels per-atom column labels
+   allocate and set fieldindex = which column each field maps to
+   set xyz flags, see read_header()
+   return -1 if any field was not found, else 0
+------------------------------------------------------------------------- */
+
+int ReaderNative::match_fields(int nfield, int *fieldtype, char **fieldlabel,
+                               int scaleflag, int wrapflag,
+                               int &xflag, int &yflag, int &zflag,
+                               int nlabels, char **labels)
+{
   // match each field with a column of per-atom data
   // if fieldlabel set, match with explicit column
   // else infer one or more column matches from fieldtype
   // xyz flag set by scaleflag + wrapflag (if fieldlabel set) or column label
 
+  memory->destroy(fieldindex);
   memory->create(fieldindex,nfield,"read_dump:fieldindex");
 
   int s_index,u_index,su_index;
@@ -161,25 +215,25 @@ bigint ReaderNative::read_header(double box[3][3], int &triclinic,
 
   for (int i = 0; i < nfield; i++) {
     if (fieldlabel[i]) {
-      fieldindex[i] = find_label(fieldlabel[i],nwords,labels);
+      fieldindex[i] = find_label(fieldlabel[i],nlabels,labels);
       if (fieldtype[i] == X) xflag = 2*scaleflag + wrapflag + 1;
       else if (fieldtype[i] == Y) yflag = 2*scaleflag + wrapflag + 1;
       else if (fieldtype[i] == Z) zflag = 2*scaleflag + wrapflag + 1;
     }
 
     else if (fieldtype[i] == ID)
-      fieldindex[i] = find_label("id",nwords,labels);
+      fieldindex[i] = find_label("id",nlabels,labels);
     else if (fieldtype[i] == TYPE)
-      fieldindex[i] = find_label("type",nwords,labels);
+      fieldindex[i] = find_label("type",nlabels,labels);
 
     else if (fieldtype[i] == X) {
-      fieldindex[i] = find_label("x",nwords,labels);
+      fieldindex[i] = find_label("x",nlabels,labels);
       xflag = NOSCALE_WRAP;
       if (fieldindex[i] < 0) {
-        fieldindex[i] = nwords;
-        s_index = find_label("xs",nwords,labels);
-        u_index = find_label("xu",nwords,labels);
-        su_index = find_label("xsu",nwords,labels);
+        fieldindex[i] = nlabels;
+        s_index = find_label("xs",nlabels,labels);
+        u_index = find_label("xu",nlabels,labels);
+        su_index = find_label("xsu",nlabels,labels);
         if (s_index >= 0 && s_index < fieldindex[i]) {
           fieldindex[i] = s_index;
           xflag = SCALE_WRAP;
@@ -193,16 +247,16 @@ bigint ReaderNative::read_header(double box[3][3], int &triclinic,
           xflag = SCALE_NOWRAP;
         }
       }
-      if (fieldindex[i] == nwords) fieldindex[i] = -1;
+      if (fieldindex[i] == nlabels) fieldindex[i] = -1;
 
     } else if (fieldtype[i] == Y) {
-      fieldindex[i] = find_label("y",nwords,labels);
+      fieldindex[i] = find_label("y",nlabels,labels);
       yflag = NOSCALE_WRAP;
       if (fieldindex[i] < 0) {
-        fieldindex[i] = nwords;
-        s_index = find_label("ys",nwords,labels);
-        u_index = find_label("yu",nwords,labels);
-        su_index = find_label("ysu",nwords,labels);
+        fieldindex[i] = nlabels;
+        s_index = find_label("ys",nlabels,labels);
+        u_index = find_label("yu",nlabels,labels);
+        su_index = find_label("ysu",nlabels,labels);
         if (s_index >= 0 && s_index < fieldindex[i]) {
           fieldindex[i] = s_index;
           yflag = SCALE_WRAP;
@@ -216,16 +270,16 @@ bigint ReaderNative::read_header(double box[3][3], int &triclinic,
           yflag = SCALE_NOWRAP;
         }
       }
-      if (fieldindex[i] == nwords) fieldindex[i] = -1;
+      if (fieldindex[i] == nlabels) fieldindex[i] = -1;
 
     } else if (fieldtype[i] == Z) {
-      fieldindex[i] = find_label("z",nwords,labels);
+      fieldindex[i] = find_label("z",nlabels,labels);
       zflag = NOSCALE_WRAP;
       if (fieldindex[i] < 0) {
-        fieldindex[i] = nwords;
-        s_index = find_label("zs",nwords,labels);
-        u_index = find_label("zu",nwords,labels);
-        su_index = find_label("zsu",nwords,labels);
+        fieldindex[i] = nlabels;
+        s_index = find_label("zs",nlabels,labels);
+        u_index = find_label("zu",nlabels,labels);
+        su_index = find_label("zsu",nlabels,labels);
         if (s_index >= 0 && s_index < fieldindex[i]) {
           fieldindex[i] = s_index;
           zflag = SCALE_WRAP;
@@ -239,68 +293,31 @@ bigint ReaderNative::read_header(double box[3][3], int &triclinic,
           zflag = SCALE_NOWRAP;
         }
       }
-      if (fieldindex[i] == nwords) fieldindex[i] = -1;
+      if (fieldindex[i] == nlabels) fieldindex[i] = -1;
 
     } else if (fieldtype[i] == VX)
-      fieldindex[i] = find_label("vx",nwords,labels);
+      fieldindex[i] = find_label("vx",nlabels,labels);
     else if (fieldtype[i] == VY)
-      fieldindex[i] = find_label("vy",nwords,labels);
+      fieldindex[i] = find_label("vy",nlabels,labels);
     else if (fieldtype[i] == VZ)
-      fieldindex[i] = find_label("vz",nwords,labels);
+      fieldindex[i] = find_label("vz",nlabels,labels);
 
     else if (fieldtype[i] == Q)
-      fieldindex[i] = find_label("q",nwords,labels);
+      fieldindex[i] = find_label("q",nlabels,labels);
 
     else if (fieldtype[i] == IX)
-      fieldindex[i] = find_label("ix",nwords,labels);
+      fieldindex[i] = find_label("ix",nlabels,labels);
     else if (fieldtype[i] == IY)
-      fieldindex[i] = find_label("iy",nwords,labels);
+      fieldindex[i] = find_label("iy",nlabels,labels);
     else if (fieldtype[i] == IZ)
-      fieldindex[i] = find_label("iz",nwords,labels);
+      fieldindex[i] = find_label("iz",nlabels,labels);
   }
 
-  delete [] labels;
-
-  // set fieldflag = -1 if any unfound fields
+  // return -1 if any unfound fields
 
-  fieldflag = 0;
   for (int i = 0; i < nfield; i++)
-    if (fieldindex[i] < 0) fieldflag = -1;
-
-  // create internal vector of word ptrs for future parsing of per-atom lines
-
-  words = new char*[nwords];
-
-  return natoms;
-}
-
-/* ----------------------------------------------------------------------
-   read N atom lines from dump file
-   stores appropriate values in fields array
-   return 0 if success, 1 if error
-   only called by proc 0
-------------------------------------------------------------------------- */
-
-void ReaderNative::read_atoms(int n, int nfield, double **fields)
-{
-  int i,m;
-  char *eof;
-
-  for (i = 0; i < n; i++) {
-    eof = fgets(line,MAXLINE,fp);
-    if (eof == NULL) error->one(FLERR,"Unexpected end of dump file");
-
-    // tokenize the line
-
-    words[0] = strtok(line," \t\n\r\f");
-    for (m = 1; m < nwords; m++)
-      words[m] = strtok(NULL," \t\n\r\f");
-
-    // convert selected fields to floats
-
-    for (m = 0; m < nfield; m++)
-      fields[i][m] = atof(words[fieldindex[m]]);
-  }
+    if (fieldindex[i] < 0) return -1;
+  return 0;
 }
 
 /* ----------------------------------------------------------------------
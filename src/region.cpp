@@ -130,6 +130,33 @@ int Region::match(double x, double y, double z)
   return !(inside(x,y,z) ^ interior);
 }
 
+/* ----------------------------------------------------------------------
+   match() for N points at once, flag[i] = 1 if x[i] is a match, else 0
+   a static region tests all points with one call to inside_many()
+   same caller requirements as match()
+------------------------------------------------------------------------- */
+
+void Region::match_many(double **x, int n, int *flag)
+{
+  if (dynamic) {
+    for (int i = 0; i < n; i++) flag[i] = match(x[i][0],x[i][1],x[i][2]);
+    return;
+  }
+
+  inside_many(x,n,flag);
+  for (int i = 0; i < n; i++) flag[i] = !(flag[i] ^ interior);
+}
+
+/* ----------------------------------------------------------------------
+   inside() for N points at once
+   regions can override this with a branch-free loop the compiler vectorizes
+------------------------------------------------------------------------- */
+
+void Region::inside_many(double **x, int n, int *flag)
+{
+  for (int i = 0; i < n; i++) flag[i] = inside(x[i][0],x[i][1],x[i][2]);
+}
+
 /* ----------------------------------------------------------------------
    generate list of contact points for interior or exterior regions
    if region has variable shape, invoke shape_update() once per timestep
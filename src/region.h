@@ -48,11 +48,21 @@ class Region : protected Pointers {
 
   void prematch();
   int match(double, double, double);
+  void match_many(double **, int, int *);
   int surface(double, double, double, double);
 
+  // 1 if x,y,z is outside bounding box
+  // only meaningful if bboxflag is set and region is static
+
+  inline int outside_extent(double x, double y, double z) {
+    return (x < extent_xlo || x > extent_xhi || y < extent_ylo ||
+            y > extent_yhi || z < extent_zlo || z > extent_zhi);
+  }
+
   // implemented by each region, not called by other classes
 
   virtual int inside(double, double, double) = 0;
+  virtual void inside_many(double **, int, int *);
   virtual int surface_interior(double *, double) = 0;
   virtual int surface_exterior(double *, double) = 0;
   virtual void shape_update() {}
@@ -118,6 +118,19 @@ int RegBlock::inside(double x, double y, double z)
   return 0;
 }
 
+/* ----------------------------------------------------------------------
+   inside() for N points, no branches so the loop can be vectorized
+------------------------------------------------------------------------- */
+
+void RegBlock::inside_many(double **x, int n, int *flag)
+{
+  for (int i = 0; i < n; i++) {
+    const double *xi = x[i];
+    flag[i] = (xi[0] >= xlo) & (xi[0] <= xhi) & (xi[1] >= ylo) &
+      (xi[1] <= yhi) & (xi[2] >= zlo) & (xi[2] <= zhi);
+  }
+}
+
 /* ----------------------------------------------------------------------
    contact if 0 <= x < cutoff from one or more inner surfaces of block
    can be one contact for each of 6 faces
@@ -17,6 +17,7 @@
 #include "domain.h"
 #include "error.h"
 #include "force.h"
+#include "memory.h"
 
 using namespace LAMMPS_NS;
 
@@ -48,6 +49,13 @@ RegIntersect::RegIntersect(LAMMPS *lmp, int narg, char **arg) :
     list[nregion++] = iregion;
   }
 
+  cull = new int[n];
+  setup_cull();
+
+  maxpoint = 0;
+  pending = index = hit = NULL;
+  xsub = NULL;
+
   // this region is variable shape if any of sub-regions are
 
   Region **regions = domain->regions;
@@ -100,7 +108,13 @@ RegIntersect::~RegIntersect()
   for (int ilist = 0; ilist < nregion; ilist++) delete [] idsub[ilist];
   delete [] idsub;
   delete [] list;
+  delete [] cull;
   delete [] contact;
+
+  memory->destroy(pending);
+  memory->destroy(index);
+  memory->destroy(hit);
+  memory->sfree(xsub);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -125,6 +139,8 @@ void RegIntersect::init()
   Region **regions = domain->regions;
   for (int ilist = 0; ilist < nregion; ilist++)
     regions[list[ilist]]->init();
+
+  setup_cull();
 }
 
 /* ----------------------------------------------------------------------
@@ -149,13 +165,88 @@ int RegIntersect::inside(double x, double y, double z)
 {
   int ilist;
   Region **regions = domain->regions;
-  for (ilist = 0; ilist < nregion; ilist++)
+  for (ilist = 0; ilist < nregion; ilist++) {
+    if (cull[ilist] && regions[list[ilist]]->outside_extent(x,y,z)) break;
     if (!regions[list[ilist]]->match(x,y,z)) break;
+  }
 
   if (ilist == nregion) return 1;
   return 0;
 }
 
+/* ----------------------------------------------------------------------
+   inside() for N points, one sub-region at a time
+   each sub-region only tests points matched by all previous ones,
+     points outside its bounding box are rejected without a test
+------------------------------------------------------------------------- */
+
+void RegIntersect::inside_many(double **x, int n, int *flag)
+{
+  int i,j,k,m;
+
+  grow_scratch(n);
+
+  int npending = n;
+  for (i = 0; i < n; i++) {
+    flag[i] = 1;
+    pending[i] = i;
+  }
+
+  Region **regions = domain->regions;
+  for (int ilist = 0; ilist < nregion && npending; ilist++) {
+    Region *region = regions[list[ilist]];
+
+    m = 0;
+    for (k = 0; k < npending; k++) {
+      i = pending[k];
+      if (cull[ilist] && region->outside_extent(x[i][0],x[i][1],x[i][2])) {
+        flag[i] = 0;
+        continue;
+      }
+      index[m] = i;
+      xsub[m++] = x[i];
+    }
+
+    region->match_many(xsub,m,hit);
+    for (j = 0; j < m; j++)
+      if (!hit[j]) flag[index[j]] = 0;
+
+    m = 0;
+    for (k = 0; k < npending; k++)
+      if (flag[pending[k]]) pending[m++] = pending[k];
+    npending = m;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   flag sub-regions whose bounding box can exclude points before match()
+   only if the bbox is in box coords, i.e. the sub-region is static
+------------------------------------------------------------------------- */
+
+void RegIntersect::setup_cull()
+{
+  Region **regions = domain->regions;
+  for (int ilist = 0; ilist < nregion; ilist++)
+    cull[ilist] = regions[list[ilist]]->bboxflag &&
+      !regions[list[ilist]]->dynamic_check();
+}
+
+/* ---------------------------------------------------------------------- */
+
+void RegIntersect::grow_scratch(int n)
+{
+  if (n <= maxpoint) return;
+  maxpoint = n;
+  memory->destroy(pending);
+  memory->destroy(index);
+  memory->destroy(hit);
+  memory->sfree(xsub);
+  memory->create(pending,maxpoint,"region:pending");
+  memory->create(index,maxpoint,"region:index");
+  memory->create(hit,maxpoint,"region:hit");
+  xsub = (double **) memory->smalloc(maxpoint*sizeof(double *),"region:xsub");
+}
+
 /* ----------------------------------------------------------------------
    compute contacts with interior of intersection of sub-regions
    (1) compute contacts in each sub-region
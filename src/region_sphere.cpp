@@ -104,6 +104,22 @@ int RegSphere::inside(double x, double y, double z)
   return 0;
 }
 
+/* ----------------------------------------------------------------------
+   inside() for N points, no branches so the loop can be vectorized
+------------------------------------------------------------------------- */
+
+void RegSphere::inside_many(double **x, int n, int *flag)
+{
+  double delx,dely,delz;
+
+  for (int i = 0; i < n; i++) {
+    delx = x[i][0] - xc;
+    dely = x[i][1] - yc;
+    delz = x[i][2] - zc;
+    flag[i] = (sqrt(delx*delx + dely*dely + delz*delz) <= radius);
+  }
+}
+
 /* ----------------------------------------------------------------------
    one contact if 0 <= x < cutoff from inner surface of sphere
    no contact if outside (possible if called from union/intersect)
@@ -30,6 +30,7 @@ class RegSphere : public Region {
   ~RegSphere();
   void init();
   int inside(double, double, double);
+  void inside_many(double **, int, int *);
   int surface_interior(double *, double);
   int surface_exterior(double *, double);
   void shape_update();
@@ -17,6 +17,7 @@
 #include "domain.h"
 #include "error.h"
 #include "force.h"
+#include "memory.h"
 
 using namespace LAMMPS_NS;
 
@@ -49,6 +50,13 @@ RegUnion::RegUnion(LAMMPS *lmp, int narg, char **arg) : Region(lmp, narg, arg)
     list[nregion++] = iregion;
   }
 
+  cull = new int[n];
+  setup_cull();
+
+  maxpoint = 0;
+  pending = index = hit = NULL;
+  xsub = NULL;
+
   // this region is variable shape if any of sub-regions are
 
   Region **regions = domain->regions;
@@ -92,7 +100,13 @@ RegUnion::~RegUnion()
   for (int ilist = 0; ilist < nregion; ilist++) delete [] idsub[ilist];
   delete [] idsub;
   delete [] list;
+  delete [] cull;
   delete [] contact;
+
+  memory->destroy(pending);
+  memory->destroy(index);
+  memory->destroy(hit);
+  memory->sfree(xsub);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -117,6 +131,8 @@ void RegUnion::init()
   Region **regions = domain->regions;
   for (int ilist = 0; ilist < nregion; ilist++)
     regions[list[ilist]]->init();
+
+  setup_cull();
 }
 
 /* ----------------------------------------------------------------------
@@ -141,13 +157,86 @@ int RegUnion::inside(double x, double y, double z)
 {
   int ilist;
   Region **regions = domain->regions;
-  for (ilist = 0; ilist < nregion; ilist++)
+  for (ilist = 0; ilist < nregion; ilist++) {
+    if (cull[ilist] && regions[list[ilist]]->outside_extent(x,y,z)) continue;
     if (regions[list[ilist]]->match(x,y,z)) break;
+  }
 
   if (ilist == nregion) return 0;
   return 1;
 }
 
+/* ----------------------------------------------------------------------
+   inside() for N points, one sub-region at a time
+   each sub-region only tests points not yet matched by a previous one
+     and inside its bounding box
+------------------------------------------------------------------------- */
+
+void RegUnion::inside_many(double **x, int n, int *flag)
+{
+  int i,j,k,m;
+
+  grow_scratch(n);
+
+  int npending = n;
+  for (i = 0; i < n; i++) {
+    flag[i] = 0;
+    pending[i] = i;
+  }
+
+  Region **regions = domain->regions;
+  for (int ilist = 0; ilist < nregion && npending; ilist++) {
+    Region *region = regions[list[ilist]];
+
+    m = 0;
+    for (k = 0; k < npending; k++) {
+      i = pending[k];
+      if (cull[ilist] && region->outside_extent(x[i][0],x[i][1],x[i][2]))
+        continue;
+      index[m] = i;
+      xsub[m++] = x[i];
+    }
+
+    region->match_many(xsub,m,hit);
+    for (j = 0; j < m; j++)
+      if (hit[j]) flag[index[j]] = 1;
+
+    m = 0;
+    for (k = 0; k < npending; k++)
+      if (!flag[pending[k]]) pending[m++] = pending[k];
+    npending = m;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   flag sub-regions whose bounding box can exclude points before match()
+   only if the bbox is in box coords, i.e. the sub-region is static
+------------------------------------------------------------------------- */
+
+void RegUnion::setup_cull()
+{
+  Region **regions = domain->regions;
+  for (int ilist = 0; ilist < nregion; ilist++)
+    cull[ilist] = regions[list[ilist]]->bboxflag &&
+      !regions[list[ilist]]->dynamic_check();
+}
+
+/* ---------------------------------------------------------------------- */
+
+void RegUnion::grow_scratch(int n)
+{
+  if (n <= maxpoint) return;
+  maxpoint = n;
+  memory->destroy(pending);
+  memory->destroy(index);
+  memory->destroy(hit);
+  memory->sfree(xsub);
+  memory->create(pending,maxpoint,"region:pending");
+  memory->create(index,maxpoint,"region:index");
+  memory->create(hit,maxpoint,"region:hit");
+  xsub = (double **) memory->smalloc(maxpoint*sizeof(double *),"region:xsub");
+}
+
 /* ----------------------------------------------------------------------
    compute contacts with interior of union of sub-regions
    (1) compute contacts in each sub-region
@@ -31,6 +31,7 @@ class RegUnion : public Region {
   void init();
   int dynamic_check();
   int inside(double, double, double);
+  void inside_many(double **, int, int *);
   int surface_interior(double *, double);
   int surface_exterior(double *, double);
   void shape_update();
@@ -39,6 +40,14 @@ class RegUnion : public Region {
   int nregion;
   int *list;
   char **idsub;
+  int *cull;              // 1 if sub-region bbox can exclude points
+
+  int maxpoint;           // scratch arrays for inside_many()
+  int *pending,*index,*hit;
+  double **xsub;
+
+  void setup_cull();
+  void grow_scratch(int);
 };
 
 }
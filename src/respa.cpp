@@ -251,6 +251,11 @@ void Respa::init()
   if (modify->nfix == 0 && comm->me == 0)
     error->warning(FLERR,"No fixes defined, atoms won't move");
 
+  // KSpace can only be assigned to the outer level
+
+  if (force->kspace && force->kspace->every > 1)
+    error->all(FLERR,"KSpace every > 1 requires run_style verlet");
+
   // create fix needed for storing atom-based respa level forces
   // will delete it at end of run
 
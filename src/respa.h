@@ -120,6 +120,11 @@ W: No fixes defined, atoms won't move
 If you are not using a fix like nve, nvt, npt then atom velocities and
 coordinates will not be updated during timestepping.
 
+E: KSpace every > 1 requires run_style verlet
+
+Run_style respa evaluates KSpace on its outer level, so the
+kspace_modify every setting cannot be used with it.
+
 E: Pair style does not support rRESPA inner/middle/outer
 
 You are attempting to use rRESPA options with a pair style that
@@ -68,6 +68,8 @@ enum{IGNORE,WARN,ERROR};           // same as several files
 enum{ONELINE,MULTILINE};
 enum{INT,FLOAT,BIGINT};
 enum{SCALAR,VECTOR,ARRAY};
+enum{SUM_ATOMS,SUM_VDWL,SUM_COUL,SUM_PAIR,SUM_BOND,SUM_ANGLE,SUM_DIHED,
+     SUM_IMP,SUM_MOL,SUM_FNORM};
 
 #define INVOKED_SCALAR 1
 #define INVOKED_VECTOR 2
@@ -92,6 +94,7 @@ Thermo::Thermo(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
   lineflag = ONELINE;
   lostflag = lostbond = ERROR;
   lostbefore = 0;
+  sumflag = 0;
   flushflag = 0;
 
   // set style and corresponding lineflag
@@ -299,6 +302,14 @@ void Thermo::compute(int flag)
   firststep = flag;
   bigint ntimestep = update->ntimestep;
 
+  // invoke Compute methods needed for thermo keywords
+  // computes whose global sums can be batched are done together first,
+  //   along with the per-proc sums needed by lost_check() and keywords
+
+  sum_local();
+  modify->reduce_computes(ncompute,computes,compute_invoked,nsum,sums);
+  sumflag = 1;
+
   // check for lost atoms
   // turn off normflag if natoms = 0 to avoid divide by 0
 
@@ -306,8 +317,6 @@ void Thermo::compute(int flag)
   if (natoms == 0) normflag = 0;
   else normflag = normvalue;
 
-  // invoke Compute methods needed for thermo keywords
-
   for (i = 0; i < ncompute; i++)
     if (compute_which[i] == SCALAR) {
       if (!(computes[i]->invoked_flag & INVOKED_SCALAR)) {
@@ -327,9 +336,10 @@ void Thermo::compute(int flag)
     }
 
   // if lineflag = MULTILINE, prepend step/cpu header line
+  // only proc 0 formats the line, all procs compute each value
 
   int loc = 0;
-  if (lineflag == MULTILINE) {
+  if (lineflag == MULTILINE && me == 0) {
     double cpu;
     if (flag) cpu = timer->elapsed(TIME_LOOP);
     else cpu = 0.0;
@@ -340,6 +350,7 @@ void Thermo::compute(int flag)
 
   for (ifield = 0; ifield < nfield; ifield++) {
     (this->*vfunc[ifield])();
+    if (me) continue;
     if (vtype[ifield] == FLOAT)
       loc += sprintf(&line[loc],format[ifield],dvalue);
     else if (vtype[ifield] == INT)
@@ -349,6 +360,8 @@ void Thermo::compute(int flag)
     }
   }
 
+  sumflag = 0;
+
   // print line to screen and logfile
 
   if (me == 0) {
@@ -360,6 +373,81 @@ void Thermo::compute(int flag)
   }
 }
 
+/* ----------------------------------------------------------------------
+   tally per-proc values that thermo keywords sum across procs
+   summed by compute() together with computes, so keywords need no
+     MPI_Allreduce() of their own while sumflag is set
+   each sum is stored separately, so results match unfused sums exactly
+------------------------------------------------------------------------- */
+
+void Thermo::sum_local()
+{
+  double one;
+
+  for (int which = 0; which < NSUM; which++) {
+    if (sumslot[which] < 0) continue;
+    one = 0.0;
+
+    switch (which) {
+    case SUM_ATOMS:
+      one = atom->nlocal;
+      break;
+    case SUM_VDWL:
+      if (force->pair) one = force->pair->eng_vdwl;
+      break;
+    case SUM_COUL:
+      if (force->pair) one = force->pair->eng_coul;
+      break;
+    case SUM_PAIR:
+      if (force->pair) one = force->pair->eng_vdwl + force->pair->eng_coul;
+      break;
+    case SUM_BOND:
+      if (force->bond) one = force->bond->energy;
+      break;
+    case SUM_ANGLE:
+      if (force->angle) one = force->angle->energy;
+      break;
+    case SUM_DIHED:
+      if (force->dihedral) one = force->dihedral->energy;
+      break;
+    case SUM_IMP:
+      if (force->improper) one = force->improper->energy;
+      break;
+    case SUM_MOL:
+      if (atom->molecular) {
+        if (force->bond) one += force->bond->energy;
+        if (force->angle) one += force->angle->energy;
+        if (force->dihedral) one += force->dihedral->energy;
+        if (force->improper) one += force->improper->energy;
+      }
+      break;
+    case SUM_FNORM: {
+      double **f = atom->f;
+      int nlocal = atom->nlocal;
+      for (int i = 0; i < nlocal; i++)
+        one += f[i][0]*f[i][0] + f[i][1]*f[i][1] + f[i][2]*f[i][2];
+      break;
+    }
+    }
+
+    sums[sumslot[which]] = one;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   return sum of per-proc value across procs
+   if within compute() and a keyword uses it, use the already
+     summed value which = SUM_*
+------------------------------------------------------------------------- */
+
+double Thermo::sum_all(int which, double one)
+{
+  if (sumflag && sumslot[which] >= 0) return sums[sumslot[which]];
+  double all;
+  MPI_Allreduce(&one,&all,1,MPI_DOUBLE,MPI_SUM,world);
+  return all;
+}
+
 /* ----------------------------------------------------------------------
    check for lost atoms, return current number of atoms
 ------------------------------------------------------------------------- */
@@ -367,10 +455,12 @@ void Thermo::compute(int flag)
 bigint Thermo::lost_check()
 {
   // ntotal = current # of atoms
+  // within compute(), it was summed as a double, which is exact
 
   bigint ntotal;
   bigint nblocal = atom->nlocal;
-  MPI_Allreduce(&nblocal,&ntotal,1,MPI_LMP_BIGINT,MPI_SUM,world);
+  if (sumflag) ntotal = static_cast<bigint> (sums[sumslot[SUM_ATOMS]]);
+  else MPI_Allreduce(&nblocal,&ntotal,1,MPI_LMP_BIGINT,MPI_SUM,world);
   if (ntotal < 0 || ntotal > MAXBIGINT)
     error->all(FLERR,"Too many total atoms");
   if (ntotal == atom->natoms) return ntotal;
@@ -591,6 +681,7 @@ void Thermo::allocate()
   ncompute = 0;
   id_compute = new char*[3*n];
   compute_which = new int[3*n];
+  compute_invoked = new int[3*n];
   computes = new Compute*[3*n];
 
   nfix = 0;
@@ -627,6 +718,7 @@ void Thermo::deallocate()
   for (int i = 0; i < ncompute; i++) delete [] id_compute[i];
   delete [] id_compute;
   delete [] compute_which;
+  delete [] compute_invoked;
   delete [] computes;
 
   for (int i = 0; i < nfix; i++) delete [] id_fix[i];
@@ -647,6 +739,13 @@ void Thermo::parse_fields(char *str)
 {
   nfield = 0;
 
+  // per-proc sums are only done for keywords that use them
+  // atom count is always needed by lost_check()
+
+  nsum = 0;
+  for (int i = 0; i < NSUM; i++) sumslot[i] = -1;
+  add_sum(SUM_ATOMS);
+
   // customize a new keyword by adding to if statement
 
   char *word = strtok(str," \0");
@@ -700,27 +799,35 @@ void Thermo::parse_fields(char *str)
     } else if (strcmp(word,"evdwl") == 0) {
       addfield("E_vdwl",&Thermo::compute_evdwl,FLOAT);
       index_pe = add_compute(id_pe,SCALAR);
+      add_sum(SUM_VDWL);
     } else if (strcmp(word,"ecoul") == 0) {
       addfield("E_coul",&Thermo::compute_ecoul,FLOAT);
       index_pe = add_compute(id_pe,SCALAR);
+      add_sum(SUM_COUL);
     } else if (strcmp(word,"epair") == 0) {
       addfield("E_pair",&Thermo::compute_epair,FLOAT);
       index_pe = add_compute(id_pe,SCALAR);
+      add_sum(SUM_PAIR);
     } else if (strcmp(word,"ebond") == 0) {
       addfield("E_bond",&Thermo::compute_ebond,FLOAT);
       index_pe = add_compute(id_pe,SCALAR);
+      add_sum(SUM_BOND);
     } else if (strcmp(word,"eangle") == 0) {
       addfield("E_angle",&Thermo::compute_eangle,FLOAT);
       index_pe = add_compute(id_pe,SCALAR);
+      add_sum(SUM_ANGLE);
     } else if (strcmp(word,"edihed") == 0) {
       addfield("E_dihed",&Thermo::compute_edihed,FLOAT);
       index_pe = add_compute(id_pe,SCALAR);
+      add_sum(SUM_DIHED);
     } else if (strcmp(word,"eimp") == 0) {
       addfield("E_impro",&Thermo::compute_eimp,FLOAT);
       index_pe = add_compute(id_pe,SCALAR);
+      add_sum(SUM_IMP);
     } else if (strcmp(word,"emol") == 0) {
       addfield("E_mol",&Thermo::compute_emol,FLOAT);
       index_pe = add_compute(id_pe,SCALAR);
+      add_sum(SUM_MOL);
     } else if (strcmp(word,"elong") == 0) {
       addfield("E_long",&Thermo::compute_elong,FLOAT);
       index_pe = add_compute(id_pe,SCALAR);
@@ -798,6 +905,7 @@ void Thermo::parse_fields(char *str)
       addfield("Fmax",&Thermo::compute_fmax,FLOAT);
     } else if (strcmp(word,"fnorm") == 0) {
       addfield("Fnorm",&Thermo::compute_fnorm,FLOAT);
+      add_sum(SUM_FNORM);
 
     } else if (strcmp(word,"nbuild") == 0) {
       addfield("Nbuild",&Thermo::compute_nbuild,BIGINT);
@@ -929,6 +1037,16 @@ void Thermo::addfield(const char *key, FnPtr func, int typeflag)
   nfield++;
 }
 
+/* ----------------------------------------------------------------------
+   add per-proc value which = SUM_* to values summed by compute()
+   if already added, do nothing
+------------------------------------------------------------------------- */
+
+void Thermo::add_sum(int which)
+{
+  if (sumslot[which] < 0) sumslot[which] = nsum++;
+}
+
 /* ----------------------------------------------------------------------
    add compute ID to list of Compute objects to call
    return location of where this Compute is in list
@@ -947,6 +1065,9 @@ int Thermo::add_compute(const char *id, int which)
   id_compute[ncompute] = new char[n];
   strcpy(id_compute[ncompute],id);
   compute_which[ncompute] = which;
+  if (which == SCALAR) compute_invoked[ncompute] = INVOKED_SCALAR;
+  else if (which == VECTOR) compute_invoked[ncompute] = INVOKED_VECTOR;
+  else compute_invoked[ncompute] = INVOKED_ARRAY;
   ncompute++;
   return ncompute-1;
 }
@@ -1641,7 +1762,7 @@ void Thermo::compute_evdwl()
 {
   double tmp = 0.0;
   if (force->pair) tmp += force->pair->eng_vdwl;
-  MPI_Allreduce(&tmp,&dvalue,1,MPI_DOUBLE,MPI_SUM,world);
+  dvalue = sum_all(SUM_VDWL,tmp);
 
   if (force->pair && force->pair->tail_flag) {
     double volume = domain->xprd * domain->yprd * domain->zprd;
@@ -1657,7 +1778,7 @@ void Thermo::compute_ecoul()
 {
   double tmp = 0.0;
   if (force->pair) tmp += force->pair->eng_coul;
-  MPI_Allreduce(&tmp,&dvalue,1,MPI_DOUBLE,MPI_SUM,world);
+  dvalue = sum_all(SUM_COUL,tmp);
   if (normflag) dvalue /= natoms;
 }
 
@@ -1667,7 +1788,7 @@ void Thermo::compute_epair()
 {
   double tmp = 0.0;
   if (force->pair) tmp += force->pair->eng_vdwl + force->pair->eng_coul;
-  MPI_Allreduce(&tmp,&dvalue,1,MPI_DOUBLE,MPI_SUM,world);
+  dvalue = sum_all(SUM_PAIR,tmp);
 
   if (force->kspace) dvalue += force->kspace->energy;
   if (force->pair && force->pair->tail_flag) {
@@ -1684,7 +1805,7 @@ void Thermo::compute_ebond()
 {
   if (force->bond) {
     double tmp = force->bond->energy;
-    MPI_Allreduce(&tmp,&dvalue,1,MPI_DOUBLE,MPI_SUM,world);
+    dvalue = sum_all(SUM_BOND,tmp);
     if (normflag) dvalue /= natoms;
   } else dvalue = 0.0;
 }
@@ -1695,7 +1816,7 @@ void Thermo::compute_eangle()
 {
   if (force->angle) {
     double tmp = force->angle->energy;
-    MPI_Allreduce(&tmp,&dvalue,1,MPI_DOUBLE,MPI_SUM,world);
+    dvalue = sum_all(SUM_ANGLE,tmp);
     if (normflag) dvalue /= natoms;
   } else dvalue = 0.0;
 }
@@ -1706,7 +1827,7 @@ void Thermo::compute_edihed()
 {
   if (force->dihedral) {
     double tmp = force->dihedral->energy;
-    MPI_Allreduce(&tmp,&dvalue,1,MPI_DOUBLE,MPI_SUM,world);
+    dvalue = sum_all(SUM_DIHED,tmp);
     if (normflag) dvalue /= natoms;
   } else dvalue = 0.0;
 }
@@ -1717,7 +1838,7 @@ void Thermo::compute_eimp()
 {
   if (force->improper) {
     double tmp = force->improper->energy;
-    MPI_Allreduce(&tmp,&dvalue,1,MPI_DOUBLE,MPI_SUM,world);
+    dvalue = sum_all(SUM_IMP,tmp);
     if (normflag) dvalue /= natoms;
   } else dvalue = 0.0;
 }
@@ -1732,7 +1853,7 @@ void Thermo::compute_emol()
     if (force->angle) tmp += force->angle->energy;
     if (force->dihedral) tmp += force->dihedral->energy;
     if (force->improper) tmp += force->improper->energy;
-    MPI_Allreduce(&tmp,&dvalue,1,MPI_DOUBLE,MPI_SUM,world);
+    dvalue = sum_all(SUM_MOL,tmp);
     if (normflag) dvalue /= natoms;
   } else dvalue = 0.0;
 }
@@ -1974,15 +2095,14 @@ void Thermo::compute_fmax()
 
 void Thermo::compute_fnorm()
 {
-  double **f = atom->f;
-  int nlocal = atom->nlocal;
-
   double dot = 0.0;
-  for (int i = 0; i < nlocal; i++)
-    dot += f[i][0]*f[i][0] + f[i][1]*f[i][1] + f[i][2]*f[i][2];
-  double dotall;
-  MPI_Allreduce(&dot,&dotall,1,MPI_DOUBLE,MPI_SUM,world);
-  dvalue = sqrt(dotall);
+  if (!sumflag || sumslot[SUM_FNORM] < 0) {
+    double **f = atom->f;
+    int nlocal = atom->nlocal;
+    for (int i = 0; i < nlocal; i++)
+      dot += f[i][0]*f[i][0] + f[i][1]*f[i][1] + f[i][2]*f[i][2];
+  }
+  dvalue = sqrt(sum_all(SUM_FNORM,dot));
 }
 
 /* ---------------------------------------------------------------------- */
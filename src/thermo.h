@@ -67,6 +67,12 @@ class Thermo : protected Pointers {
 
   bigint natoms;
 
+  enum{NSUM=10};         // # of per-proc values sum_local() can sum
+  int nsum;              // # of values used by lost_check() and keywords
+  int sumslot[NSUM];     // index of each value in sums, -1 if unused
+  double sums[NSUM];     // per-proc values, then their sums across procs
+  int sumflag;           // 1 if sums are valid, only within compute()
+
                          // data used by routines that compute single values
   int ivalue;            // integer value to print
   double dvalue;         // double value to print
@@ -87,6 +93,7 @@ class Thermo : protected Pointers {
   int ncompute;                // # of Compute objects called by thermo
   char **id_compute;           // their IDs
   int *compute_which;          // 0/1/2 if should call scalar,vector,array
+  int *compute_invoked;        // ditto as INVOKED_SCALAR/VECTOR/ARRAY flag
   class Compute **computes;    // list of ptrs to the Compute objects
 
   int nfix;                    // # of Fix objects called by thermo
@@ -102,6 +109,10 @@ class Thermo : protected Pointers {
   void allocate();
   void deallocate();
 
+  void sum_local();
+  double sum_all(int, double);
+  void add_sum(int);
+
   void parse_fields(char *);
   int add_compute(const char *, int);
   int add_fix(const char *);
@@ -12,16 +12,47 @@
 ------------------------------------------------------------------------- */
 
 #include "mpi.h"
+#include "string.h"
 #include "timer.h"
+#include "update.h"
 #include "memory.h"
+#include "error.h"
+
+#ifdef LAMMPS_PERF
+#include "unistd.h"
+#include "sys/ioctl.h"
+#include "sys/syscall.h"
+#include "linux/perf_event.h"
+#endif
 
 using namespace LAMMPS_NS;
 
+#define DELTA 16
+#define MAXPATH 1024
+#define MAXLINE 1536
+
 /* ---------------------------------------------------------------------- */
 
 Timer::Timer(LAMMPS *lmp) : Pointers(lmp)
 {
   memory->create(array,TIME_N,"array");
+
+  profile = 0;
+  nregion = maxregion = 0;
+  names = NULL;
+
+  // node 0 is the root of the region tree
+
+  nnode = maxnode = 0;
+  nodes = NULL;
+  add_node(-1,-1);
+  current = 0;
+
+  counters = 0;
+  for (int k = 0; k < TIMER_NCOUNTER; k++) perf_fd[k] = -1;
+  jsonflag = 0;
+  filename = NULL;
+  fp = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -29,6 +60,12 @@ Timer::Timer(LAMMPS *lmp) : Pointers(lmp)
 Timer::~Timer()
 {
   memory->destroy(array);
+  for (int i = 0; i < nregion; i++) delete [] names[i];
+  memory->sfree(names);
+  memory->sfree(nodes);
+  close_counters();
+  delete [] filename;
+  if (fp) fclose(fp);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -36,6 +73,15 @@ Timer::~Timer()
 void Timer::init()
 {
   for (int i = 0; i < TIME_N; i++) array[i] = 0.0;
+
+  // zero region accumulators, keep the tree so IDs and paths persist
+
+  for (int i = 0; i < nnode; i++) {
+    nodes[i].ncalls = 0;
+    nodes[i].time = 0.0;
+    for (int k = 0; k < TIMER_NCOUNTER; k++) nodes[i].count[k] = 0;
+  }
+  current = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -82,3 +128,376 @@ double Timer::elapsed(int which)
   double current_time = MPI_Wtime();
   return (current_time - array[which]);
 }
+
+/* ----------------------------------------------------------------------
+   timer command: profile yes/no, counters yes/no, file name
+------------------------------------------------------------------------- */
+
+void Timer::modify_params(int narg, char **arg)
+{
+  if (narg == 0) error->all(FLERR,"Illegal timer command");
+
+  int iarg = 0;
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"profile") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal timer command");
+      if (strcmp(arg[iarg+1],"yes") == 0) profile = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) profile = 0;
+      else error->all(FLERR,"Illegal timer command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"counters") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal timer command");
+      if (strcmp(arg[iarg+1],"yes") == 0) counters = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) counters = 0;
+      else error->all(FLERR,"Illegal timer command");
+#ifndef LAMMPS_PERF
+      if (counters)
+        error->all(FLERR,"Timer counters require LAMMPS built with "
+                   "-DLAMMPS_PERF");
+#endif
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"file") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal timer command");
+      delete [] filename;
+      int n = strlen(arg[iarg+1]) + 1;
+      filename = new char[n];
+      strcpy(filename,arg[iarg+1]);
+      if (fp) fclose(fp);
+      fp = NULL;
+      iarg += 2;
+    } else error->all(FLERR,"Illegal timer command");
+  }
+
+  if (filename == NULL) {
+    filename = new char[12];
+    strcpy(filename,"profile.csv");
+  }
+  int n = strlen(filename);
+  jsonflag = (n > 5 && strcmp(&filename[n-5],".json") == 0);
+
+  if (profile && counters) open_counters();
+  else close_counters();
+}
+
+/* ----------------------------------------------------------------------
+   return ID of region with name, create it if needed
+   a region's call path is set by the regions open when it starts
+------------------------------------------------------------------------- */
+
+int Timer::region_create(const char *name)
+{
+  for (int i = 0; i < nregion; i++)
+    if (strcmp(name,names[i]) == 0) return i;
+
+  if (nregion == maxregion) {
+    maxregion += DELTA;
+    names = (char **)
+      memory->srealloc(names,maxregion*sizeof(char *),"timer:names");
+  }
+  int n = strlen(name) + 1;
+  names[nregion] = new char[n];
+  strcpy(names[nregion],name);
+  return nregion++;
+}
+
+/* ----------------------------------------------------------------------
+   enter region id as a child of the current node
+------------------------------------------------------------------------- */
+
+void Timer::push(int id)
+{
+  int m = nodes[current].child;
+  while (m >= 0 && nodes[m].region != id) m = nodes[m].sibling;
+  if (m < 0) m = add_node(id,current);
+
+  current = m;
+  nodes[m].ncalls++;
+  if (perf_fd[0] >= 0) nodes[m].cvalid = read_counters(nodes[m].cstart);
+  nodes[m].tstart = MPI_Wtime();
+}
+
+/* ----------------------------------------------------------------------
+   leave region id, which must be the innermost open region
+------------------------------------------------------------------------- */
+
+void Timer::pop(int id)
+{
+  double tstop = MPI_Wtime();
+  Node *node = &nodes[current];
+  if (node->region != id) {
+    char str[128];
+    snprintf(str,128,"Timer region %s stopped while not innermost",names[id]);
+    error->one(FLERR,str);
+  }
+
+  node->time += tstop - node->tstart;
+
+  // counts of a call are skipped if either read failed
+
+  if (perf_fd[0] >= 0 && node->cvalid) {
+    bigint cstop[TIMER_NCOUNTER] = {0};
+    if (read_counters(cstop))
+      for (int k = 0; k < TIMER_NCOUNTER; k++)
+        node->count[k] += cstop[k] - node->cstart[k];
+  }
+  current = node->parent;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int Timer::add_node(int id, int parent)
+{
+  if (nnode == maxnode) {
+    maxnode += DELTA;
+    nodes = (Node *)
+      memory->srealloc(nodes,maxnode*sizeof(Node),"timer:nodes");
+  }
+
+  Node *node = &nodes[nnode];
+  node->region = id;
+  node->parent = parent;
+  node->child = node->sibling = -1;
+  node->ncalls = 0;
+  node->time = 0.0;
+  for (int k = 0; k < TIMER_NCOUNTER; k++) node->count[k] = 0;
+  node->cvalid = 0;
+
+  // append as last child so output follows order of first call
+
+  if (parent >= 0) {
+    int m = nodes[parent].child;
+    if (m < 0) nodes[parent].child = nnode;
+    else {
+      while (nodes[m].sibling >= 0) m = nodes[m].sibling;
+      nodes[m].sibling = nnode;
+    }
+  }
+  return nnode++;
+}
+
+/* ----------------------------------------------------------------------
+   read all counters of the group with a single system call
+   return 1 if successful, 0 if read failed and values are unchanged
+------------------------------------------------------------------------- */
+
+int Timer::read_counters(bigint *values)
+{
+#ifdef LAMMPS_PERF
+  uint64_t buf[TIMER_NCOUNTER+1];
+  if (read(perf_fd[0],buf,sizeof(buf)) != sizeof(buf)) return 0;
+  for (int k = 0; k < TIMER_NCOUNTER; k++) values[k] = buf[k+1];
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   open cycles, instructions and LLC misses of this process as one group
+   so they are scheduled together and read consistently
+------------------------------------------------------------------------- */
+
+void Timer::open_counters()
+{
+#ifdef LAMMPS_PERF
+  if (perf_fd[0] >= 0) return;
+
+  const uint64_t config[TIMER_NCOUNTER] =
+    {PERF_COUNT_HW_CPU_CYCLES,PERF_COUNT_HW_INSTRUCTIONS,
+     PERF_COUNT_HW_CACHE_MISSES};
+
+  int flag = 0;
+  for (int k = 0; k < TIMER_NCOUNTER; k++) {
+    struct perf_event_attr pe;
+    memset(&pe,0,sizeof(pe));
+    pe.type = PERF_TYPE_HARDWARE;
+    pe.size = sizeof(pe);
+    pe.config = config[k];
+    pe.disabled = (k == 0);
+    pe.exclude_kernel = 1;
+    pe.exclude_hv = 1;
+    pe.read_format = PERF_FORMAT_GROUP;
+    perf_fd[k] = syscall(__NR_perf_event_open,&pe,0,-1,perf_fd[0],0);
+    if (perf_fd[k] < 0) {
+      flag = 1;
+      break;
+    }
+  }
+
+  if (flag == 0) {
+    ioctl(perf_fd[0],PERF_EVENT_IOC_RESET,PERF_IOC_FLAG_GROUP);
+    ioctl(perf_fd[0],PERF_EVENT_IOC_ENABLE,PERF_IOC_FLAG_GROUP);
+  } else close_counters();
+
+  int me,flagall;
+  MPI_Comm_rank(world,&me);
+  MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_MAX,world);
+  if (flagall) {
+    close_counters();
+    if (me == 0)
+      error->warning(FLERR,"Cannot open hardware counters, "
+                     "profiling time only");
+  }
+#endif
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Timer::close_counters()
+{
+#ifdef LAMMPS_PERF
+  for (int k = TIMER_NCOUNTER-1; k >= 0; k--)
+    if (perf_fd[k] >= 0) close(perf_fd[k]);
+#endif
+  for (int k = 0; k < TIMER_NCOUNTER; k++) perf_fd[k] = -1;
+}
+
+/* ----------------------------------------------------------------------
+   write region profile of all procs at the end of a run
+   each proc formats its own tree, proc 0 gathers and writes
+   CSV = one row per proc and call path, header when file is opened
+   JSON = one object per run with a list of regions for each proc
+------------------------------------------------------------------------- */
+
+void Timer::profile_output()
+{
+  if (!profile) return;
+
+  int me,nprocs;
+  MPI_Comm_rank(world,&me);
+  MPI_Comm_size(world,&nprocs);
+
+  if (me == 0 && fp == NULL) {
+    fp = fopen(filename,"w");
+    if (fp == NULL) {
+      char str[128];
+      snprintf(str,128,"Cannot open timer profile file %s",filename);
+      error->one(FLERR,str);
+    }
+    if (!jsonflag)
+      fprintf(fp,"step,rank,region,depth,calls,time,self,"
+              "cycles,instructions,llc_misses,ipc\n");
+  }
+
+  // format my call paths, skip root and paths not visited during the run
+
+  int n = 0;
+  int maxbuf = MAXLINE;
+  char *buf = (char *) memory->smalloc(maxbuf,"timer:buf");
+  buf[0] = '\0';
+  char path[MAXPATH];
+  for (int m = nodes[0].child; m >= 0; m = nodes[m].sibling) {
+    path[0] = '\0';
+    write_node(m,path,0,buf,n,maxbuf);
+  }
+
+  // gather text of all procs on proc 0
+
+  int *recvcounts = NULL;
+  int *displs = NULL;
+  char *all = NULL;
+  if (me == 0) {
+    memory->create(recvcounts,nprocs,"timer:recvcounts");
+    memory->create(displs,nprocs,"timer:displs");
+  }
+  MPI_Gather(&n,1,MPI_INT,recvcounts,1,MPI_INT,0,world);
+  if (me == 0) {
+    bigint ntotal = 0;
+    for (int i = 0; i < nprocs; i++) {
+      displs[i] = ntotal;
+      ntotal += recvcounts[i];
+    }
+    all = (char *) memory->smalloc(ntotal+1,"timer:all");
+    all[ntotal] = '\0';
+  }
+  MPI_Gatherv(buf,n,MPI_CHAR,all,recvcounts,displs,MPI_CHAR,0,world);
+
+  if (me == 0) {
+    if (jsonflag) {
+      fprintf(fp,"{\"step\": " BIGINT_FORMAT ", \"nprocs\": %d, "
+              "\"counters\": %s, \"ranks\": [",
+              update->ntimestep,nprocs,perf_fd[0] >= 0 ? "true" : "false");
+      for (int i = 0; i < nprocs; i++) {
+        // drop trailing comma of last region of each proc
+
+        int len = recvcounts[i];
+        if (len && all[displs[i]+len-1] == ',') len--;
+        fprintf(fp,"%s[%.*s]",i ? ", " : "",len,&all[displs[i]]);
+      }
+      fprintf(fp,"]}\n");
+    } else {
+      char *ptr = all;
+      for (int i = 0; i < nprocs; i++) {
+        // each row was formatted without step and rank
+
+        char *end = ptr + recvcounts[i];
+        while (ptr < end) {
+          char *eol = strchr(ptr,'\n');
+          fprintf(fp,BIGINT_FORMAT ",%d,%.*s\n",update->ntimestep,i,
+                  (int) (eol-ptr),ptr);
+          ptr = eol+1;
+        }
+      }
+    }
+    fflush(fp);
+  }
+
+  memory->sfree(buf);
+  memory->destroy(recvcounts);
+  memory->destroy(displs);
+  memory->sfree(all);
+}
+
+/* ----------------------------------------------------------------------
+   append node m and its subtree to buf, path = parent path
+   self time excludes time spent in child regions
+------------------------------------------------------------------------- */
+
+void Timer::write_node(int m, char *path, int depth,
+                       char *&buf, int &n, int &maxbuf)
+{
+  Node *node = &nodes[m];
+  if (node->ncalls == 0) return;
+
+  int plen = strlen(path);
+  if (plen) snprintf(&path[plen],MAXPATH-plen,";%s",names[node->region]);
+  else snprintf(path,MAXPATH,"%s",names[node->region]);
+
+  double self = node->time;
+  for (int c = node->child; c >= 0; c = nodes[c].sibling)
+    self -= nodes[c].time;
+
+  if (n + MAXLINE + MAXPATH > maxbuf) {
+    maxbuf += MAXLINE + MAXPATH + maxbuf;
+    buf = (char *) memory->srealloc(buf,maxbuf,"timer:buf");
+  }
+
+  int cflag = (perf_fd[0] >= 0);
+  double ipc = 0.0;
+  if (cflag && node->count[0])
+    ipc = (double) node->count[1] / node->count[0];
+
+  if (jsonflag) {
+    n += sprintf(&buf[n],"{\"region\": \"%s\", \"depth\": %d, "
+                 "\"calls\": " BIGINT_FORMAT ", \"time\": %g, \"self\": %g",
+                 path,depth,node->ncalls,node->time,self);
+    if (cflag)
+      n += sprintf(&buf[n],", \"cycles\": " BIGINT_FORMAT
+                   ", \"instructions\": " BIGINT_FORMAT
+                   ", \"llc_misses\": " BIGINT_FORMAT ", \"ipc\": %g",
+                   node->count[0],node->count[1],node->count[2],ipc);
+    n += sprintf(&buf[n],"},");
+  } else {
+    n += sprintf(&buf[n],"%s,%d," BIGINT_FORMAT ",%g,%g",
+                 path,depth,node->ncalls,node->time,self);
+    if (cflag)
+      n += sprintf(&buf[n],"," BIGINT_FORMAT "," BIGINT_FORMAT ","
+                   BIGINT_FORMAT ",%g\n",
+                   node->count[0],node->count[1],node->count[2],ipc);
+    else n += sprintf(&buf[n],",,,,\n");
+  }
+
+  for (int c = node->child; c >= 0; c = nodes[c].sibling)
+    write_node(c,path,depth+1,buf,n,maxbuf);
+  path[plen] = '\0';
+}
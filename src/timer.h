@@ -14,16 +14,20 @@
 #ifndef LMP_TIMER_H
 #define LMP_TIMER_H
 
+#include "stdio.h"
 #include "pointers.h"
 
 enum{TIME_LOOP,TIME_PAIR,TIME_BOND,TIME_KSPACE,TIME_NEIGHBOR,
      TIME_COMM,TIME_OUTPUT,TIME_N};
 
+#define TIMER_NCOUNTER 3        // cycles, instructions, LLC misses
+
 namespace LAMMPS_NS {
 
 class Timer : protected Pointers {
  public:
   double *array;
+  int profile;                  // 1 if region profiling is enabled
 
   Timer(class LAMMPS *);
   ~Timer();
@@ -33,11 +37,82 @@ class Timer : protected Pointers {
   void barrier_start(int);
   void barrier_stop(int);
   double elapsed(int);
+  void modify_params(int, char **);
+
+  // named regions, nested regions are accumulated per call path
+  // start/stop cost only a flag test when profiling is off
+  // ID = -1 is ignored, for regions not yet created
+
+  int region_create(const char *);
+  void region_start(int id) {if (profile && id >= 0) push(id);}
+  void region_stop(int id) {if (profile && id >= 0) pop(id);}
+  void profile_output();
 
  private:
   double previous_time;
+
+  int nregion,maxregion;        // registered region names
+  char **names;
+
+  struct Node {                 // one call path in the region tree
+    int region;                 // region ID, -1 for root
+    int parent;                 // parent node
+    int child,sibling;          // first child and next sibling, -1 if none
+    bigint ncalls;
+    double time,tstart;
+    bigint count[TIMER_NCOUNTER],cstart[TIMER_NCOUNTER];
+    int cvalid;                 // 1 if cstart was read successfully
+  };
+
+  int nnode,maxnode;
+  Node *nodes;
+  int current;                  // node of innermost open region
+
+  int counters;                 // 1 if hardware counters requested
+  int perf_fd[TIMER_NCOUNTER];  // perf_event counters, [0] = group leader
+                                // -1 if not open
+  int jsonflag;                 // 1 for JSON output, 0 for CSV
+  char *filename;
+  FILE *fp;
+
+  void push(int);
+  void pop(int);
+  int add_node(int, int);
+  int read_counters(bigint *);
+  void open_counters();
+  void close_counters();
+  void write_node(int, char *, int, char *&, int &, int &);
 };
 
 }
 
 #endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal ... command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running LAMMPS to see the offending line.
+
+E: Timer counters require LAMMPS built with -DLAMMPS_PERF
+
+Hardware counters are read via the Linux perf_event interface, which
+is only compiled in with this switch.
+
+W: Cannot open hardware counters, profiling time only
+
+The perf_event_open() call failed, e.g. because the kernel setting
+perf_event_paranoid does not allow user processes to read counters.
+
+E: Cannot open timer profile file %s
+
+The specified file cannot be opened.  Check that the path and name are
+correct.
+
+E: Timer region %s stopped while not innermost
+
+Start and stop calls of timer regions must be properly nested.
+
+*/
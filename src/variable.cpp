@@ -45,6 +45,7 @@ using namespace MathConst;
 #define MAXLINE 256
 #define CHUNK 1024
 #define VALUELENGTH 64
+#define VBLOCK 256         // # of atoms evaluated together for atom-style vars
 
 #define MYROUND(a) (( a-floor(a) ) >= .5) ? ceil(a) : floor(a)
 
@@ -94,6 +95,9 @@ Variable::Variable(LAMMPS *lmp) : Pointers(lmp)
   randomequal = NULL;
   randomatom = NULL;
 
+  vblock = NULL;
+  maxvblock = 0;
+
   // customize by assigning a precedence level
 
   precedence[DONE] = 0;
@@ -130,6 +134,8 @@ Variable::~Variable()
 
   delete randomequal;
   delete randomatom;
+
+  memory->destroy(vblock);
 }
 
 /* ----------------------------------------------------------------------
@@ -701,7 +707,11 @@ void Variable::compute_atom(int ivar, int igroup,
   int *mask = atom->mask;
   int nlocal = atom->nlocal;
 
-  if (style[ivar] == ATOM) {
+  // random() and normal() must draw numbers in per-atom order,
+  //   so trees that use them are evaluated one atom at a time
+  // all other trees are evaluated one node at a time over blocks of atoms
+
+  if (style[ivar] == ATOM && tree_random(tree)) {
     if (sumflag == 0) {
       int m = 0;
       for (int i = 0; i < nlocal; i++) {
@@ -718,6 +728,35 @@ void Variable::compute_atom(int ivar, int igroup,
       }
     }
 
+  } else if (style[ivar] == ATOM) {
+    int nwork = (2*tree_depth(tree)+1) * VBLOCK;
+    if (nwork > maxvblock) {
+      memory->destroy(vblock);
+      maxvblock = nwork;
+      memory->create(vblock,maxvblock,"variable:vblock");
+    }
+    double *out = vblock;
+    double *work = &vblock[VBLOCK];
+
+    int i,j,n;
+    int m = 0;
+    for (int ifirst = 0; ifirst < nlocal; ifirst += VBLOCK) {
+      n = MIN(VBLOCK,nlocal-ifirst);
+      eval_tree_block(tree,ifirst,n,groupbit,out,work);
+      if (sumflag == 0) {
+        for (j = 0, i = ifirst; j < n; j++, i++) {
+          if (mask[i] & groupbit) result[m] = out[j];
+          else result[m] = 0.0;
+          m += stride;
+        }
+      } else {
+        for (j = 0, i = ifirst; j < n; j++, i++) {
+          if (mask[i] & groupbit) result[m] += out[j];
+          m += stride;
+        }
+      }
+    }
+
   } else {
     if (sumflag == 0) {
       int m = 0;
@@ -2456,6 +2495,256 @@ double Variable::eval_tree(Tree *tree, int i)
   return 0.0;
 }
 
+/* ----------------------------------------------------------------------
+   evaluate an atom-style variable parse tree for N atoms starting at ifirst
+   same result as calling eval_tree() for each atom, but tree is walked
+     once per block, with a simple loop over atoms at each node
+   out = N results, work = scratch space of 2*VBLOCK per tree level below
+   errors are only triggered by atoms in groupbit, like eval_tree() would be
+   trees with random() or normal() are not evaluated here, see tree_random()
+---------------------------------------------------------------------- */
+
+void Variable::eval_tree_block(Tree *tree, int ifirst, int n, int groupbit,
+                               double *out, double *work)
+{
+  int i,j;
+  int *mask = atom->mask;
+  double *work2 = &work[VBLOCK];
+  double *scratch = &work[2*VBLOCK];
+
+  int type = tree->type;
+
+  if (type == VALUE) {
+    double value = tree->value;
+    for (j = 0; j < n; j++) out[j] = value;
+    return;
+  }
+  if (type == ATOMARRAY) {
+    int nstride = tree->nstride;
+    double *array = &tree->array[ifirst*nstride];
+    for (j = 0; j < n; j++) out[j] = array[j*nstride];
+    return;
+  }
+  if (type == TYPEARRAY) {
+    double *array = tree->array;
+    int *itype = &atom->type[ifirst];
+    for (j = 0; j < n; j++) out[j] = array[itype[j]];
+    return;
+  }
+  if (type == INTARRAY) {
+    int nstride = tree->nstride;
+    int *iarray = &tree->iarray[ifirst*nstride];
+    for (j = 0; j < n; j++) out[j] = (double) iarray[j*nstride];
+    return;
+  }
+  if (type == BIGINTARRAY) {
+    int nstride = tree->nstride;
+    bigint *barray = &tree->barray[ifirst*nstride];
+    for (j = 0; j < n; j++) out[j] = (double) barray[j*nstride];
+    return;
+  }
+
+  if (type == GMASK) {
+    int bit = tree->ivalue1;
+    for (j = 0, i = ifirst; j < n; j++, i++)
+      out[j] = (mask[i] & bit) ? 1.0 : 0.0;
+    return;
+  }
+  if (type == RMASK || type == GRMASK) {
+    double **x = atom->x;
+    int bit,iregion;
+    if (type == RMASK) {
+      bit = ~0;
+      iregion = tree->ivalue1;
+    } else {
+      bit = tree->ivalue1;
+      iregion = tree->ivalue2;
+    }
+    Region *region = domain->regions[iregion];
+    for (j = 0, i = ifirst; j < n; j++, i++) {
+      if ((mask[i] & bit) && region->match(x[i][0],x[i][1],x[i][2]))
+        out[j] = 1.0;
+      else out[j] = 0.0;
+    }
+    return;
+  }
+
+  // functions of the timestep with possibly per-atom args are rare,
+  //   evaluate them one atom at a time
+
+  if (type == RAMP || type == STAGGER || type == LOGFREQ || type == STRIDE ||
+      type == VDISPLACE || type == SWIGGLE || type == CWIGGLE) {
+    for (j = 0, i = ifirst; j < n; j++, i++) {
+      if (mask[i] & groupbit) out[j] = eval_tree(tree,i);
+      else out[j] = 0.0;
+    }
+    return;
+  }
+
+  // operators and math functions
+  // left arg in out, right arg in work, middle arg in work2
+
+  if (tree->left) eval_tree_block(tree->left,ifirst,n,groupbit,out,scratch);
+  if (tree->right) eval_tree_block(tree->right,ifirst,n,groupbit,work,scratch);
+  if (tree->middle) 
+    eval_tree_block(tree->middle,ifirst,n,groupbit,work2,scratch);
+
+  switch (type) {
+  case ADD:
+    for (j = 0; j < n; j++) out[j] += work[j];
+    break;
+  case SUBTRACT:
+    for (j = 0; j < n; j++) out[j] -= work[j];
+    break;
+  case MULTIPLY:
+    for (j = 0; j < n; j++) out[j] *= work[j];
+    break;
+  case DIVIDE:
+    for (j = 0, i = ifirst; j < n; j++, i++)
+      if (work[j] == 0.0 && (mask[i] & groupbit))
+        error->one(FLERR,"Divide by 0 in variable formula");
+    for (j = 0; j < n; j++) out[j] /= work[j];
+    break;
+  case MODULO:
+    for (j = 0, i = ifirst; j < n; j++, i++)
+      if (work[j] == 0.0 && (mask[i] & groupbit))
+        error->one(FLERR,"Modulo 0 in variable formula");
+    for (j = 0; j < n; j++) out[j] = fmod(out[j],work[j]);
+    break;
+  case CARAT:
+    for (j = 0, i = ifirst; j < n; j++, i++)
+      if (work[j] == 0.0 && (mask[i] & groupbit))
+        error->one(FLERR,"Power by 0 in variable formula");
+    for (j = 0; j < n; j++) out[j] = pow(out[j],work[j]);
+    break;
+  case UNARY:
+    for (j = 0; j < n; j++) out[j] = -out[j];
+    break;
+
+  case NOT:
+    for (j = 0; j < n; j++) out[j] = (out[j] == 0.0) ? 1.0 : 0.0;
+    break;
+  case EQ:
+    for (j = 0; j < n; j++) out[j] = (out[j] == work[j]) ? 1.0 : 0.0;
+    break;
+  case NE:
+    for (j = 0; j < n; j++) out[j] = (out[j] != work[j]) ? 1.0 : 0.0;
+    break;
+  case LT:
+    for (j = 0; j < n; j++) out[j] = (out[j] < work[j]) ? 1.0 : 0.0;
+    break;
+  case LE:
+    for (j = 0; j < n; j++) out[j] = (out[j] <= work[j]) ? 1.0 : 0.0;
+    break;
+  case GT:
+    for (j = 0; j < n; j++) out[j] = (out[j] > work[j]) ? 1.0 : 0.0;
+    break;
+  case GE:
+    for (j = 0; j < n; j++) out[j] = (out[j] >= work[j]) ? 1.0 : 0.0;
+    break;
+  case AND:
+    for (j = 0; j < n; j++)
+      out[j] = (out[j] != 0.0 && work[j] != 0.0) ? 1.0 : 0.0;
+    break;
+  case OR:
+    for (j = 0; j < n; j++)
+      out[j] = (out[j] != 0.0 || work[j] != 0.0) ? 1.0 : 0.0;
+    break;
+
+  case SQRT:
+    for (j = 0, i = ifirst; j < n; j++, i++)
+      if (out[j] < 0.0 && (mask[i] & groupbit))
+        error->one(FLERR,"Sqrt of negative value in variable formula");
+    for (j = 0; j < n; j++) out[j] = sqrt(out[j]);
+    break;
+  case EXP:
+    for (j = 0; j < n; j++) out[j] = exp(out[j]);
+    break;
+  case LN:
+    for (j = 0, i = ifirst; j < n; j++, i++)
+      if (out[j] <= 0.0 && (mask[i] & groupbit))
+        error->one(FLERR,"Log of zero/negative value in variable formula");
+    for (j = 0; j < n; j++) out[j] = log(out[j]);
+    break;
+  case LOG:
+    for (j = 0, i = ifirst; j < n; j++, i++)
+      if (out[j] <= 0.0 && (mask[i] & groupbit))
+        error->one(FLERR,"Log of zero/negative value in variable formula");
+    for (j = 0; j < n; j++) out[j] = log10(out[j]);
+    break;
+  case ABS:
+    for (j = 0; j < n; j++) out[j] = fabs(out[j]);
+    break;
+
+  case SIN:
+    for (j = 0; j < n; j++) out[j] = sin(out[j]);
+    break;
+  case COS:
+    for (j = 0; j < n; j++) out[j] = cos(out[j]);
+    break;
+  case TAN:
+    for (j = 0; j < n; j++) out[j] = tan(out[j]);
+    break;
+  case ASIN:
+    for (j = 0, i = ifirst; j < n; j++, i++)
+      if ((out[j] < -1.0 || out[j] > 1.0) && (mask[i] & groupbit))
+        error->one(FLERR,"Arcsin of invalid value in variable formula");
+    for (j = 0; j < n; j++) out[j] = asin(out[j]);
+    break;
+  case ACOS:
+    for (j = 0, i = ifirst; j < n; j++, i++)
+      if ((out[j] < -1.0 || out[j] > 1.0) && (mask[i] & groupbit))
+        error->one(FLERR,"Arccos of invalid value in variable formula");
+    for (j = 0; j < n; j++) out[j] = acos(out[j]);
+    break;
+  case ATAN:
+    for (j = 0; j < n; j++) out[j] = atan(out[j]);
+    break;
+  case ATAN2:
+    for (j = 0; j < n; j++) out[j] = atan2(out[j],work[j]);
+    break;
+
+  case CEIL:
+    for (j = 0; j < n; j++) out[j] = ceil(out[j]);
+    break;
+  case FLOOR:
+    for (j = 0; j < n; j++) out[j] = floor(out[j]);
+    break;
+  case ROUND:
+    for (j = 0; j < n; j++) out[j] = MYROUND(out[j]);
+    break;
+
+  default:
+    for (j = 0; j < n; j++) out[j] = 0.0;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   return # of levels in parse tree
+---------------------------------------------------------------------- */
+
+int Variable::tree_depth(Tree *tree)
+{
+  int depth = 0;
+  if (tree->left) depth = MAX(depth,tree_depth(tree->left));
+  if (tree->middle) depth = MAX(depth,tree_depth(tree->middle));
+  if (tree->right) depth = MAX(depth,tree_depth(tree->right));
+  return depth+1;
+}
+
+/* ----------------------------------------------------------------------
+   return 1 if parse tree uses random() or normal(), else 0
+---------------------------------------------------------------------- */
+
+int Variable::tree_random(Tree *tree)
+{
+  if (tree->type == RANDOM || tree->type == NORMAL) return 1;
+  if (tree->left && tree_random(tree->left)) return 1;
+  if (tree->middle && tree_random(tree->middle)) return 1;
+  if (tree->right && tree_random(tree->right)) return 1;
+  return 0;
+}
+
 /* ---------------------------------------------------------------------- */
 
 void Variable::free_tree(Tree *tree)
@@ -63,6 +63,9 @@ class Variable : protected Pointers {
   int precedence[17];      // precedence level of math operators
                            // set length to include up to OR in enum
 
+  double *vblock;          // work space for block evaluation of parse tree
+  int maxvblock;           // allocated length of vblock
+
   struct Tree {            // parse tree for atom-style variables
     double value;          // single scalar  
     double *array;         // per-atom or per-type list of doubles
@@ -81,6 +84,9 @@ class Variable : protected Pointers {
   double evaluate(char *, Tree **);
   double collapse_tree(Tree *);
   double eval_tree(Tree *, int);
+  void eval_tree_block(Tree *, int, int, int, double *, double *);
+  int tree_depth(Tree *);
+  int tree_random(Tree *);
   void free_tree(Tree *);
   int find_matching_paren(char *, int, char *&);
   int math_function(char *, char *, Tree **, Tree **, int &, double *, int &);
@@ -30,6 +30,7 @@
 #include "modify.h"
 #include "compute.h"
 #include "fix.h"
+#include "fix_kspace_mts.h"
 #include "timer.h"
 #include "memory.h"
 #include "error.h"
@@ -39,7 +40,10 @@ using namespace LAMMPS_NS;
 /* ---------------------------------------------------------------------- */
 
 Verlet::Verlet(LAMMPS *lmp, int narg, char **arg) :
-  Integrate(lmp, narg, arg) {}
+  Integrate(lmp, narg, arg)
+{
+  fix_mts = NULL;
+}
 
 /* ----------------------------------------------------------------------
    initialization before run
@@ -61,6 +65,11 @@ void Verlet::init()
   if (force->newton_pair) virial_style = 2;
   else virial_style = 1;
 
+  region_pair = timer->region_create("pair");
+  region_bond = timer->region_create("bond");
+  region_kspace = timer->region_create("kspace");
+  region_output = timer->region_create("output");
+
   // setup lists of computes for global and per-atom PE and pressure
 
   ev_setup();
@@ -79,6 +88,20 @@ void Verlet::init()
   // orthogonal vs triclinic simulation box
 
   triclinic = domain->triclinic;
+
+  // fix created by kspace_modify every evaluates KSpace every Nevery steps
+  // delete it if a new KSpace style was defined since
+
+  fix_mts = NULL;
+  ifix = modify->find_fix("KSPACE_MTS");
+  if (force->kspace && force->kspace->every > 1) {
+    if (force->kspace->tip4pflag)
+      error->all(FLERR,"KSpace every > 1 does not support TIP4P");
+    if (strcmp(update->integrate_style,"verlet") != 0)
+      error->all(FLERR,"KSpace every > 1 requires run_style verlet");
+    if (ifix < 0) error->all(FLERR,"KSpace every > 1 requires fix KSPACE_MTS");
+    fix_mts = (FixKSpaceMTS *) modify->fix[ifix];
+  } else if (ifix >= 0) modify->delete_fix("KSPACE_MTS");
 }
 
 /* ----------------------------------------------------------------------
@@ -130,8 +153,10 @@ void Verlet::setup()
 
   if (force->kspace) {
     force->kspace->setup();
-    if (kspace_compute_flag) force->kspace->compute(eflag,vflag);
-    else force->kspace->compute_dummy(eflag,vflag);
+    if (kspace_compute_flag) {
+      if (fix_mts) fix_mts->compute(eflag,vflag);
+      else force->kspace->compute(eflag,vflag);
+    } else force->kspace->compute_dummy(eflag,vflag);
   }
 
   if (force->newton) comm->reverse_comm();
@@ -190,8 +215,10 @@ void Verlet::setup_minimal(int flag)
 
   if (force->kspace) {
     force->kspace->setup();
-    if (kspace_compute_flag) force->kspace->compute(eflag,vflag);
-    else force->kspace->compute_dummy(eflag,vflag);
+    if (kspace_compute_flag) {
+      if (fix_mts) fix_mts->compute(eflag,vflag);
+      else force->kspace->compute(eflag,vflag);
+    } else force->kspace->compute_dummy(eflag,vflag);
   }
 
   if (force->newton) comm->reverse_comm();
@@ -268,20 +295,27 @@ void Verlet::run(int n)
     timer->stamp();
 
     if (pair_compute_flag) {
+      timer->region_start(region_pair);
       force->pair->compute(eflag,vflag);
+      timer->region_stop(region_pair);
       timer->stamp(TIME_PAIR);
     }
 
     if (atom->molecular) {
+      timer->region_start(region_bond);
       if (force->bond) force->bond->compute(eflag,vflag);
       if (force->angle) force->angle->compute(eflag,vflag);
       if (force->dihedral) force->dihedral->compute(eflag,vflag);
       if (force->improper) force->improper->compute(eflag,vflag);
+      timer->region_stop(region_bond);
       timer->stamp(TIME_BOND);
     }
 
     if (kspace_compute_flag) {
-      force->kspace->compute(eflag,vflag);
+      timer->region_start(region_kspace);
+      if (fix_mts) fix_mts->compute(eflag,vflag);
+      else force->kspace->compute(eflag,vflag);
+      timer->region_stop(region_kspace);
       timer->stamp(TIME_KSPACE);
     }
 
@@ -302,7 +336,9 @@ void Verlet::run(int n)
 
     if (ntimestep == output->next) {
       timer->stamp();
+      timer->region_start(region_output);
       output->write(ntimestep);
+      timer->region_stop(region_output);
       timer->stamp(TIME_OUTPUT);
     }
   }
@@ -37,6 +37,8 @@ class Verlet : public Integrate {
  protected:
   int triclinic;                    // 0 if domain is orthog, 1 if triclinic
   int torqueflag,extraflag;
+  int region_pair,region_bond,region_kspace,region_output;  // timer regions
+  class FixKSpaceMTS *fix_mts;      // evaluates KSpace every Nevery steps
 
   virtual void force_clear();
 };
@@ -53,4 +55,20 @@ W: No fixes defined, atoms won't move
 If you are not using a fix like nve, nvt, npt then atom velocities and
 coordinates will not be updated during timestepping.
 
+E: KSpace every > 1 does not support TIP4P
+
+The TIP4P KSpace styles put forces on ghost atoms, which cannot be
+stored and reused on later timesteps.
+
+E: KSpace every > 1 requires run_style verlet
+
+Evaluating KSpace less often than every step is only implemented for
+the plain Verlet integrator.  Run_style respa can assign KSpace to the
+outer level instead.
+
+E: KSpace every > 1 requires fix KSPACE_MTS
+
+The internal fix created by the kspace_modify every command has been
+deleted.  Use the kspace_modify every command again.
+
 */
@@ -35,6 +35,7 @@
 #include "output.h"
 #include "thermo.h"
 #include "mpiio.h"
+#include "compress.h"
 #include "memory.h"
 #include "error.h"
 
@@ -60,7 +61,7 @@ enum{VERSION,SMALLINT,TAGINT,BIGINT,
      SPECIAL_LJ,SPECIAL_COUL,
      MASS,PAIR,BOND,ANGLE,DIHEDRAL,IMPROPER,
      MULTIPROC,MPIIO,PROCSPERFILE,PERPROC,
-     IMAGEINT};
+     IMAGEINT,COMPRESS};
 
 enum{IGNORE,WARN,ERROR};                    // same as thermo.cpp
 
@@ -71,6 +72,14 @@ WriteRestart::WriteRestart(LAMMPS *lmp) : Pointers(lmp)
   MPI_Comm_rank(world,&me);
   MPI_Comm_size(world,&nprocs);
   multiproc = 0;
+  zip = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+WriteRestart::~WriteRestart()
+{
+  delete zip;
 }
 
 /* ----------------------------------------------------------------------
@@ -168,11 +177,25 @@ void WriteRestart::multiproc_options(int multiproc_caller, int mpiioflag_caller,
     icluster = me;
   }
 
+  delete zip;
+  zip = NULL;
+
   // optional args
 
   int iarg = 0;
   while (iarg < narg) {
-    if (strcmp(arg[iarg],"fileper") == 0) {
+    if (strcmp(arg[iarg],"compress") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal write_restart command");
+      int codec = Compress::find(arg[iarg+1]);
+      if (codec < 0) error->all(FLERR,"Illegal write_restart command");
+      if (codec != Compress::NONE && mpiioflag)
+        error->all(FLERR,"Restart file MPI-IO output cannot be compressed");
+      delete zip;
+      zip = NULL;
+      if (codec != Compress::NONE) zip = new Compress(lmp,codec);
+      iarg += 2;
+
+    } else if (strcmp(arg[iarg],"fileper") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal write_restart command");
       if (!multiproc)
 	error->all(FLERR,"Cannot use write_restart fileper "
@@ -387,6 +410,51 @@ void WriteRestart::write(char *file)
     mpiio->close();
   }
 
+  // output of one or more native files with compressed per-proc chunks
+  // each proc compresses its own chunk and prefixes it with its length
+  // filewriter = 1 = this proc writes to file
+  // ping each proc in my cluster, receive its data, write data to file
+  // else wait for ping from fileproc, send my data to fileproc
+
+  else if (zip) {
+    if ((bigint) max_size * sizeof(double) > MAXSMALLINT)
+      error->all(FLERR,"Too much per-proc info for compressed restart file");
+    int maxzbuf = zip->bound(max_size*sizeof(double)) + sizeof(int);
+    char *zbuf;
+    memory->create(zbuf,maxzbuf,"write_restart:zbuf");
+
+    memcpy(zbuf,&send_size,sizeof(int));
+    int nzme = sizeof(int) +
+      zip->compress((char *) buf,send_size*sizeof(double),
+                    &zbuf[sizeof(int)],maxzbuf-sizeof(int));
+
+    int tmp,recv_size,nchars;
+    MPI_Status status;
+    MPI_Request request;
+
+    if (filewriter) {
+      for (int iproc = 0; iproc < nclusterprocs; iproc++) {
+        if (iproc) {
+          MPI_Irecv(zbuf,maxzbuf,MPI_CHAR,me+iproc,0,world,&request);
+          MPI_Send(&tmp,0,MPI_INT,me+iproc,0,world);
+          MPI_Wait(&request,&status);
+          MPI_Get_count(&status,MPI_CHAR,&nchars);
+        } else nchars = nzme;
+
+        memcpy(&recv_size,zbuf,sizeof(int));
+        write_compressed_vec(PERPROC,recv_size,nchars-sizeof(int),
+                             &zbuf[sizeof(int)]);
+      }
+      fclose(fp);
+
+    } else {
+      MPI_Recv(&tmp,0,MPI_INT,fileproc,0,world,&status);
+      MPI_Rsend(zbuf,nzme,MPI_CHAR,fileproc,0,world);
+    }
+
+    memory->destroy(zbuf);
+  }
+
   // output of one or more native files
   // filewriter = 1 = this proc writes to file
   // ping each proc in my cluster, receive its data, write data to file
@@ -548,6 +616,7 @@ void WriteRestart::file_layout(int send_size)
   if (me == 0) {
     write_int(MULTIPROC,multiproc);
     write_int(MPIIO,mpiioflag);
+    if (zip) write_int(COMPRESS,zip->codec);
   }
 
   if (mpiioflag) {
@@ -670,3 +739,17 @@ void WriteRestart::write_double_vec(int flag, int n, double *vec)
   fwrite(&n,sizeof(int),1,fp);
   fwrite(vec,sizeof(double),n,fp);
 }
+
+/* ----------------------------------------------------------------------
+   write a flag, N = # of doubles, and Nbytes of compressed doubles
+   into restart file
+------------------------------------------------------------------------- */
+
+void WriteRestart::write_compressed_vec(int flag, int n, int nbytes,
+                                        char *bytes)
+{
+  fwrite(&flag,sizeof(int),1,fp);
+  fwrite(&n,sizeof(int),1,fp);
+  fwrite(&nbytes,sizeof(int),1,fp);
+  fwrite(bytes,sizeof(char),nbytes,fp);
+}
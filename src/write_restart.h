@@ -28,6 +28,7 @@ namespace LAMMPS_NS {
 class WriteRestart : protected Pointers {
  public:
   WriteRestart(class LAMMPS *);
+  ~WriteRestart();
   void command(int, char **);
   void multiproc_options(int, int, int, char **);
   void write(char *);
@@ -50,6 +51,8 @@ class WriteRestart : protected Pointers {
   class RestartMPIIO *mpiio;   // MPIIO for restart file output
   MPI_Offset headerOffset;
 
+  class Compress *zip;         // compression of per-proc chunks, if any
+
   void header();
   void type_arrays();
   void force_fields();
@@ -65,6 +68,7 @@ class WriteRestart : protected Pointers {
   void write_string(int, char *);
   void write_int_vec(int, int, int *);
   void write_double_vec(int, int, double *);
+  void write_compressed_vec(int, int, int, char *);
 };
 
 }
@@ -94,6 +98,16 @@ E: Writing to MPI-IO filename when MPIIO package is not installed
 
 Self-explanatory.
 
+E: Restart file MPI-IO output cannot be compressed
+
+The compress keyword of write_restart cannot be used with an MPI-IO
+restart file.
+
+E: Too much per-proc info for compressed restart file
+
+The data of one processor must fit in a 32-bit integer number of
+bytes to be compressed.
+
 E: Cannot use write_restart fileper without % in restart file name
 
 Self-explanatory.
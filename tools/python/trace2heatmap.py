@@ -0,0 +1,143 @@
+#!/usr/bin/env python
+
+# Script:  trace2heatmap.py
+# Purpose: plot per-processor values from a fix trace file as a heatmap
+#          over the processor sub-domains
+# Syntax:  trace2heatmap.py tracefile field [options]
+#          tracefile = binary file written by fix trace
+#          field = nlocal or nghost or nneigh or ninsert or
+#                  pair or comm or wait or imbalance
+#          options:
+#            -step N = plot the record of timestep N (default = all records
+#                      combined, times and inserts summed, counts averaged)
+#            -each = write one image per record, named prefix.step.png
+#            -z f = for 3d, slice of procs whose sub-domain contains
+#                   box fraction f in z (default = 0.5)
+#            -o file = image file (default = field.png), prefix for -each
+#            -info = print header and per-record max/mean of field, no plot
+# Notes:   unlike the other scripts here, this does not use Pizza.py,
+#          only numpy and matplotlib
+#          imbalance = pair + comm - wait per proc, i.e. time spent
+#          computing rather than waiting on neighbors
+
+import sys
+import numpy as np
+
+FIELDS = ("nlocal","nghost","nneigh","ninsert","pair","comm","wait")
+COUNTS = ("nlocal","nghost","nneigh")
+
+def read_trace(filename):
+  f = open(filename,"rb")
+  if f.read(8) != b"LMPTRACE":
+    raise Exception("%s is not a fix trace file" % filename)
+  version,nprocs,dim,nevery,tiled,px,py,pz = np.fromfile(f,np.int32,8)
+  if version != 1:
+    raise Exception("unsupported fix trace version %d" % version)
+  header = dict(nprocs=int(nprocs),dimension=int(dim),nevery=int(nevery),
+                tiled=int(tiled),procgrid=(int(px),int(py),int(pz)))
+  header["myloc"] = np.fromfile(f,np.int32,3*nprocs).reshape(nprocs,3)
+
+  p = nprocs
+  rec = np.dtype([("step",np.int64),
+                  ("nlocal",np.int32,(p,)),("nghost",np.int32,(p,)),
+                  ("nneigh",np.int64,(p,)),("ninsert",np.int32,(p,)),
+                  ("pair",np.float32,(p,)),("comm",np.float32,(p,)),
+                  ("wait",np.float32,(p,)),
+                  ("lo",np.float32,(p,3)),("hi",np.float32,(p,3))])
+  records = np.fromfile(f,rec)
+  f.close()
+  return header,records
+
+def values(records,field):
+  if field == "imbalance":
+    return records["pair"] + records["comm"] - records["wait"]
+  return records[field].astype(np.float64)
+
+def combine(records,field):
+  v = values(records,field)
+  if field in COUNTS: return v.mean(axis=0)
+  return v.sum(axis=0)
+
+def plot(header,lo,hi,v,field,title,zfrac,outfile):
+  import matplotlib
+  matplotlib.use("Agg")
+  import matplotlib.pyplot as plt
+  from matplotlib.patches import Rectangle
+  from matplotlib.collections import PatchCollection
+
+  # in 3d only procs whose sub-domain straddles the z slice are drawn
+
+  if header["dimension"] == 3:
+    mask = (lo[:,2] <= zfrac) & (zfrac < hi[:,2])
+  else: mask = np.ones(len(v),bool)
+
+  patches = [Rectangle((lo[i,0],lo[i,1]),hi[i,0]-lo[i,0],hi[i,1]-lo[i,1])
+             for i in np.nonzero(mask)[0]]
+  pc = PatchCollection(patches,cmap="viridis",edgecolor="k",linewidth=0.5)
+  pc.set_array(v[mask])
+
+  fig,ax = plt.subplots()
+  ax.add_collection(pc)
+  ax.set_xlim(0,1)
+  ax.set_ylim(0,1)
+  ax.set_aspect("equal")
+  ax.set_xlabel("x / box")
+  ax.set_ylabel("y / box")
+  ax.set_title(title)
+  fig.colorbar(pc,ax=ax,label=field)
+  fig.savefig(outfile,dpi=150)
+  plt.close(fig)
+
+if __name__ == "__main__":
+  if len(sys.argv) < 3 or sys.argv[2] not in FIELDS + ("imbalance",):
+    sys.exit("Syntax: trace2heatmap.py tracefile field "
+             "[-step N] [-each] [-z f] [-o file] [-info]")
+
+  tracefile,field = sys.argv[1],sys.argv[2]
+  step = None
+  each = info = False
+  zfrac = 0.5
+  outfile = None
+  args = sys.argv[3:]
+  while args:
+    if args[0] == "-step": step = int(args[1]); args = args[2:]
+    elif args[0] == "-each": each = True; args = args[1:]
+    elif args[0] == "-z": zfrac = float(args[1]); args = args[2:]
+    elif args[0] == "-o": outfile = args[1]; args = args[2:]
+    elif args[0] == "-info": info = True; args = args[1:]
+    else: sys.exit("Unknown option %s" % args[0])
+
+  header,records = read_trace(tracefile)
+  if len(records) == 0: sys.exit("No records in %s" % tracefile)
+
+  if info:
+    print("procs %d, dimension %d, every %d steps, %s, grid %s" %
+          (header["nprocs"],header["dimension"],header["nevery"],
+           "tiled" if header["tiled"] else "brick",header["procgrid"]))
+    v = values(records,field)
+    for i,r in enumerate(records):
+      mean = v[i].mean()
+      ratio = v[i].max()/mean if mean > 0 else 0.0
+      print("step %d: %s max %g mean %g max/mean %.3f" %
+            (r["step"],field,v[i].max(),mean,ratio))
+    sys.exit()
+
+  if outfile is None: outfile = field + ".png"
+  if each:
+    prefix = outfile[:-4] if outfile.endswith(".png") else outfile
+    v = values(records,field)
+    for i,r in enumerate(records):
+      plot(header,r["lo"],r["hi"],v[i],field,"%s, step %d" % (field,r["step"]),
+           zfrac,"%s.%d.png" % (prefix,r["step"]))
+  elif step is not None:
+    match = np.nonzero(records["step"] == step)[0]
+    if len(match) == 0: sys.exit("No record for step %d" % step)
+    i = match[0]
+    plot(header,records["lo"][i],records["hi"][i],values(records,field)[i],
+         field,"%s, step %d" % (field,step),zfrac,outfile)
+  else:
+    last = records[-1]
+    how = "mean" if field in COUNTS else "sum"
+    plot(header,last["lo"],last["hi"],combine(records,field),field,
+         "%s, %s of steps %d-%d" % (field,how,records["step"][0],last["step"]),
+         zfrac,outfile)